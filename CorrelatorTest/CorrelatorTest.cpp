@@ -132,7 +132,7 @@ int64_t main(int argc, char **argv)
             continue;
         }
 
-        std::unordered_set<View *, View::Hash, View::Equal>::const_iterator v;
+        Code::ViewSet::const_iterator v;
 
         for (v = object->views.begin(); v != object->views.end(); ++v) {
             if (!(*v)->references[0]) {
@@ -37,8 +37,9 @@
 #include <r_code/vector.h>          // for vector
 #include <r_comp/decompiler.h>      // for Decompiler
 #include <r_comp/segments.h>        // for Image, ObjectNames, Metadata
+#include <r_exec/cpu_affinity.h>    // for CPUAffinity
 #include <r_exec/factory.h>         // for Fact
-#include <r_exec/init.h>            // for Now, Compile, Init
+#include <r_exec/init.h>            // for Now, Compile, Init, VirtualTime
 #include <r_exec/mem.h>             // for _Mem, Mem, MemStatic, etc
 #include <r_exec/object.h>          // for LObject
 #include <r_exec/opcodes.h>         // for Opcodes, Opcodes::MkVal
@@ -55,6 +56,7 @@
 #include <type_traits>              // for enable_if<>::type
 #include <unordered_map>            // for unordered_map, etc
 #include <utility>                  // for pair
+#include <vector>                   // for vector
 #include <sstream>                  // for ostringstream
 
 #include <common_logger.h>          // for logging
@@ -272,8 +274,12 @@ int main(int argc, char **argv)
     auto now = []() -> uint64_t {
                          return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
                       };
+    if (settings.virtual_time) {
+        r_exec::VirtualTime::Set(now());
+    }
+
     if (!r_exec::Init(settings.usr_operator_path.c_str(),
-                      now,
+                      settings.virtual_time ? &r_exec::VirtualTime::Now : (uint64_t(*)())now,
                       settings.usr_class_path.c_str(),
                       &seed,
                       &metadata)) {
@@ -294,6 +300,14 @@ int main(int argc, char **argv)
 #endif
     Decompiler decompiler;
     decompiler.init(&metadata);
+    std::vector<uint64_t> reduction_core_cpus;
+    std::vector<uint64_t> time_core_cpus;
+
+    if (!r_exec::CPUAffinity::Parse(settings.reduction_core_cpus, reduction_core_cpus) || !r_exec::CPUAffinity::Parse(settings.time_core_cpus, time_core_cpus)) {
+        LOG_ERROR << "malformed list of CPUs: " << settings.reduction_core_cpus << " / " << settings.time_core_cpus;
+        return 4;
+    }
+
     r_exec::_Mem *mem;
 
     if (settings.get_objects) {
@@ -307,7 +321,18 @@ int main(int argc, char **argv)
     mem->metadata = &metadata;
     mem->init(settings.base_period,
               settings.reduction_core_count,
+              settings.min_reduction_core_count,
+              settings.max_reduction_core_count,
               settings.time_core_count,
+              reduction_core_cpus,
+              time_core_cpus,
+              settings.numa,
+              settings.reclamation_period,
+              settings.reduction_job_affinity,
+              settings.reduction_job_scheduling == "priority",
+              settings.reduction_job_aging_window,
+              settings.reduction_job_capacity,
+              settings.reduction_job_overflow == "drop" ? r_exec::ReductionPipe::DROP : (settings.reduction_job_overflow == "merge" ? r_exec::ReductionPipe::MERGE : r_exec::ReductionPipe::BLOCK),
               settings.mdl_inertia_sr_thr,
               settings.mdl_inertia_cnt_thr,
               settings.tpx_dsr_thr,
@@ -316,10 +341,16 @@ int main(int argc, char **argv)
               settings.sim_time_horizon,
               settings.tpx_time_horizon,
               settings.perf_sampling_period,
+              settings.perf_stats_file,
               settings.float_tolerance,
               settings.time_tolerance,
               settings.primary_thz,
               settings.secondary_thz,
+              settings.hash_consing,
+              settings.memory_soft_budget,
+              settings.memory_hard_budget,
+              settings.group_memory_soft_budget,
+              settings.group_memory_hard_budget,
               settings.debug,
               settings.ntf_mk_resilience,
               settings.goal_pred_success_resilience,
@@ -347,11 +378,15 @@ int main(int argc, char **argv)
         return 4;
     }
 
+    if (settings.virtual_time) { // the run stops at the same time as in real time, so the results are the same.
+        r_exec::VirtualTime::SetLimit(r_exec::Now() + settings.run_time * 1000);
+    }
+
     uint64_t starting_time = mem->start();
     LOG_INFO << "running for " << settings.run_time << "ms";
-    while (now() < (settings.run_time*1000 + starting_time))
+    while (r_exec::Now() < (settings.run_time*1000 + starting_time))
     {
-        std::this_thread::sleep_for(std::chrono::milliseconds(settings.save_interval));
+        std::this_thread::sleep_for(std::chrono::milliseconds(settings.virtual_time ? 1 : settings.save_interval));
         // get_models(mem, settings, &decompiler, starting_time, now);
     }
     /*
@@ -45,8 +45,20 @@ public:
 
     // Init.
     uint64_t base_period;
+    bool virtual_time;
     uint64_t reduction_core_count;
+    uint64_t min_reduction_core_count;
+    uint64_t max_reduction_core_count;
     uint64_t time_core_count;
+    std::string reduction_core_cpus;
+    std::string time_core_cpus;
+    bool numa;
+    uint64_t reclamation_period;
+    bool reduction_job_affinity;
+    std::string reduction_job_scheduling;
+    uint64_t reduction_job_aging_window;
+    uint64_t reduction_job_capacity;
+    std::string reduction_job_overflow;
 
     // System.
     double mdl_inertia_sr_thr;
@@ -57,10 +69,16 @@ public:
     double sim_time_horizon;
     uint64_t tpx_time_horizon;
     uint64_t perf_sampling_period;
+    std::string perf_stats_file;
     double float_tolerance;
     uint64_t time_tolerance;
     uint64_t primary_thz;
     uint64_t secondary_thz;
+    bool hash_consing;
+    uint64_t memory_soft_budget;
+    uint64_t memory_hard_budget;
+    uint64_t group_memory_soft_budget;
+    uint64_t group_memory_hard_budget;
 
     // Debug.
     bool debug;
@@ -104,8 +122,20 @@ public:
         unsigned int cores = std::thread::hardware_concurrency();
         LOG_DEBUG << "number of CPU cores available:" << cores;
         base_period = settingsFile.getInt("Init", "base_period", 50000);
+        virtual_time = settingsFile.getString("Init", "time_base", "real") == "virtual";
         reduction_core_count = settingsFile.getInt("Init", "reduction_core_count", (cores * 3) / 4 + 1);
+        min_reduction_core_count = settingsFile.getInt("Init", "min_reduction_core_count", 0);
+        max_reduction_core_count = settingsFile.getInt("Init", "max_reduction_core_count", 0);
         time_core_count = settingsFile.getInt("Init", "time_core_count", (cores - ((cores * 3) / 4)) + 1);
+        reduction_core_cpus = settingsFile.getString("Init", "reduction_core_cpus", "");
+        time_core_cpus = settingsFile.getString("Init", "time_core_cpus", "");
+        numa = settingsFile.getBool("Init", "numa", false);
+        reclamation_period = settingsFile.getInt("Init", "reclamation_period", 0);
+        reduction_job_affinity = settingsFile.getBool("Init", "reduction_job_affinity", false);
+        reduction_job_scheduling = settingsFile.getString("Init", "reduction_job_scheduling", "fifo");
+        reduction_job_aging_window = settingsFile.getInt("Init", "reduction_job_aging_window", 100000);
+        reduction_job_capacity = settingsFile.getInt("Init", "reduction_job_capacity", 1024);
+        reduction_job_overflow = settingsFile.getString("Init", "reduction_job_overflow", "block");
         mdl_inertia_sr_thr = settingsFile.getDouble("System", "mdl_inertia_sr_thr", 0.9);
         mdl_inertia_cnt_thr = settingsFile.getInt("System", "mdl_inertia_cnt_thr", 6);
         tpx_dsr_thr = settingsFile.getDouble("System", "tpx_dsr_thr", 0.1);
@@ -114,10 +144,16 @@ public:
         sim_time_horizon = settingsFile.getDouble("System", "sim_time_horizon", 0.3);
         tpx_time_horizon = settingsFile.getInt("System", "tpx_time_horizon", 500000);
         perf_sampling_period = settingsFile.getInt("System", "perf_sampling_period", 250000);
+        perf_stats_file = settingsFile.getString("System", "perf_stats_file", "");
         float_tolerance = settingsFile.getDouble("System", "float_tolerance", 0.00001);
         time_tolerance = settingsFile.getInt("System", "time_tolerance", 10000);
         primary_thz = settingsFile.getInt("System", "primary_thz", 3600000);
         secondary_thz = settingsFile.getInt("System", "secondary_thz", 7200000);
+        hash_consing = settingsFile.getBool("System", "hash_consing", false);
+        memory_soft_budget = settingsFile.getInt("System", "memory_soft_budget", 0);
+        memory_hard_budget = settingsFile.getInt("System", "memory_hard_budget", 0);
+        group_memory_soft_budget = settingsFile.getInt("System", "group_memory_soft_budget", 0);
+        group_memory_hard_budget = settingsFile.getInt("System", "group_memory_hard_budget", 0);
         this->debug = settingsFile.getBool("Debug", "debug", true);
         debug_windows = settingsFile.getInt("Debug", "debug_windows", 1);
         trace_levels = std::stoi(settingsFile.getString("Debug", "trace_levels", "CC"), nullptr, 16);
@@ -31,8 +31,10 @@
 #ifndef r_code_list_h
 #define r_code_list_h
 
+#include <memory>
 #include <vector>
 #include <inttypes.h>
+#include <utility>
 
 namespace r_code
 {
@@ -40,7 +42,7 @@ namespace r_code
 // Minimalist list implemented as a vector.
 // Possible optimization: get rid of the std::vector and manage allocation oneself.
 // Insertion not needed for now; not implemented.
-template<typename T> class list
+template<typename T, typename Allocator = std::allocator<T> > class list
 {
 protected:
     static const int64_t null = -1;
@@ -54,7 +56,7 @@ protected:
         cell(): next(null), prev(null) {}
     };
 
-    std::vector<cell> cells;
+    std::vector<cell, typename std::allocator_traits<Allocator>::template rebind_alloc<cell> > cells;
 
     int64_t used_cells_head;
     int64_t used_cells_tail;
@@ -62,24 +64,24 @@ protected:
     uint64_t used_cell_count;
     uint64_t free_cell_count;
 
-    void push_back_free_cell(const T &t)
+    template<class U> void push_back_free_cell(U &&t)
     {
         int64_t free = free_cells;
         free_cells = cells[free_cells].next;
         --free_cell_count;
-        cells[free].data = t;
+        cells[free].data = std::forward<U>(t);
         cells[free].next = null;
         cells[free].prev = used_cells_tail;
         used_cells_tail = free;
     }
 
-    void push_back_new_cell(const T &t)
+    template<class U> void push_back_new_cell(U &&t)
     {
         cell c;
-        c.data = t;
+        c.data = std::forward<U>(t);
         c.next = null;
         c.prev = used_cells_tail;
-        cells.push_back(c);
+        cells.push_back(std::move(c));
         used_cells_tail = cells.size() - 1;
     }
 
@@ -96,24 +98,24 @@ protected:
         ++used_cell_count;
     }
 
-    void push_front_free_cell(const T &t)
+    template<class U> void push_front_free_cell(U &&t)
     {
         int64_t free = free_cells;
         free_cells = cells[free_cells].next;
         --free_cell_count;
-        cells[free].data = t;
+        cells[free].data = std::forward<U>(t);
         cells[free].next = used_cells_head;
         cells[free].prev = null;
         used_cells_head = free;
     }
 
-    void push_front_new_cell(const T &t)
+    template<class U> void push_front_new_cell(U &&t)
     {
         cell c;
-        c.data = t;
+        c.data = std::forward<U>(t);
         c.next = used_cells_head;
         c.prev = null;
-        cells.push_back(c);
+        cells.push_back(std::move(c));
         used_cells_head = cells.size() - 1;
     }
 
@@ -182,6 +184,16 @@ public:
 
         update_used_cells_tail_state();
     }
+    void push_back(T &&t) // moves t in: no copy of smart pointers.
+    {
+        if (free_cell_count) {
+            push_back_free_cell(std::move(t));
+        } else {
+            push_back_new_cell(std::move(t));
+        }
+
+        update_used_cells_tail_state();
+    }
     void push_back(const T &t, int64_t &location)
     {
         if (free_cell_count) {
@@ -204,6 +216,16 @@ public:
 
         update_used_cells_head_state();
     }
+    void push_front(T &&t)
+    {
+        if (free_cell_count) {
+            push_front_free_cell(std::move(t));
+        } else {
+            push_front_new_cell(std::move(t));
+        }
+
+        update_used_cells_head_state();
+    }
     void push_front(const T &t, int64_t &location)
     {
         if (free_cell_count) {
@@ -352,7 +374,7 @@ public:
     }
 };
 
-template<typename T> typename list<T>::const_iterator list<T>::end_iterator;
+template<typename T, typename Allocator> typename list<T, Allocator>::const_iterator list<T, Allocator>::end_iterator;
 }
 
 
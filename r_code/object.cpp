@@ -45,6 +45,8 @@ SysView::SysView()
 
 SysView::SysView(View *source)
 {
+    source->store_ctrl_values();
+
     for (size_t i = 0; i < VIEW_CODE_MAX_SIZE; ++i) {
         code[i] = source->code(i);
     }
@@ -125,7 +127,7 @@ SysObject::SysObject(Code *source)
         code[i] = source->code(i);
     }
 
-    std::unordered_set<View *, View::Hash, View::Equal>::const_iterator v;
+    Code::ViewSet::const_iterator v;
     source->acq_views();
 
     for (i = 0, v = source->views.begin(); v != source->views.end(); ++i, ++v) {
@@ -33,7 +33,10 @@
 
 #include <r_code/atom.h>            // for Atom
 #include <r_code/list.h>            // for list
+#include <r_code/reclaimer.h>       // for EPOCH_RECLAIMED
 #include <r_code/replicode_defs.h>  // for VIEW_IJT, VIEW_CODE_MAX_SIZE, etc
+#include <r_code/slab.h>            // for SlabAllocator, SLAB_ALLOCATED
+#include <r_code/small_vector.h>    // for small_vector
 #include <r_code/utils.h>           // for Utils
 #include <r_code/vector.h>          // for vector
 #include <stddef.h>                 // for NULL, size_t
@@ -107,6 +110,9 @@ private:
 class REPLICODE_EXPORT View : public _Object
 {
 public:
+    SLAB_ALLOCATED
+    EPOCH_RECLAIMED
+
     /// does not include the viewed object; no smart pointer here (a view is held by a group and holds a ref to said group in references[0]).
     Code *references[2];
     /// viewed object.
@@ -129,6 +135,11 @@ public:
 
     virtual ~View() {}
 
+    /// Writes in the code the ctrl values kept elsewhere by r_exec, if any (see r_exec::ViewCtrlValues).
+    virtual void store_ctrl_values() {}
+    /// Called when the viewed object is invalidated.
+    virtual void object_invalidated() {}
+
     Atom &code(uint16_t i)
     {
         return _code[i];
@@ -190,6 +201,8 @@ class REPLICODE_EXPORT Code:
     public _Object
 {
 public:
+    EPOCH_RECLAIMED
+
     static const int64_t null_storage_index = -1;
     static const uint64_t CodeMarkersInitialSize = 8;
 protected:
@@ -247,8 +260,11 @@ public:
         return false;
     }
 
-    r_code::list<Code *> markers;
-    std::unordered_set<View *, View::Hash, View::Equal> views; // indexed by groups.
+    typedef r_code::list<Code *, SlabAllocator<Code *> > MarkerList;
+    typedef std::unordered_set<View *, View::Hash, View::Equal, SlabAllocator<View *> > ViewSet;
+
+    MarkerList markers;
+    ViewSet views; // indexed by groups.
 
     virtual View *build_view(SysView *source) = 0;
 
@@ -293,14 +309,20 @@ public:
 };
 
 // Implementation for local objects (non distributed).
+// Objects, and their code and references, come from the slabs: one is created for every input.
+// Most facts and markers fit in the inline parts of their code and references.
 class REPLICODE_EXPORT LObject:
     public Code
 {
 protected:
+    static const size_t InlineCodeSize = 16;
+    static const size_t InlineReferenceCount = 3;
+
     uint64_t _oid;
-    r_code::vector<Atom> _code;
-    r_code::vector<P<Code> > _references;
+    r_code::small_vector<Atom, InlineCodeSize, SlabAllocator<Atom> > _code;
+    r_code::small_vector<P<Code>, InlineReferenceCount, SlabAllocator<P<Code> > > _references;
 public:
+    SLAB_ALLOCATED
     LObject(): Code() {}
     LObject(SysObject *source): Code()
     {
@@ -336,7 +358,7 @@ public:
     }
     void resize_code(uint16_t new_size)
     {
-        _code.as_std()->resize(new_size);
+        _code.resize(new_size);
     }
     void set_reference(uint16_t i, Code *object)
     {
@@ -352,11 +374,11 @@ public:
     }
     void clear_references()
     {
-        _references.as_std()->clear();
+        _references.clear();
     }
     void set_references(std::vector<P<Code> > &new_references)
     {
-        (*_references.as_std()) = new_references;
+        _references.assign(new_references.begin(), new_references.end());
     }
     void add_reference(Code *object)
     {
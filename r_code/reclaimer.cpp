@@ -0,0 +1,263 @@
+//	reclaimer.cpp
+//
+//	Deferred, epoch-based deletion of the objects released by the cores.
+
+#include "reclaimer.h"
+
+#include <atomic>              // for atomic
+#include <chrono>              // for microseconds
+#include <condition_variable>  // for condition_variable
+#include <mutex>               // for mutex, lock_guard, unique_lock
+#include <thread>              // for thread
+#include <utility>             // for pair
+#include <vector>              // for vector
+
+
+namespace r_code
+{
+
+static const uint64_t Quiescent = UINT64_MAX;
+
+class ThreadRecord
+{
+public:
+    std::atomic<uint64_t> epoch; // epoch at which the thread entered its current job; Quiescent if none.
+    std::mutex mutex; // protects retired and exited.
+    std::vector<core::_Object *> retired;
+    bool exited;
+
+    ThreadRecord(): epoch(Quiescent), exited(false) {}
+};
+
+static std::atomic<bool> Running(false);
+static std::atomic<uint64_t> Epoch(0);
+static std::atomic<uint64_t> ReclaimedCount(0);
+
+static std::mutex RecordsMutex;
+static std::vector<ThreadRecord *> Records;
+
+static std::mutex ThreadMutex; // protects the reclaimer thread and Stopping.
+static std::condition_variable Wakeup;
+static bool Stopping = false;
+static std::thread ReclaimerThread;
+
+static thread_local ThreadRecord *LocalRecord = nullptr;
+static thread_local bool Exiting = false;
+
+class RecordOwner // gives the record up when its thread exits; the reclaimer thread deletes it.
+{
+public:
+    ~RecordOwner()
+    {
+        Exiting = true;
+
+        if (!LocalRecord) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> guard(LocalRecord->mutex);
+        LocalRecord->epoch = Quiescent;
+        LocalRecord->exited = true;
+        LocalRecord = nullptr;
+    }
+};
+
+static ThreadRecord *GetRecord()
+{
+    if (LocalRecord || Exiting) {
+        return LocalRecord;
+    }
+
+    static thread_local RecordOwner owner;
+    (void)owner;
+    LocalRecord = new ThreadRecord();
+    std::lock_guard<std::mutex> guard(RecordsMutex);
+    Records.push_back(LocalRecord);
+    return LocalRecord;
+}
+
+void Reclaimer::Retire(core::_Object *object)
+{
+    ThreadRecord *record = Running ? GetRecord() : nullptr;
+
+    if (!record) {
+        delete object;
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(record->mutex);
+
+        if (Running) { // Stop() collects each record after clearing Running, under its lock: it will see the object.
+            record->retired.push_back(object);
+            return;
+        }
+    }
+
+    delete object; // stopped since the check above, possibly done collecting; outside the lock, as the deletion may retire more.
+}
+
+void Reclaimer::Enter()
+{
+    ThreadRecord *record = GetRecord();
+
+    if (!record) {
+        return;
+    }
+
+    for (;;) { // the reclaimer must not move past the epoch before it sees it.
+        uint64_t epoch = Epoch;
+        record->epoch = epoch;
+
+        if (Epoch == epoch) {
+            break;
+        }
+    }
+}
+
+void Reclaimer::Leave()
+{
+    if (LocalRecord) {
+        LocalRecord->epoch = Quiescent;
+    }
+}
+
+// Moves the objects retired by all threads to pending, tagged with the current epoch; drops the records of the exited
+// threads.
+static void Collect(std::vector<std::pair<uint64_t, core::_Object *> > &pending)
+{
+    uint64_t epoch = Epoch;
+    std::vector<core::_Object *> retired;
+    std::lock_guard<std::mutex> guard(RecordsMutex);
+
+    for (size_t i = 0; i < Records.size();) {
+        ThreadRecord *record = Records[i];
+        bool exited;
+        {
+            std::lock_guard<std::mutex> record_guard(record->mutex);
+            retired.swap(record->retired);
+            exited = record->exited;
+        }
+
+        for (core::_Object *object : retired) {
+            pending.push_back(std::make_pair(epoch, object));
+        }
+
+        retired.clear();
+
+        if (exited) {
+            delete record;
+            Records[i] = Records.back();
+            Records.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+// The oldest epoch a thread is still in; the current epoch if none.
+static uint64_t GetOldestEpoch()
+{
+    uint64_t oldest = Epoch;
+    std::lock_guard<std::mutex> guard(RecordsMutex);
+
+    for (ThreadRecord *record : Records) {
+        uint64_t epoch = record->epoch;
+
+        if (epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+
+    return oldest;
+}
+
+static void Run(uint64_t period)
+{
+    std::vector<std::pair<uint64_t, core::_Object *> > pending; // in order of epochs.
+    std::vector<std::pair<uint64_t, core::_Object *> > remaining;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(ThreadMutex);
+            Wakeup.wait_for(lock, std::chrono::microseconds(period), []() {
+                return Stopping;
+            });
+
+            if (Stopping) {
+                break;
+            }
+        }
+
+        Collect(pending);
+        ++Epoch;
+        uint64_t oldest = GetOldestEpoch();
+        size_t i = 0;
+
+        for (; i < pending.size() && pending[i].first < oldest; ++i) {
+            delete pending[i].second;
+        }
+
+        ReclaimedCount += i;
+        remaining.assign(pending.begin() + i, pending.end());
+        pending.swap(remaining);
+    }
+
+    for (size_t i = 0; i < pending.size(); ++i) { // the cores are stopped.
+        delete pending[i].second;
+    }
+
+    ReclaimedCount += pending.size();
+}
+
+void Reclaimer::Start(uint64_t period)
+{
+    std::lock_guard<std::mutex> guard(ThreadMutex);
+
+    if (Running) {
+        return;
+    }
+
+    Stopping = false;
+    Running = true;
+    ReclaimerThread = std::thread(Run, period);
+}
+
+void Reclaimer::Stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(ThreadMutex);
+
+        if (!Running) {
+            return;
+        }
+
+        Stopping = true;
+        Running = false; // from now on, objects are deleted upon release.
+    }
+
+    Wakeup.notify_all();
+    ReclaimerThread.join();
+    std::vector<std::pair<uint64_t, core::_Object *> > pending;
+
+    for (;;) { // what was retired meanwhile.
+        Collect(pending);
+
+        if (pending.empty()) {
+            break;
+        }
+
+        for (size_t i = 0; i < pending.size(); ++i) {
+            delete pending[i].second;
+        }
+
+        ReclaimedCount += pending.size();
+        pending.clear();
+    }
+}
+
+uint64_t Reclaimer::GetReclaimedCount()
+{
+    return ReclaimedCount;
+}
+}
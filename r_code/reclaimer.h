@@ -0,0 +1,43 @@
+//	reclaimer.h
+//
+//	Deferred, epoch-based deletion of the objects released by the cores.
+
+#ifndef r_code_reclaimer_h
+#define r_code_reclaimer_h
+
+#include <stdint.h>            // for uint64_t
+
+#include <replicode_common.h>  // for _Object, REPLICODE_EXPORT
+
+namespace r_code
+{
+
+// While the reclaimer runs, the final release of an object only queues it (see Retire()); a background thread deletes
+// the queued objects in batches, so that the cores do not stall on long destructor chains (object, views,
+// controllers, overlays).
+// Epochs: a core brackets each job with Enter()/Leave(). The reclaimer thread tags what it collects with the current
+// epoch and moves to the next one; it deletes an object once no core is still in a job it entered at or before the
+// epoch of the object: raw pointers taken during a job stay valid until the job is done.
+// Objects released by a deletion (e.g. the views of a deleted object) are queued again, for the next round.
+// An object must not be revived (its ref count raised from 0) once released.
+class REPLICODE_EXPORT Reclaimer
+{
+public:
+    static void Retire(core::_Object *object); // deletes the object right away when the reclaimer does not run.
+
+    static void Enter();
+    static void Leave();
+
+    static void Start(uint64_t period); // in us: launches the reclaimer thread.
+    static void Stop(); // joins the reclaimer thread and deletes what is left; objects are deleted upon release again.
+
+    static uint64_t GetReclaimedCount(); // objects deleted by the reclaimer thread so far.
+};
+}
+
+// In the declaration of a class whose instances are deleted by the reclaimer.
+#define EPOCH_RECLAIMED \
+    void decRef() { if (--refCount == 0) r_code::Reclaimer::Retire(this); }
+
+
+#endif
@@ -0,0 +1,199 @@
+//	slab.cpp
+//
+//	Per-thread pools of small blocks, for the objects and views created at every injection.
+
+#include "slab.h"
+
+#include <stdlib.h>            // for posix_memalign
+#include <atomic>              // for atomic
+#include <mutex>               // for mutex, lock_guard
+#include <new>                 // for bad_alloc, operator new
+
+#if defined(WIN32) || defined(WIN64)
+#include <malloc.h>            // for _aligned_malloc
+#endif
+
+
+namespace r_code
+{
+
+static const size_t ClassCount = Slab::MaxSize / Slab::Granularity;
+
+class Block
+{
+public:
+    Block *next;
+};
+
+class ThreadCache
+{
+public:
+    Block *blocks[ClassCount]; // free blocks; touched by the owner only.
+    std::atomic<Block *> remote_blocks[ClassCount]; // released by other threads.
+    ThreadCache *next_orphan;
+
+    ThreadCache(): next_orphan(nullptr)
+    {
+        for (size_t i = 0; i < ClassCount; ++i) {
+            blocks[i] = nullptr;
+            remote_blocks[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+};
+
+// At the beginning of each slab; the slabs are aligned on their size, so a block finds its header by masking.
+class SlabHeader
+{
+public:
+    ThreadCache *owner;
+};
+
+static const size_t HeaderSize = ((sizeof(SlabHeader) + Slab::Granularity - 1) / Slab::Granularity) * Slab::Granularity;
+
+static std::atomic<uint64_t> SystemAllocationCount(0);
+static std::mutex OrphanMutex;
+static ThreadCache *Orphans = nullptr;
+
+static thread_local ThreadCache *LocalCache = nullptr;
+static thread_local bool Exiting = false;
+
+class CacheOwner // gives the cache up when its thread exits.
+{
+public:
+    ~CacheOwner()
+    {
+        Exiting = true;
+
+        if (!LocalCache) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> guard(OrphanMutex);
+        LocalCache->next_orphan = Orphans;
+        Orphans = LocalCache;
+        LocalCache = nullptr;
+    }
+};
+
+static ThreadCache *GetCache()
+{
+    if (LocalCache) {
+        return LocalCache;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(OrphanMutex);
+
+        if (Orphans) {
+            LocalCache = Orphans;
+            Orphans = Orphans->next_orphan;
+        }
+    }
+
+    if (!LocalCache) {
+        LocalCache = new ThreadCache();
+    }
+
+    if (!Exiting) { // else the cache stays with the thread: only remote releases can reach it from now on.
+        static thread_local CacheOwner owner;
+        (void)owner;
+    }
+
+    return LocalCache;
+}
+
+static void *AllocateSlab()
+{
+    void *slab;
+#if defined(WIN32) || defined(WIN64)
+    slab = _aligned_malloc(Slab::SlabSize, Slab::SlabSize);
+#else
+
+    if (posix_memalign(&slab, Slab::SlabSize, Slab::SlabSize) != 0) {
+        slab = nullptr;
+    }
+
+#endif
+
+    if (!slab) {
+        throw std::bad_alloc();
+    }
+
+    ++SystemAllocationCount;
+    return slab;
+}
+
+static Block *Refill(ThreadCache *cache, size_t size_class)
+{
+    Block *blocks = cache->remote_blocks[size_class].exchange(nullptr, std::memory_order_acquire);
+
+    if (blocks) {
+        return blocks;
+    }
+
+    char *slab = (char *)AllocateSlab();
+    ((SlabHeader *)slab)->owner = cache;
+    size_t block_size = (size_class + 1) * Slab::Granularity;
+
+    for (size_t i = (Slab::SlabSize - HeaderSize) / block_size; i-- > 0;) { // the list ends up in address order.
+        Block *block = (Block *)(slab + HeaderSize + i * block_size);
+        block->next = blocks;
+        blocks = block;
+    }
+
+    return blocks;
+}
+
+void *Slab::Allocate(size_t size)
+{
+    if (size > MaxSize) {
+        ++SystemAllocationCount;
+        return ::operator new(size);
+    }
+
+    size_t size_class = size > 0 ? (size - 1) / Granularity : 0;
+    ThreadCache *cache = GetCache();
+    Block *block = cache->blocks[size_class];
+
+    if (!block) {
+        block = Refill(cache, size_class);
+    }
+
+    cache->blocks[size_class] = block->next;
+    return block;
+}
+
+void Slab::Release(void *block, size_t size)
+{
+    if (!block) {
+        return;
+    }
+
+    if (size > MaxSize) {
+        ::operator delete(block);
+        return;
+    }
+
+    size_t size_class = size > 0 ? (size - 1) / Granularity : 0;
+    ThreadCache *owner = ((SlabHeader *)((uintptr_t)block & ~(uintptr_t)(SlabSize - 1)))->owner;
+    Block *b = (Block *)block;
+
+    if (owner == LocalCache) {
+        b->next = owner->blocks[size_class];
+        owner->blocks[size_class] = b;
+        return;
+    }
+
+    std::atomic<Block *> &remote_blocks = owner->remote_blocks[size_class];
+    Block *head = remote_blocks.load(std::memory_order_relaxed);
+
+    do {
+        b->next = head;
+    } while (!remote_blocks.compare_exchange_weak(head, b, std::memory_order_release, std::memory_order_relaxed));
+}
+
+uint64_t Slab::GetSystemAllocationCount()
+{
+    return SystemAllocationCount.load(std::memory_order_relaxed);
+}
+}
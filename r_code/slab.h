@@ -0,0 +1,75 @@
+//	slab.h
+//
+//	Per-thread pools of small blocks, for the objects and views created at every injection.
+
+#ifndef r_code_slab_h
+#define r_code_slab_h
+
+#include <stddef.h>            // for size_t
+#include <stdint.h>            // for uint64_t
+
+#include <replicode_common.h>  // for REPLICODE_EXPORT
+
+namespace r_code
+{
+
+// Blocks up to MaxSize bytes are rounded up to a multiple of Granularity and carved out of 64KB slabs. Each thread
+// has a cache of free blocks per size class: allocation and release by the owner of a block are a list push/pop.
+// A block released by another thread (e.g. a view built by an I/O thread and released by a reduction core) goes to
+// a lock-free stack of its owner, which takes the whole stack back when its own list runs dry.
+// The caches of exited threads are adopted by new threads; slabs are never returned to the system.
+// Larger blocks go to ::operator new. Release needs the size of the block: use sized deallocation (a class with a
+// virtual destructor gets the size of the dynamic type).
+class REPLICODE_EXPORT Slab
+{
+public:
+    static const size_t Granularity = 16;
+    static const size_t MaxSize = 1024;
+    static const size_t SlabSize = 64 * 1024;
+
+    static void *Allocate(size_t size);
+    static void Release(void *block, size_t size);
+
+    static uint64_t GetSystemAllocationCount(); // slabs and large blocks allocated so far.
+};
+
+// For std containers.
+template<typename T> class SlabAllocator
+{
+public:
+    typedef T value_type;
+
+    SlabAllocator() {}
+    template<typename U> SlabAllocator(const SlabAllocator<U> &) {}
+
+    T *allocate(size_t n)
+    {
+        return (T *)Slab::Allocate(n * sizeof(T));
+    }
+    void deallocate(T *p, size_t n)
+    {
+        Slab::Release(p, n * sizeof(T));
+    }
+
+    template<typename U> struct rebind {
+        typedef SlabAllocator<U> other;
+    };
+
+    template<typename U> bool operator ==(const SlabAllocator<U> &) const
+    {
+        return true;
+    }
+    template<typename U> bool operator !=(const SlabAllocator<U> &) const
+    {
+        return false;
+    }
+};
+}
+
+// In the declaration of a class whose instances come from the slabs.
+#define SLAB_ALLOCATED \
+    static void *operator new(size_t size) { return r_code::Slab::Allocate(size); } \
+    static void operator delete(void *block, size_t size) { r_code::Slab::Release(block, size); }
+
+
+#endif
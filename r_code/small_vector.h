@@ -0,0 +1,214 @@
+//	small_vector.h
+//
+//	Vector with inline storage for its first elements.
+
+#ifndef r_code_small_vector_h
+#define r_code_small_vector_h
+
+#include <assert.h>            // for assert
+#include <stddef.h>            // for size_t
+#include <stdint.h>            // for uint32_t
+#include <memory>              // for allocator, allocator_traits
+#include <new>                 // for placement new
+#include <type_traits>         // for aligned_storage
+#include <utility>             // for move
+
+
+namespace r_code
+{
+
+// Holds up to N elements in place, and moves them to storage obtained from the allocator beyond that.
+// Like r_code::vector, writing through operator [] past the end grows the vector (the code of an object is written
+// atom by atom); otherwise indexed access is unchecked in release builds: reserve() or resize() when the final size is
+// known.
+template<typename T, size_t N, typename Allocator = std::allocator<T> > class small_vector
+{
+private:
+    typedef std::allocator_traits<Allocator> traits;
+
+    T *m_data;
+    uint32_t m_size;
+    uint32_t m_capacity;
+    typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type m_inline;
+    Allocator m_allocator;
+
+    T *inline_data()
+    {
+        return reinterpret_cast<T *>(&m_inline);
+    }
+    bool is_inline() const
+    {
+        return m_data == reinterpret_cast<const T *>(&m_inline);
+    }
+    void grow(size_t min_capacity)
+    {
+        size_t capacity = m_capacity * 2;
+
+        if (capacity < min_capacity) {
+            capacity = min_capacity;
+        }
+
+        T *data = traits::allocate(m_allocator, capacity);
+
+        for (uint32_t i = 0; i < m_size; ++i) {
+            new (data + i) T(std::move(m_data[i]));
+            m_data[i].~T();
+        }
+
+        release();
+        m_data = data;
+        m_capacity = capacity;
+    }
+    void release()
+    {
+        if (!is_inline()) {
+            traits::deallocate(m_allocator, m_data, m_capacity);
+        }
+    }
+public:
+    typedef T value_type;
+    typedef T *iterator;
+    typedef const T *const_iterator;
+
+    small_vector(): m_data(inline_data()), m_size(0), m_capacity(N) {}
+    small_vector(const small_vector &v): m_data(inline_data()), m_size(0), m_capacity(N)
+    {
+        assign(v.begin(), v.end());
+    }
+    ~small_vector()
+    {
+        clear();
+        release();
+    }
+
+    small_vector &operator =(const small_vector &v)
+    {
+        if (this != &v) {
+            assign(v.begin(), v.end());
+        }
+
+        return *this;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+    size_t capacity() const
+    {
+        return m_capacity;
+    }
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    void reserve(size_t capacity)
+    {
+        if (capacity > m_capacity) {
+            grow(capacity);
+        }
+    }
+    void resize(size_t size)
+    {
+        reserve(size);
+
+        for (size_t i = m_size; i < size; ++i) {
+            new (m_data + i) T();
+        }
+
+        for (size_t i = size; i < m_size; ++i) {
+            m_data[i].~T();
+        }
+
+        m_size = size;
+    }
+    void clear()
+    {
+        resize(0);
+    }
+
+    T &operator [](size_t i)
+    {
+        if (i >= m_size) {
+            resize(i + 1);
+        }
+
+        return m_data[i];
+    }
+    const T &operator [](size_t i) const
+    {
+        assert(i < m_size);
+        return m_data[i];
+    }
+
+    void push_back(const T &t)
+    {
+        if (m_size == m_capacity) {
+            T copy(t); // t may be an element.
+            grow(m_size + 1);
+            new (m_data + m_size) T(std::move(copy));
+        } else {
+            new (m_data + m_size) T(t);
+        }
+
+        ++m_size;
+    }
+    void push_back(T &&t)
+    {
+        if (m_size == m_capacity) {
+            T moved(std::move(t));
+            grow(m_size + 1);
+            new (m_data + m_size) T(std::move(moved));
+        } else {
+            new (m_data + m_size) T(std::move(t));
+        }
+
+        ++m_size;
+    }
+    template<typename I> void assign(I first, I last)
+    {
+        clear();
+
+        for (; first != last; ++first) {
+            push_back(*first);
+        }
+    }
+
+    T *data()
+    {
+        return m_data;
+    }
+    const T *data() const
+    {
+        return m_data;
+    }
+    iterator begin()
+    {
+        return m_data;
+    }
+    const_iterator begin() const
+    {
+        return m_data;
+    }
+    const_iterator cbegin() const
+    {
+        return m_data;
+    }
+    iterator end()
+    {
+        return m_data + m_size;
+    }
+    const_iterator end() const
+    {
+        return m_data + m_size;
+    }
+    const_iterator cend() const
+    {
+        return m_data + m_size;
+    }
+};
+}
+
+
+#endif
@@ -33,12 +33,13 @@
 
 #include <vector>
 #include <cstddef>
+#include <memory>
 
 namespace r_code
 {
 
 /// Auto-resizing vector
-template<typename T> class vector
+template<typename T, typename Allocator = std::allocator<T> > class vector
 {
 public:
     vector() {}
@@ -63,13 +64,13 @@ public:
     {
         m_vector.push_back(t);
     }
-    std::vector<T> *as_std()
+    std::vector<T, Allocator> *as_std()
     {
         return &m_vector;
     }
 
-    typedef typename std::vector<T>::iterator iterator;
-    typedef typename std::vector<T>::const_iterator const_iterator;
+    typedef typename std::vector<T, Allocator>::iterator iterator;
+    typedef typename std::vector<T, Allocator>::const_iterator const_iterator;
     iterator begin()
     {
         return m_vector.begin();
@@ -96,7 +97,7 @@ public:
     }
 
 private:
-    std::vector<T> m_vector;
+    std::vector<T, Allocator> m_vector;
 };
 
 }
@@ -568,7 +568,7 @@ void Image::add_object_full(Code *object)
     }
 
     object->acq_views();
-    std::unordered_set<View *, View::Hash, View::Equal>::const_iterator v;
+    Code::ViewSet::const_iterator v;
 
     for (v = object->views.begin(); v != object->views.end(); ++v) { // follow the view's reference pointers and recurse.
         for (uint8_t j = 0; j < 2; ++j) { // 2 refs maximum per view; may be NULL.
@@ -622,7 +622,7 @@ void Image::build_references(SysObject *sys_object, Code *object)
     }
 
     object->acq_views();
-    std::unordered_set<View *, View::Hash, View::Equal>::const_iterator v;
+    Code::ViewSet::const_iterator v;
 
     for (i = 0, v = object->views.begin(); v != object->views.end(); ++i, ++v) {
         for (uint8_t j = 0; j < 2; ++j) { // 2 refs maximum per view; may be NULL.
@@ -31,6 +31,7 @@
 #ifndef segments_h
 #define segments_h
 
+#include <r_code/list.h>                // for list
 #include <r_code/vector.h>              // for vector
 #include <r_comp/class.h>               // for Class
 #include <stddef.h>                     // for size_t
@@ -47,7 +48,6 @@ namespace r_code {
 class Code;
 class Mem;
 class SysObject;
-template <typename T> class list;
 }  // namespace r_code
 
 
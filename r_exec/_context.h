@@ -34,6 +34,7 @@
 
 #include <r_code/atom.h>      // for Atom
 #include <r_exec/overlay.h>   // for Overlay
+#include <stddef.h>           // for size_t
 #include <stdint.h>           // for uint16_t, uint64_t
 
 #include <replicode_common.h>  // for REPLICODE_EXPORT
@@ -67,8 +68,12 @@ protected:
 
     _Context(Atom *code, uint16_t index, Overlay *overlay, Data data): overlay(overlay), code(code), index(index), data(data) {}
 public:
+    static const size_t MaxSize = 64; // of the subclasses: Context holds them in place.
+
     virtual ~_Context() {}
-    virtual _Context *assign(const _Context *c) = 0;
+
+    // The following construct the resulting context in storage (MaxSize bytes, see Context), not on the heap.
+    virtual _Context *clone(void *storage) const = 0;
 
     virtual bool equal(const _Context *c) const = 0;
 
@@ -77,9 +82,9 @@ public:
     virtual uint16_t get_object_code_size() const = 0;
 
     virtual uint16_t getChildrenCount() const = 0;
-    virtual _Context *_getChild(uint16_t index) const = 0;
+    virtual _Context *_getChild(uint16_t index, void *storage) const = 0;
 
-    virtual _Context *dereference() const = 0;
+    virtual _Context *dereference(void *storage) const = 0;
 
     void commit() const
     {
@@ -0,0 +1,277 @@
+//	alpha_network.cpp
+//
+//	Tests on the constant parts of patterns, shared across programs and models.
+
+#include "alpha_network.h"
+
+#include <r_code/atom.h>       // for Atom, Atom::I_PTR, etc
+#include <r_code/object.h>     // for Code, UNDEFINED_OID
+#include <r_code/utils.h>      // for Utils
+#include <r_exec/opcodes.h>    // for Opcodes, Opcodes::Cst, etc
+#include <stddef.h>            // for size_t
+#include <mutex>               // for mutex, lock_guard
+#include <unordered_map>       // for unordered_map
+
+using r_code::Atom;
+using r_code::Code;
+using r_code::Utils;
+
+namespace r_exec
+{
+
+// Keys are the constant parts of the patterns, as words tagged in their upper half.
+typedef enum {
+    ATOM = 0,
+    STRUCTURE = 1,
+    ANY = 2,
+    REFERENCE = 3, // followed by the address of the object, held by the pattern as long as the node lives.
+    IPGM_MEMBER = 4, // followed by the address of the ipgm.
+    OBJECT = 5,
+    TIMESTAMP = 6 // followed by the timestamp.
+} Tag;
+
+static uint64_t Word(Tag tag, uint32_t value)
+{
+    return ((uint64_t)tag << 32) | value;
+}
+
+class KeyHash
+{
+public:
+    size_t operator()(const std::vector<uint64_t> &key) const
+    {
+        uint64_t h = 14695981039346656037ULL; // FNV-1a.
+
+        for (uint64_t word : key) {
+            h = (h ^ word) * 1099511628211ULL;
+        }
+
+        return (size_t)h;
+    }
+};
+
+typedef std::unordered_map<std::vector<uint64_t>, AlphaNode *, KeyHash> Nodes;
+
+// Never deleted: nodes may be released by controllers deleted at exit.
+static std::mutex &GetNodesMutex()
+{
+    static std::mutex *mutex = new std::mutex();
+    return *mutex;
+}
+
+static Nodes &GetNodes()
+{
+    static Nodes *nodes = new Nodes();
+    return *nodes;
+}
+
+AlphaNode::AlphaNode(std::vector<uint64_t> &key): _Object(), outcome(0)
+{
+    this->key.swap(key);
+}
+
+void AlphaNode::decRef()
+{
+    std::lock_guard<std::mutex> guard(GetNodesMutex());
+
+    if (--refCount == 0) {
+        GetNodes().erase(key);
+        delete this;
+    }
+}
+
+bool AlphaNode::get_outcome(const Code *object, bool &passed) const
+{
+    uint64_t oid = object->get_oid();
+
+    if (oid == UNDEFINED_OID) {
+        return false;
+    }
+
+    uint64_t o = outcome;
+
+    if ((o >> 2) != oid || (o & 2) == 0) {
+        return false;
+    }
+
+    passed = (o & 1) == 1;
+    return true;
+}
+
+void AlphaNode::set_outcome(const Code *object, bool passed)
+{
+    uint64_t oid = object->get_oid();
+
+    if (oid != UNDEFINED_OID) {
+        outcome = (oid << 2) | 2 | (passed ? 1 : 0);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void AlphaNetwork::GetNode(std::vector<uint64_t> &key, core::P<AlphaNode> &node)
+{
+    AlphaNode *n;
+    {
+        std::lock_guard<std::mutex> guard(GetNodesMutex());
+        Nodes::const_iterator found = GetNodes().find(key);
+
+        if (found != GetNodes().end()) {
+            n = found->second;
+        } else {
+            n = new AlphaNode(key);
+            GetNodes()[n->key] = n;
+        }
+
+        n->incRef(); // so that the node cannot be released before node holds it.
+    }
+    node = n;
+    n->decRef();
+}
+
+// Mirror IPGMContext::match() on the side of the skeleton, and IPGMContext::operator *() for its members: false when
+// the outcome depends on the overlay (values, inputs, productions, views).
+static bool AddSkeletonNode(const Atom *code, uint16_t index, Code *pgm, Code *ipgm, std::vector<uint64_t> &key);
+
+static bool AddSkeletonMember(const Atom *code, uint16_t index, Code *pgm, Code *ipgm, std::vector<uint64_t> &key)
+{
+    Atom a = code[index];
+
+    switch (a.getDescriptor()) {
+    case Atom::I_PTR:
+        return AddSkeletonMember(code, a.asIndex(), pgm, ipgm, key);
+
+    case Atom::R_PTR:
+        key.push_back(Word(REFERENCE, 0));
+        key.push_back((uint64_t)pgm->get_reference(a.asIndex()));
+        return true;
+
+    case Atom::IPGM_PTR:
+        key.push_back(Word(IPGM_MEMBER, a.asIndex()));
+        key.push_back((uint64_t)ipgm);
+        return true;
+
+    case Atom::VL_PTR:
+    case Atom::C_PTR:
+    case Atom::THIS:
+    case Atom::VIEW:
+    case Atom::MKS:
+    case Atom::VWS:
+    case Atom::VALUE_PTR:
+    case Atom::IN_OBJ_PTR:
+    case Atom::D_IN_OBJ_PTR:
+    case Atom::PROD_PTR:
+        return false;
+
+    default:
+        return AddSkeletonNode(code, index, pgm, ipgm, key);
+    }
+}
+
+static bool AddSkeletonNode(const Atom *code, uint16_t index, Code *pgm, Code *ipgm, std::vector<uint64_t> &key)
+{
+    Atom a = code[index];
+
+    if (a.isStructural()) {
+        key.push_back(Word(STRUCTURE, a.atom));
+
+        for (uint16_t i = 1; i <= a.getAtomCount(); ++i) {
+            if (!AddSkeletonMember(code, index + i, pgm, ipgm, key)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    if (a.getDescriptor() == Atom::IPGM_PTR) {
+        return AddSkeletonMember(code, index, pgm, ipgm, key);
+    }
+
+    key.push_back(Word(ATOM, a.atom));
+    return true;
+}
+
+void AlphaNetwork::GetPGMNode(Code *pgm, Code *ipgm, uint16_t skeleton_index, core::P<AlphaNode> &node)
+{
+    std::vector<uint64_t> key;
+
+    if (AddSkeletonNode(&pgm->code(0), skeleton_index, pgm, ipgm, key)) {
+        GetNode(key, node);
+    }
+}
+
+// Mirror BindingMap::MatchConstants() on the side of the pattern.
+static void AddObject(const Code *object, std::vector<uint64_t> &key);
+
+static void AddMembers(const Code *object, uint16_t index, uint16_t arity, std::vector<uint64_t> &key)
+{
+    for (uint16_t i = 0; i < arity; ++i) {
+        Atom a = object->code(index + i);
+
+        switch (a.getDescriptor()) {
+        case Atom::T_WILDCARD:
+        case Atom::WILDCARD:
+        case Atom::VL_PTR:
+            key.push_back(Word(ANY, 0));
+            break;
+
+        case Atom::I_PTR: {
+            Atom s = object->code(a.asIndex());
+            key.push_back(Word(STRUCTURE, s.atom));
+
+            if (s.getAtomCount() == 0) { // empty sets.
+                break;
+            }
+
+            if (s.getDescriptor() == Atom::TIMESTAMP) {
+                key.push_back(Word(TIMESTAMP, 0));
+                key.push_back(Utils::GetTimestamp(&object->code(a.asIndex())));
+            } else {
+                AddMembers(object, a.asIndex() + 1, s.getAtomCount(), key);
+            }
+
+            break;
+        }
+
+        case Atom::R_PTR:
+            AddObject(object->get_reference(a.asIndex()), key);
+            break;
+
+        default:
+            key.push_back(Word(ATOM, a.atom));
+            break;
+        }
+    }
+}
+
+static void AddObject(const Code *object, std::vector<uint64_t> &key)
+{
+    Atom head = object->code(0);
+    uint16_t opcode = head.asOpcode();
+    key.push_back(Word(OBJECT, head.atom));
+
+    if (opcode == Opcodes::Ent ||
+        opcode == Opcodes::Ont ||
+        opcode == Opcodes::Mdl ||
+        opcode == Opcodes::Cst) { // matched by identity.
+        key.push_back(Word(REFERENCE, 0));
+        key.push_back((uint64_t)object);
+    } else {
+        AddMembers(object, 1, head.getAtomCount(), key);
+    }
+}
+
+void AlphaNetwork::GetHLPNode(Code *pattern, core::P<AlphaNode> &node)
+{
+    std::vector<uint64_t> key;
+    AddObject(pattern->get_reference(0), key);
+    GetNode(key, node);
+}
+
+uint64_t AlphaNetwork::GetNodeCount()
+{
+    std::lock_guard<std::mutex> guard(GetNodesMutex());
+    return GetNodes().size();
+}
+}
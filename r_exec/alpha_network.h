@@ -0,0 +1,60 @@
+//	alpha_network.h
+//
+//	Tests on the constant parts of patterns, shared across programs and models.
+
+#ifndef alpha_network_h
+#define alpha_network_h
+
+#include <stdint.h>            // for uint64_t, uint16_t
+#include <atomic>              // for atomic
+#include <vector>              // for vector
+
+#include <replicode_common.h>  // for _Object, P, REPLICODE_EXPORT
+
+namespace r_code {
+class Code;
+}  // namespace r_code
+
+namespace r_exec
+{
+
+// The part of a match that does not depend on bindings: for a pgm, the match of a pattern's skeleton (unless it holds
+// values computed by the overlay); for a cst or a mdl, the match of the constants of a pattern's object (variables
+// match anything, see BindingMap::MatchConstants()).
+// The patterns of all programs and models that have the same constant parts share one node: the node remembers the
+// outcome of the test for the last object it was given, so that the overlays of all these programs and models test
+// an input once. The overlays still do the rest of the match (bindings, guards) on their own.
+// Nodes are held by the controllers, and by nothing else: the network forgets a node once released.
+class REPLICODE_EXPORT AlphaNode:
+    public core::_Object
+{
+    friend class AlphaNetwork;
+private:
+    std::vector<uint64_t> key;
+    std::atomic<uint64_t> outcome; // (oid << 2) | 2 | passed, for the last object tested; 0: none.
+
+    AlphaNode(std::vector<uint64_t> &key);
+public:
+    void decRef(); // the last release removes the node from the network.
+
+    bool get_outcome(const r_code::Code *object, bool &passed) const; // false if not tested yet.
+    void set_outcome(const r_code::Code *object, bool passed);
+};
+
+class REPLICODE_EXPORT AlphaNetwork
+{
+private:
+    static void GetNode(std::vector<uint64_t> &key, core::P<AlphaNode> &node); // shares the node with that key, if any.
+public:
+    // Node for the skeleton at skeleton_index in the code of a pgm instantiated by ipgm; nullptr if the outcome of the
+    // match depends on the overlay.
+    static void GetPGMNode(r_code::Code *pgm, r_code::Code *ipgm, uint16_t skeleton_index, core::P<AlphaNode> &node);
+    // Node for the object of a pattern (a fact or |fact) of a cst or a mdl.
+    static void GetHLPNode(r_code::Code *pattern, core::P<AlphaNode> &node);
+
+    static uint64_t GetNodeCount();
+};
+}
+
+
+#endif
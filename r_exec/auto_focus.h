@@ -34,6 +34,7 @@
 
 
 
+#include <r_code/list.h>               // for list
 #include <r_code/time_buffer.h>        // for time_buffer
 #include <r_code/utils.h>              // for PHash
 #include <r_exec/factory.h>            // for _Fact
@@ -52,7 +53,6 @@
 namespace r_code {
 class Code;
 class View;
-template <typename T> class list;
 }  // namespace r_code
 namespace r_exec {
 class BindingMap;
@@ -583,8 +583,9 @@ void BindingMap::clear()
 BindingMap &BindingMap::operator =(const BindingMap &source)
 {
     clear();
+    map.reserve(source.map.size());
 
-    for (const core::P<Value> & value : source.map) {
+    for (const core::P<Value> &value : source.map) {
         map.push_back(value->copy(this));
     }
 
@@ -840,6 +841,99 @@ bool BindingMap::match_object(const Code *object, const Code *pattern)
     return match(object, 0, 1, pattern, 1, object->code(0).getAtomCount());
 }
 
+// Same as BindingMap::match() and BindingMap::match_structure(), variables aside.
+static bool MatchStructureConstants(const Code *object, uint16_t o_base_index, uint16_t o_index, const Code *pattern, uint16_t p_index);
+
+static bool MatchMemberConstants(const Code *object, uint16_t o_base_index, uint16_t o_index, const Code *pattern, uint16_t p_index, uint16_t o_arity)
+{
+    for (;; ++o_index, ++p_index) {
+        Atom o_atom = object->code(o_base_index + o_index);
+        Atom p_atom = pattern->code(p_index);
+
+        switch (p_atom.getDescriptor()) {
+        case Atom::T_WILDCARD:
+        case Atom::WILDCARD:
+        case Atom::VL_PTR:
+            break;
+
+        default:
+            switch (o_atom.getDescriptor()) {
+            case Atom::T_WILDCARD:
+            case Atom::WILDCARD:
+            case Atom::VL_PTR:
+                break;
+
+            case Atom::I_PTR:
+                if (p_atom.getDescriptor() != Atom::I_PTR || !MatchStructureConstants(object, o_atom.asIndex(), 0, pattern, p_atom.asIndex())) {
+                    return false;
+                }
+
+                break;
+
+            case Atom::R_PTR:
+                if (p_atom.getDescriptor() != Atom::R_PTR || !BindingMap::MatchConstants(object->get_reference(o_atom.asIndex()), pattern->get_reference(p_atom.asIndex()))) {
+                    return false;
+                }
+
+                break;
+
+            default:
+                if (p_atom != o_atom && !(p_atom.isFloat() && o_atom.isFloat() && Utils::Equal(o_atom.asFloat(), p_atom.asFloat()))) {
+                    return false;
+                }
+
+                break;
+            }
+
+            break;
+        }
+
+        if (o_index == o_arity) {
+            return true;
+        }
+    }
+}
+
+static bool MatchStructureConstants(const Code *object, uint16_t o_base_index, uint16_t o_index, const Code *pattern, uint16_t p_index)
+{
+    uint16_t o_full_index = o_base_index + o_index;
+    Atom o_atom = object->code(o_full_index);
+
+    if (o_atom != pattern->code(p_index)) {
+        return false;
+    }
+
+    uint16_t arity = o_atom.getAtomCount();
+
+    if (arity == 0) { // empty sets.
+        return true;
+    }
+
+    if (o_atom.getDescriptor() == Atom::TIMESTAMP) {
+        return Utils::Synchronous(Utils::GetTimestamp(&object->code(o_full_index)), Utils::GetTimestamp(&pattern->code(p_index)));
+    }
+
+    return MatchMemberConstants(object, o_base_index, o_index + 1, pattern, p_index + 1, arity);
+}
+
+bool BindingMap::MatchConstants(const Code *object, const Code *pattern)
+{
+    if (object->code(0) != pattern->code(0)) {
+        return false;
+    }
+
+    uint16_t pattern_opcode = pattern->code(0).asOpcode();
+
+    if (pattern_opcode == Opcodes::Ent ||
+        pattern_opcode == Opcodes::Ont ||
+        pattern_opcode == Opcodes::Mdl ||
+        pattern_opcode == Opcodes::Cst) {
+        return object == pattern;
+    }
+
+    return MatchMemberConstants(object, 0, 1, pattern, 1, object->code(0).getAtomCount());
+}
+
 void BindingMap::bind_variable(BoundValue *value, uint8_t id)
 {
     map[id] = value;
@@ -938,8 +1032,9 @@ void HLPBindingMap::clear()
 HLPBindingMap &HLPBindingMap::operator =(const HLPBindingMap &source)
 {
     clear();
+    map.reserve(source.map.size());
 
-    for (core::P<Value> value : source.map) {
+    for (const core::P<Value> &value : source.map) {
         map.push_back(value->copy(this));
     }
 
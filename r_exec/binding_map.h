@@ -245,6 +245,7 @@ public:
     uint64_t get_fwd_before() const; // idem.
 
     bool match_object(const r_code::Code *object, const r_code::Code *pattern);
+    static bool MatchConstants(const r_code::Code *object, const r_code::Code *pattern); // necessary for match_object() whatever the bindings: variables match anything.
     bool match_structure(const r_code::Code *object, uint16_t o_base_index, uint16_t o_index, const r_code::Code *pattern, uint16_t p_index);
     bool match_atom(r_code::Atom o_atom, r_code::Atom p_atom);
 
@@ -35,6 +35,7 @@
 #include <r_exec/context.h>         // for IPGMContext, etc
 #include <r_exec/group.h>           // for Group
 #include <r_exec/mem.h>             // for _Mem
+#include <r_exec/operator.tpl.h>    // for Operator::evaluate
 #include <stdlib.h>                 // for exit
 #include <cstdint>                  // for uint16_t, uintptr_t, int16_t, etc
 
@@ -183,6 +184,7 @@ IPGMContext IPGMContext::operator *() const
             switch ((*this)[i].getDescriptor()) {
             case Atom::VIEW: // accessible only for this and input objects.
                 if (c.view) {
+                    c.view->store_ctrl_values();
                     c = IPGMContext(c.getObject(), c.view, &c.view->code(0), 0, nullptr, VIEW);
                 } else {
                     return IPGMContext();
@@ -211,6 +213,7 @@ IPGMContext IPGMContext::operator *() const
 
     case Atom::VIEW: // never a reference, always in a cptr.
         if (overlay && object == overlay->getObject()) {
+            view->store_ctrl_values();
             return IPGMContext(object, view, &view->code(0), 0, nullptr, VIEW);
         }
 
@@ -285,9 +288,7 @@ bool IPGMContext::evaluate_no_dereference(uint16_t &result_index) const
             }
         }
 
-        IPGMContext *__c = new IPGMContext(*this);
-        Context _c(__c);
-        return op(_c, result_index);
+        return op.evaluate(*this, result_index);
     }
 
     case Atom::OBJECT: // incl. cmd.
@@ -520,7 +521,7 @@ bool IPGMContext::is_cmd_with_cptr() const
 
 uint16_t IPGMContext::addProduction(Code *object, bool check_for_existence) const   // called by operators (ins and red).
 {
-    ((InputLessPGMOverlay *)overlay)->productions.push_back(_Mem::Get()->check_existence(object));
+    ((InputLessPGMOverlay *)overlay)->productions.push_back(check_for_existence ? _Mem::Get()->check_existence(object) : object);
     return ((InputLessPGMOverlay *)overlay)->productions.size() - 1;
 }
 
@@ -43,6 +43,7 @@
 #include <r_exec/view.h>         // for View
 #include <stddef.h>              // for NULL
 #include <stdint.h>              // for uint16_t, int64_t, int16_t, etc
+#include <new>                   // for operator new
 #include <unordered_set>         // for unordered_set, etc
 #include <vector>                // for vector
 
@@ -322,10 +323,9 @@ public:
     IPGMContext(Code *object, Data data): _Context(&object->code(0), index, NULL, data), object(object), view(NULL) {}
 
     // _Context implementation.
-    _Context *assign(const _Context *c)
+    _Context *clone(void *storage) const
     {
-        IPGMContext *_c = new IPGMContext(*(IPGMContext *)c);
-        return _c;
+        return new(storage) IPGMContext(*this);
     }
 
     bool equal(const _Context *c) const
@@ -364,16 +364,14 @@ public:
             return code[index].getAtomCount();
         }
     }
-    _Context *_getChild(uint16_t index) const
+    _Context *_getChild(uint16_t index, void *storage) const
     {
-        IPGMContext *_c = new IPGMContext(getChild(index));
-        return _c;
+        return new(storage) IPGMContext(getChild(index));
     }
 
-    _Context *dereference() const
+    _Context *dereference(void *storage) const
     {
-        IPGMContext *_c = new IPGMContext(**this);
-        return _c;
+        return new(storage) IPGMContext(**this);
     }
 
     // IPGM specifics.
@@ -417,7 +415,7 @@ public:
 
         case MKS: {
             uint16_t i = 0;
-            r_code::list<Code *>::const_iterator m;
+            Code::MarkerList::const_iterator m;
             object->acq_markers();
 
             for (m = object->markers.begin(); i < index - 1; ++i, ++m) {
@@ -433,7 +431,7 @@ public:
 
         case VWS: {
             uint16_t i = 0;
-            std::unordered_set<r_code::View *, r_code::View::Hash, r_code::View::Equal>::const_iterator v;
+            r_code::Code::ViewSet::const_iterator v;
             object->acq_views();
 
             for (v = object->views.begin(); i < index - 1; ++i, ++v) {
@@ -444,6 +442,7 @@ public:
             }
 
             object->rel_views();
+            (*v)->store_ctrl_values();
             return IPGMContext(object, (r_exec::View*)*v, &(*v)->code(0), this->index + index, NULL, VIEW);
         }
 
@@ -523,6 +522,8 @@ public:
     static bool Fvw(const IPGMContext &context, uint16_t &index);
     static bool Red(const IPGMContext &context, uint16_t &index);
 };
+
+static_assert(sizeof(IPGMContext) <= _Context::MaxSize, "IPGMContext does not fit in a Context");
 }
 
 
@@ -0,0 +1,253 @@
+//	cpu_affinity.cpp
+//
+//	Pinning of the cores to CPUs, and NUMA placement.
+
+#include "cpu_affinity.h"
+
+#include <ctype.h>             // for isdigit
+#include <stdlib.h>            // for strtoull
+#include <algorithm>           // for sort, unique
+#include <atomic>              // for atomic
+#include <fstream>             // for ifstream
+#include <thread>              // for thread
+
+#if defined(__linux__)
+#include <dirent.h>            // for opendir, readdir, closedir
+#include <pthread.h>           // for pthread_setaffinity_np
+#include <sched.h>             // for cpu_set_t, CPU_SET, CPU_ZERO
+#include <sys/syscall.h>       // for SYS_set_mempolicy
+#include <unistd.h>            // for syscall
+#endif
+
+
+namespace r_exec
+{
+
+static thread_local int64_t CurrentNode = -1;
+static std::atomic<bool> NUMA(false);
+static std::atomic<uint64_t> NextHomeNode(0);
+
+class Topology
+{
+public:
+    std::vector<uint64_t> cpu_nodes; // indexed by cpu.
+    uint64_t node_count;
+
+    Topology(): node_count(1)
+    {
+#if defined(__linux__)
+        DIR *dir = opendir("/sys/devices/system/node");
+
+        if (!dir) {
+            return;
+        }
+
+        uint64_t max_node = 0;
+
+        while (dirent *entry = readdir(dir)) {
+            std::string name = entry->d_name;
+
+            if (name.compare(0, 4, "node") != 0 || name.size() == 4 || name.find_first_not_of("0123456789", 4) != std::string::npos) {
+                continue;
+            }
+
+            uint64_t node = strtoull(name.c_str() + 4, nullptr, 10);
+            std::ifstream file("/sys/devices/system/node/" + name + "/cpulist");
+            std::string list;
+            std::vector<uint64_t> cpus;
+
+            if (!std::getline(file, list) || !CPUAffinity::Parse(list, cpus)) {
+                continue;
+            }
+
+            for (uint64_t cpu : cpus) {
+                if (cpu >= cpu_nodes.size()) {
+                    cpu_nodes.resize(cpu + 1, 0);
+                }
+
+                cpu_nodes[cpu] = node;
+            }
+
+            if (node > max_node) {
+                max_node = node;
+            }
+        }
+
+        closedir(dir);
+        node_count = max_node + 1;
+#endif
+    }
+};
+
+static Topology &GetTopology()
+{
+    static Topology topology;
+    return topology;
+}
+
+bool CPUAffinity::Parse(const std::string &list, std::vector<uint64_t> &cpus)
+{
+    cpus.clear();
+    size_t i = 0;
+
+    while (i < list.size()) {
+        if (list[i] == ' ' || list[i] == ',' || list[i] == '\n') {
+            ++i;
+            continue;
+        }
+
+        if (!isdigit(list[i])) {
+            return false;
+        }
+
+        char *end;
+        uint64_t first = strtoull(list.c_str() + i, &end, 10);
+        uint64_t last = first;
+        i = end - list.c_str();
+
+        if (i < list.size() && list[i] == '-') {
+            if (++i == list.size() || !isdigit(list[i])) {
+                return false;
+            }
+
+            last = strtoull(list.c_str() + i, &end, 10);
+            i = end - list.c_str();
+        }
+
+        if (last < first || last - first > 65535) { // no such machine.
+            return false;
+        }
+
+        for (uint64_t cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return true;
+}
+
+void CPUAffinity::GetOnlineCPUs(std::vector<uint64_t> &cpus)
+{
+    cpus.clear();
+#if defined(__linux__)
+    std::ifstream file("/sys/devices/system/cpu/online");
+    std::string list;
+
+    if (std::getline(file, list) && Parse(list, cpus) && !cpus.empty()) {
+        return;
+    }
+
+#endif
+
+    for (uint64_t cpu = 0; cpu < std::thread::hardware_concurrency(); ++cpu) {
+        cpus.push_back(cpu);
+    }
+}
+
+uint64_t CPUAffinity::GetNodeCount()
+{
+    return GetTopology().node_count;
+}
+
+uint64_t CPUAffinity::GetNode(uint64_t cpu)
+{
+    Topology &topology = GetTopology();
+    return cpu < topology.cpu_nodes.size() ? topology.cpu_nodes[cpu] : 0;
+}
+
+bool CPUAffinity::Pin(const std::vector<uint64_t> &cpus)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    for (uint64_t cpu : cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+bool CPUAffinity::PinToNode(const std::vector<uint64_t> &cpus, uint64_t index)
+{
+    std::vector<uint64_t> candidates = cpus;
+
+    if (candidates.empty()) {
+        GetOnlineCPUs(candidates);
+    }
+
+    std::vector<uint64_t> nodes;
+
+    for (uint64_t cpu : candidates) {
+        nodes.push_back(GetNode(cpu));
+    }
+
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+    if (nodes.empty()) {
+        return false;
+    }
+
+    uint64_t node = nodes[index % nodes.size()];
+    std::vector<uint64_t> node_cpus;
+
+    for (uint64_t cpu : candidates) {
+        if (GetNode(cpu) == node) {
+            node_cpus.push_back(cpu);
+        }
+    }
+
+    if (!Pin(node_cpus)) {
+        return false;
+    }
+
+    CurrentNode = node;
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+    const int PreferredPolicy = 1; // MPOL_PREFERRED: falls back to the other nodes when this one is full.
+    unsigned long mask[16] = { 0 };
+
+    if (node < sizeof(mask) * 8) {
+        mask[node / (sizeof(unsigned long) * 8)] = 1ul << (node % (sizeof(unsigned long) * 8));
+        syscall(SYS_set_mempolicy, PreferredPolicy, mask, sizeof(mask) * 8);
+    }
+
+#endif
+    return true;
+}
+
+void CPUAffinity::SetNUMA(bool numa)
+{
+    NUMA = numa;
+}
+
+bool CPUAffinity::IsNUMA()
+{
+    return NUMA;
+}
+
+int64_t CPUAffinity::GetCurrentNode()
+{
+    return CurrentNode;
+}
+
+int64_t CPUAffinity::HomeNode()
+{
+    if (!NUMA) {
+        return -1;
+    }
+
+    if (CurrentNode >= 0) {
+        return CurrentNode;
+    }
+
+    return NextHomeNode++ % GetNodeCount();
+}
+}
@@ -0,0 +1,48 @@
+//	cpu_affinity.h
+//
+//	Pinning of the cores to CPUs, and NUMA placement.
+
+#ifndef cpu_affinity_h
+#define cpu_affinity_h
+
+#include <stdint.h>            // for uint64_t, int64_t
+#include <string>              // for string
+#include <vector>              // for vector
+
+#include <replicode_common.h>  // for REPLICODE_EXPORT
+
+namespace r_exec
+{
+
+// The topology is read once from /sys/devices/system/node; without it (or on other systems than Linux) there is
+// one node and pinning does nothing.
+// With NUMA placement on, a core is pinned to the CPUs of one node and prefers that node for its allocations:
+// objects created by the core land there (the allocator keeps one arena per thread). Groups get a home node (see
+// HomeNode()), and the reduction jobs for a group prefer the cores of that node (see ReductionPipe).
+class REPLICODE_EXPORT CPUAffinity
+{
+public:
+    // Parses a list of CPUs like "0-3,8,10-11"; false if malformed. An empty list is valid.
+    static bool Parse(const std::string &list, std::vector<uint64_t> &cpus);
+
+    static void GetOnlineCPUs(std::vector<uint64_t> &cpus);
+    static uint64_t GetNodeCount(); // at least 1.
+    static uint64_t GetNode(uint64_t cpu); // 0 if unknown.
+
+    // Restricts the calling thread to the cpus; false on error.
+    static bool Pin(const std::vector<uint64_t> &cpus);
+    // Pins the calling thread to the cpus of the index-th node spanned by cpus (all the online ones if empty),
+    // round robin, and has it allocate on that node; false on error.
+    static bool PinToNode(const std::vector<uint64_t> &cpus, uint64_t index);
+
+    static void SetNUMA(bool numa);
+    static bool IsNUMA();
+    static int64_t GetCurrentNode(); // node the calling thread is pinned to; -1 if none.
+    // Node the objects created by the calling thread should live on: the current node, or the next node round robin
+    // for threads that are not pinned (e.g. the loading thread); -1 unless NUMA placement is on.
+    static int64_t HomeNode();
+};
+}
+
+
+#endif
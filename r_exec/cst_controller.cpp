@@ -117,7 +117,7 @@ void CSTOverlay::inject_production()
             ((CSTController *)controller)->inject_prediction(f_p_f_icst, lowest_cfd, time_to_live); // inject a f->pred->icst in the primary group, no rdx.
             LOG_TRACE << Utils::Timestamp(Now()) << "				" << f_p_f_icst->get_oid() << " pred icst[" << controller->getObject()->get_oid() << "][";
 
-            for (P<_Fact> input : inputs) {
+            for (const P<_Fact> &input : inputs) {
                 LOG_TRACE << " " << input->get_oid();
             }
 
@@ -125,7 +125,7 @@ void CSTOverlay::inject_production()
             ((CSTController *)controller)->inject_icst(f_icst, lowest_cfd, time_to_live); // inject f->icst in the primary and secondary groups, and in the output groups.
             LOG_TRACE << Utils::Timestamp(Now()) << "				" << f_icst->get_oid() << " icst[" << controller->getObject()->get_oid() << "][";
 
-            for (P<_Fact> input : inputs) {
+            for (const P<_Fact> &input : inputs) {
                 LOG_TRACE << " " << input->get_oid();
             }
 
@@ -169,7 +169,7 @@ void CSTOverlay::update(HLPBindingMap *map, _Fact *input, _Fact *bound_pattern)
         last_cfd = prediction->get_target()->get_cfd();
 
         if (prediction->is_simulation()) {
-            for (P<Sim> simulation : prediction->simulations) {
+            for (const P<Sim> &simulation : prediction->simulations) {
                 simulations.insert(simulation);
             }
         } else {
@@ -191,7 +191,7 @@ bool CSTOverlay::reduce(View *input, CSTOverlay *&offspring)
         return false;
     }
 
-    for (P<_Fact> currentInput : inputs) { // discard inputs that already matched.
+    for (const P<_Fact> &currentInput : inputs) { // discard inputs that already matched.
         if (((_Fact *)input->object) == currentInput) {
             offspring = nullptr;
             return false;
@@ -220,6 +220,10 @@ bool CSTOverlay::reduce(View *input, CSTOverlay *&offspring)
     r_code::list<P<_Fact> >::const_iterator p;
 
     for (p = patterns.begin(); p != patterns.end(); ++p) {
+        if (!may_match(input_object, *p)) {
+            continue;
+        }
+
         bm->load(bindings);
 
         if (inputs.size() == 0) {
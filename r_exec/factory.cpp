@@ -530,11 +530,6 @@ void _Fact::trace() const
 
 ////////////////////////////////////////////////////////////////
 
-void *Fact::operator new(size_t s)
-{
-    return _Mem::Get()->_build_object(Atom::Object(Opcodes::Fact, FACT_ARITY));
-}
-
 Fact::Fact(): _Fact()
 {
     code(0) = Atom::Object(Opcodes::Fact, FACT_ARITY);
@@ -554,11 +549,6 @@ Fact::Fact(Code *object, uint64_t after, uint64_t before, double confidence, dou
 
 ////////////////////////////////////////////////////////////////
 
-void *AntiFact::operator new(size_t s)
-{
-    return _Mem::Get()->_build_object(Atom::Object(Opcodes::AntiFact, FACT_ARITY));
-}
-
 AntiFact::AntiFact(): _Fact()
 {
     code(0) = Atom::Object(Opcodes::AntiFact, FACT_ARITY);
@@ -600,14 +590,14 @@ bool Pred::is_invalidated()
         return true;
     }
 
-    for (P<Sim> simulation : simulations) {
+    for (const P<Sim> &simulation : simulations) {
         if (simulation->is_invalidated()) {
             invalidate();
             return true;
         }
     }
 
-    for (P<_Fact> ground : grounds) {
+    for (const P<_Fact> &ground : grounds) {
         if (ground->is_invalidated()) {
             invalidate();
             return true;
@@ -624,7 +614,7 @@ bool Pred::is_invalidated()
 
 bool Pred::grounds_invalidated(_Fact *evidence)
 {
-    for (P<_Fact> ground : grounds) {
+    for (const P<_Fact> &ground : grounds) {
         if (evidence->is_evidence(ground) == MATCH_SUCCESS_NEGATIVE) {
             return true;
         }
@@ -645,7 +635,7 @@ bool Pred::is_simulation() const
 
 Sim *Pred::get_simulation(Controller *root) const
 {
-    for (P<Sim> simulation : simulations) {
+    for (const P<Sim> &simulation : simulations) {
         if (simulation->root == root) {
             return simulation;
         }
@@ -868,7 +858,7 @@ bool ICST::is_invalidated()
         return true;
     }
 
-    for (P<_Fact> component : components) {
+    for (const P<_Fact> &component : components) {
         if (component->is_invalidated()) {
             invalidate();
             //std::cout<<Time::ToString_seconds(Now()-Utils::GetTimeReference())<<" "<<std::hex<<this<<std::dec<<" icst invalidated"<<std::endl;
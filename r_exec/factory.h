@@ -202,7 +202,6 @@ class REPLICODE_EXPORT Fact:
     public _Fact
 {
 public:
-    void *operator new(size_t s);
     Fact();
     Fact(r_code::SysObject *source);
     Fact(Fact *f);
@@ -214,7 +213,6 @@ class REPLICODE_EXPORT AntiFact:
     public _Fact
 {
 public:
-    void *operator new(size_t s);
     AntiFact();
     AntiFact(r_code::SysObject *source);
     AntiFact(AntiFact *f);
@@ -134,7 +134,7 @@ GMonitor::GMonitor(PMDLController *controller,
 {
     injected_goal = (predicted_evidence == nullptr);
     MonitoringJob<GMonitor> *j = new MonitoringJob<GMonitor>(this, simulating ? sim_thz : deadline);
-    _Mem::Get()->pushTimeJob(j);
+    _Mem::Get()->pushTimeJob(j, job);
 }
 
 void GMonitor::commit()   // the purpose is to invalidate damaging simulations; if anything remains, commit to all mandatory simulations and to the best optional one.
@@ -327,7 +327,7 @@ RMonitor::RMonitor(PrimaryMDLController *controller,
                                nullptr)   // goal is f0->g->f1->object.
 {
     MonitoringJob<RMonitor> *j = new MonitoringJob<RMonitor>(this, deadline);
-    _Mem::Get()->pushTimeJob(j);
+    _Mem::Get()->pushTimeJob(j, job);
 }
 
 bool RMonitor::signal(bool simulation)
@@ -414,7 +414,7 @@ SGMonitor::SGMonitor(PrimaryMDLController *controller,
                                  f_imdl)   // goal is f0->g->f1->object.
 {
     MonitoringJob<SGMonitor> *j = new MonitoringJob<SGMonitor>(this, sim_thz);
-    _Mem::Get()->pushTimeJob(j);
+    _Mem::Get()->pushTimeJob(j, job);
 }
 
 void SGMonitor::commit()   // the purpose is to invalidate damaging simulations and let the rest flow upward.
@@ -516,7 +516,7 @@ SRMonitor::SRMonitor(PrimaryMDLController *controller,
                                  f_imdl)   // goal is f0->g->f1->object.
 {
     MonitoringJob<SRMonitor> *j = new MonitoringJob<SRMonitor>(this, sim_thz);
-    _Mem::Get()->pushTimeJob(j);
+    _Mem::Get()->pushTimeJob(j, job);
 }
 
 bool SRMonitor::signal(bool simulation)
@@ -31,11 +31,14 @@
 #include "group.h"
 
 #include <math.h>                   // for fabs
+#include <string.h>                 // for memcpy
+#include <algorithm>                // for sort
 #include <r_code/atom.h>            // for Atom, Atom::::COMPOSITE_STATE, etc
 #include <r_code/list.h>            // for list<>::const_iterator, list, etc
 #include <r_code/replicode_defs.h>  // for GRP_ACT_THR, GRP_C_ACT, etc
 #include <r_code/utils.h>           // for Utils, Utils::MaxTime
 #include <r_exec/cpp_programs.h>    // for CPPPrograms
+#include <r_exec/cpu_affinity.h>    // for CPUAffinity
 #include <r_exec/cst_controller.h>  // for CSTController
 #include <r_exec/factory.h>         // for MkActChg, MkHighAct, MkHighSln, etc
 #include <r_exec/group.h>           // for Group, Group::GroupState, etc
@@ -47,6 +50,7 @@
 #include <r_exec/pgm_controller.h>  // for AntiPGMController, PGMController, etc
 #include <r_exec/time_job.h>        // for AntiPGMSignalingJob, etc
 #include <cstdint>                  // for uint64_t, uint16_t, uint32_t
+#include <limits>                   // for numeric_limits
 #include <ostream>                  // for operator<<, basic_ostream, etc
 #include <string>                   // for operator<<, char_traits, string
 #include <unordered_set>            // for unordered_set
@@ -58,14 +62,14 @@
 namespace r_exec
 {
 
-Group::Group(r_code::Mem *m): LObject(m)
+Group::Group(r_code::Mem *m): LObject(m), next_update_time(Utils::MaxTime), node(CPUAffinity::HomeNode()), footprint(0)
 {
     reset_ctrl_values();
     reset_stats();
     reset_decay_values();
 }
 
-Group::Group(r_code::SysObject *source): LObject(source)
+Group::Group(r_code::SysObject *source): LObject(source), next_update_time(Utils::MaxTime), node(CPUAffinity::HomeNode()), footprint(0)
 {
     reset_ctrl_values();
     reset_stats();
@@ -83,11 +87,17 @@ bool Group::invalidate()
         return true;
     }
 
-    // unregister from all groups it views.
-    std::unordered_map<uint64_t, P<View> >::const_iterator gv;
+    if (next_update_time != Utils::MaxTime) { // release it now rather than at the next upr.
+        _Mem::Get()->unschedule_group_update(this);
+    }
 
-    for (gv = group_views.begin(); gv != group_views.end(); ++gv) {
-        Group *group = (Group *)gv->second->object;
+    if (uint64_t released = footprint.exchange(0)) {
+        _Mem::Get()->report_footprint(-(int64_t)released, 0);
+    }
+
+    // unregister from all groups it views.
+    for (size_t i = 0; i < view_index.size(ViewIndex::GROUP); ++i) {
+        Group *group = (Group *)view_index.at(ViewIndex::GROUP, i)->object;
         std::lock_guard<std::mutex> guard(group->mutex);
         group->viewing_groups.erase(this);
     }
@@ -96,18 +106,13 @@ bool Group::invalidate()
     // remove all views that are hosted by this group.
     FOR_ALL_VIEWS_BEGIN(this,v)
 
-    v->second->object->acq_views();
-    v->second->object->views.erase(v->second); // delete view from object's views.
-    v->second->object->rel_views();
+    v->object->acq_views();
+    v->object->views.erase(v); // delete view from object's views.
+    v->object->rel_views();
 
     FOR_ALL_VIEWS_END
 
-    notification_views.clear();
-    ipgm_views.clear();
-    anti_ipgm_views.clear();
-    input_less_ipgm_views.clear();
-    other_views.clear();
-    group_views.clear();
+    view_index.clear();
     */
     return false;
 }
@@ -551,43 +556,7 @@ inline bool Group::is_eligible_input(View *view)
 
 View *Group::get_view_for_object(uint64_t OID)
 {
-    std::unordered_map<uint64_t, P<View> >::const_iterator it = other_views.find(OID);
-
-    if (it != other_views.end()) {
-        return it->second;
-    }
-
-    it = group_views.find(OID);
-
-    if (it != group_views.end()) {
-        return it->second;
-    }
-
-    it = ipgm_views.find(OID);
-
-    if (it != ipgm_views.end()) {
-        return it->second;
-    }
-
-    it = anti_ipgm_views.find(OID);
-
-    if (it != anti_ipgm_views.end()) {
-        return it->second;
-    }
-
-    it = input_less_ipgm_views.find(OID);
-
-    if (it != input_less_ipgm_views.end()) {
-        return it->second;
-    }
-
-    it = notification_views.find(OID);
-
-    if (it != notification_views.end()) {
-        return it->second;
-    }
-
-    return nullptr;
+    return view_index.find(OID);
 }
 
 void Group::reset_ctrl_values()
@@ -672,13 +641,13 @@ void Group::update_stats()
 
     if (sln_change_monitoring_periods_to_go == 0) {
         FOR_ALL_NON_NTF_VIEWS_BEGIN(this, v)
-        double change = v->second->update_sln_delta();
+        double change = v->update_sln_delta();
 
         if (fabs(change) > get_sln_chg_thr()) {
             uint16_t ntf_grp_count = get_ntf_grp_count();
 
             for (uint16_t i = 1; i <= ntf_grp_count; ++i) {
-                _Mem::Get()->inject_notification(new NotificationView(this, get_ntf_grp(i), new MkSlnChg(_Mem::Get(), v->second->object, change)), false);
+                _Mem::Get()->inject_notification(new NotificationView(this, get_ntf_grp(i), new MkSlnChg(_Mem::Get(), v->object, change)), false);
             }
         }
 
@@ -687,13 +656,13 @@ void Group::update_stats()
 
     if (act_change_monitoring_periods_to_go == 0) {
         FOR_ALL_NON_NTF_VIEWS_BEGIN(this, v)
-        double change = v->second->update_act_delta();
+        double change = v->update_act_delta();
 
         if (fabs(change) > get_act_chg_thr()) {
             uint16_t ntf_grp_count = get_ntf_grp_count();
 
             for (uint16_t i = 1; i <= ntf_grp_count; ++i) {
-                _Mem::Get()->inject_notification(new NotificationView(this, get_ntf_grp(i), new MkActChg(_Mem::Get(), v->second->object, change)), false);
+                _Mem::Get()->inject_notification(new NotificationView(this, get_ntf_grp(i), new MkActChg(_Mem::Get(), v->object, change)), false);
             }
         }
 
@@ -872,32 +841,80 @@ double Group::update_c_act_thr()
     return get_c_act_thr();
 }
 
-double Group::update_res(View *v)
+void Group::evict(std::vector<uint32_t> &candidates, uint64_t budget, uint64_t &new_footprint)
+{
+    ViewCtrlValues &ctrl_values = view_index.get_ctrl_values();
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&ctrl_values](uint32_t slot) { // evicted on injection in the meantime.
+        size_t i;
+        return ctrl_values.get_block(slot, i)->views[i] == nullptr;
+    }), candidates.end());
+    std::sort(candidates.begin(), candidates.end(), [&ctrl_values](uint32_t lhs, uint32_t rhs) {
+        size_t l;
+        size_t r;
+        ViewCtrlValues::Block *lhs_block = ctrl_values.get_block(lhs, l);
+        ViewCtrlValues::Block *rhs_block = ctrl_values.get_block(rhs, r);
+        return lhs_block->sln[l] > rhs_block->sln[r] || (lhs_block->sln[l] == rhs_block->sln[r] && lhs_block->views[l]->get_oid() > rhs_block->views[r]->get_oid());
+    });
+
+    while (!candidates.empty() && new_footprint > budget) { // the least salient views are at the back.
+        size_t i;
+        ViewCtrlValues::Block *block = ctrl_values.get_block(candidates.back(), i);
+        View *v = block->views[i];
+        new_footprint -= block->footprint[i];
+        v->delete_from_object();
+        delete_view(v);
+        candidates.pop_back();
+    }
+}
+
+void Group::account(View *view)
 {
-    if (v->object->is_invalidated()) {
-        return 0;
+    uint64_t view_footprint = ViewCtrlValues::Footprint(view);
+    uint64_t new_footprint = footprint.fetch_add(view_footprint) + view_footprint;
+    _Mem::Get()->report_footprint((int64_t)view_footprint, 0);
+    uint64_t soft_budget;
+    uint64_t hard_budget;
+    _Mem::Get()->get_memory_budgets(new_footprint, soft_budget, hard_budget);
+
+    if (hard_budget == 0 || new_footprint <= hard_budget) {
+        return;
     }
 
-    float res = v->update_res();
+    // down to the soft budget if lower, so that the next injections do not scan the group again right away.
+    uint64_t budget = (soft_budget > 0 && soft_budget < hard_budget) ? soft_budget : hard_budget;
+    ViewCtrlValues &ctrl_values = view_index.get_ctrl_values();
+    std::vector<uint32_t> candidates;
 
-    if (!v->isNotification() && res > 0 && res < get_low_res_thr()) {
-        uint16_t ntf_grp_count = get_ntf_grp_count();
+    for (size_t b = 0; b < ctrl_values.get_block_count(); ++b) {
+        ViewCtrlValues::Block *block = ctrl_values.get_block(b);
 
-        for (uint16_t i = 1; i <= ntf_grp_count; ++i) {
-            _Mem::Get()->inject_notification(new NotificationView(this, get_ntf_grp(i), new MkLowRes(_Mem::Get(), v->object)), false);
+        for (size_t i = 0; i < ViewCtrlValues::BlockSize; ++i) {
+            if (block->views[i] && block->views[i] != view && (block->flags[i] & ViewCtrlValues::EVICTABLE) && block->res[i] != std::numeric_limits<float>::infinity()) {
+                candidates.push_back((uint32_t)(b * ViewCtrlValues::BlockSize + i));
+            }
         }
     }
 
-    return res;
+    size_t candidate_count = candidates.size();
+    evict(candidates, budget, new_footprint);
+    _Mem::Get()->report_footprint((int64_t)new_footprint - (int64_t)footprint.exchange(new_footprint), candidate_count - candidates.size());
 }
 
-double Group::update_sln(View *v)
+void Group::update_res(ViewCtrlValues::Block *block, size_t slot)
 {
-    if (decay_periods_to_go > 0 && sln_decay != 0) {
-        v->mod_sln(v->get_sln()*sln_decay);
+    if (!(block->flags[slot] & ViewCtrlValues::NOTIFICATION) && (block->crossings[slot] & ViewCtrlValues::LOW_RES)) {
+        P<Code> object = block->views[slot]->object; // the notifications may evict the view (see account()).
+        uint16_t ntf_grp_count = get_ntf_grp_count();
+
+        for (uint16_t i = 1; i <= ntf_grp_count; ++i) {
+            _Mem::Get()->inject_notification(new NotificationView(this, get_ntf_grp(i), new MkLowRes(_Mem::Get(), object)), false);
+        }
     }
+}
 
-    double sln = v->update_sln(get_low_sln_thr(), get_high_sln_thr());
+void Group::update_sln(ViewCtrlValues::Block *block, size_t slot)
+{
+    double sln = block->sln[slot];
     avg_sln += sln;
 
     if (sln > high_sln) {
@@ -908,30 +925,30 @@ double Group::update_sln(View *v)
 
     ++sln_updates;
 
-    if (!v->isNotification()) {
-        if (v->periods_at_high_sln == get_sln_ntf_prd()) {
-            v->periods_at_high_sln = 0;
+    if (!(block->flags[slot] & ViewCtrlValues::NOTIFICATION)) {
+        if (block->periods_at_high_sln[slot] == get_sln_ntf_prd()) {
+            block->periods_at_high_sln[slot] = 0;
+            P<Code> object = block->views[slot]->object; // the notifications may evict the view (see account()).
             uint16_t ntf_grp_count = get_ntf_grp_count();
 
             for (uint16_t i = 1; i <= ntf_grp_count; ++i) {
-                _Mem::Get()->inject_notification(new NotificationView(this, get_ntf_grp(i), new MkHighSln(_Mem::Get(), v->object)), false);
+                _Mem::Get()->inject_notification(new NotificationView(this, get_ntf_grp(i), new MkHighSln(_Mem::Get(), object)), false);
             }
-        } else if (v->periods_at_low_sln == get_sln_ntf_prd()) {
-            v->periods_at_low_sln = 0;
+        } else if (block->periods_at_low_sln[slot] == get_sln_ntf_prd()) {
+            block->periods_at_low_sln[slot] = 0;
+            P<Code> object = block->views[slot]->object; // the notifications may evict the view (see account()).
             uint16_t ntf_grp_count = get_ntf_grp_count();
 
             for (uint16_t i = 1; i <= ntf_grp_count; ++i) {
-                _Mem::Get()->inject_notification(new NotificationView(this, get_ntf_grp(i), new MkLowSln(_Mem::Get(), v->object)), false);
+                _Mem::Get()->inject_notification(new NotificationView(this, get_ntf_grp(i), new MkLowSln(_Mem::Get(), object)), false);
             }
         }
     }
-
-    return sln;
 }
 
-double Group::update_act(View *v)
+void Group::update_act(ViewCtrlValues::Block *block, size_t slot)
 {
-    double act = v->update_act(get_low_act_thr(), get_high_act_thr());
+    double act = block->act[slot];
     avg_act += act;
 
     if (act > high_act) {
@@ -942,25 +959,164 @@ double Group::update_act(View *v)
 
     ++act_updates;
 
-    if (!v->isNotification()) {
-        if (v->periods_at_high_act == get_act_ntf_prd()) {
-            v->periods_at_high_act = 0;
+    if (!(block->flags[slot] & ViewCtrlValues::NOTIFICATION)) {
+        if (block->periods_at_high_act[slot] == get_act_ntf_prd()) {
+            block->periods_at_high_act[slot] = 0;
+            P<Code> object = block->views[slot]->object; // the notifications may evict the view (see account()).
             uint16_t ntf_grp_count = get_ntf_grp_count();
 
             for (uint16_t i = 1; i <= ntf_grp_count; ++i) {
-                _Mem::Get()->inject_notification(new NotificationView(this, get_ntf_grp(i), new MkHighAct(_Mem::Get(), v->object)), false);
+                _Mem::Get()->inject_notification(new NotificationView(this, get_ntf_grp(i), new MkHighAct(_Mem::Get(), object)), false);
             }
-        } else if (v->periods_at_low_act == get_act_ntf_prd()) {
-            v->periods_at_low_act = 0;
+        } else if (block->periods_at_low_act[slot] == get_act_ntf_prd()) {
+            block->periods_at_low_act[slot] = 0;
+            P<Code> object = block->views[slot]->object; // the notifications may evict the view (see account()).
             uint16_t ntf_grp_count = get_ntf_grp_count();
 
             for (uint16_t i = 1; i <= ntf_grp_count; ++i) {
-                _Mem::Get()->inject_notification(new NotificationView(this, get_ntf_grp(i), new MkLowAct(_Mem::Get(), v->object)), false);
+                _Mem::Get()->inject_notification(new NotificationView(this, get_ntf_grp(i), new MkLowAct(_Mem::Get(), object)), false);
             }
         }
     }
+}
+
+// As stored in an atom (see Atom::Float()): the thresholds are tested on the values the views will hold.
+static inline float AtomFloat(float f)
+{
+    uint32_t _f;
+    memcpy(&_f, &f, sizeof(_f));
+    _f &= ~1u;
+    memcpy(&f, &_f, sizeof(f));
+    return f;
+}
+
+// condition ? a : b, on the bits: a branch would have the compiler move the divisions under it, and stop vectorizing.
+static inline float Select(bool condition, float a, float b)
+{
+    uint32_t _a;
+    uint32_t _b;
+    memcpy(&_a, &a, sizeof(_a));
+    memcpy(&_b, &b, sizeof(_b));
+    uint32_t mask = -(uint32_t)condition;
+    _a = (_a & mask) | (_b & ~mask);
+    memcpy(&a, &_a, sizeof(a));
+    return a;
+}
+
+// All ones if condition, for the integer selections: as for Select(), a ternary would be a branch.
+static inline uint32_t Mask(bool condition)
+{
+    return -(uint32_t)condition;
+}
 
-    return act;
+// Each pass runs over whole blocks, free slots included, and writes only the slots in the update: the loops have no
+// control flow, so that they vectorize. The quotients are computed on a denominator of at least 1, then selected.
+// Infinite res (forever) stays infinite.
+// Each accumulator is reset as it is read: the changes made during the update (e.g. by the mdl controllers, without
+// the group lock) count for the next one.
+void Group::update_ctrl_values(uint64_t planned_time, float former_sln_thr)
+{
+    ViewCtrlValues &ctrl_values = view_index.get_ctrl_values();
+    float decay = (decay_periods_to_go > 0 && sln_decay != 0) ? sln_decay : 0; // as if mod_sln(sln*sln_decay).
+    float decay_change = decay != 0 ? 1 : 0;
+    float low_res_thr = get_low_res_thr();
+    float low_sln_thr = get_low_sln_thr();
+    float high_sln_thr = get_high_sln_thr();
+    float sln_thr = get_sln_thr();
+    float low_act_thr = get_low_act_thr();
+    float high_act_thr = get_high_act_thr();
+    float act_thr = get_act_thr();
+
+    for (size_t b = 0; b < ctrl_values.get_block_count(); ++b) {
+        ViewCtrlValues::Block *block = ctrl_values.get_block(b);
+        uint32_t *crossings = block->crossings;
+
+        for (size_t i = 0; i < ViewCtrlValues::BlockSize; ++i) {
+            if (block->views[i] && block->invalidated[i].load(std::memory_order_relaxed)) { // no need to update the view set.
+                delete_view(block->views[i]);
+            }
+
+            // in case the update happens later than planned, don't touch views that were injected after the planned update time: update next time.
+            crossings[i] = (block->views[i] && block->ijt[i] < planned_time) ? ViewCtrlValues::UPDATED : 0;
+        }
+
+        float *res = block->res;
+        float *res_acc = block->res_acc;
+        float *res_changes = block->res_changes;
+
+        for (size_t i = 0; i < ViewCtrlValues::BlockSize; ++i) { // decrement by one on behalf of the group, in addition to the accumulated changes.
+            bool updated = crossings[i] & ViewCtrlValues::UPDATED;
+            float change = res_acc[i] / Select(res_changes[i] > 1, res_changes[i], 1);
+            float new_res = res[i] + Select(res_changes[i] > 0, change, 0) - 1;
+            res[i] = Select(updated, AtomFloat(new_res < 0 ? 0 : new_res), res[i]);
+            res_acc[i] = Select(updated, 0, res_acc[i]);
+            res_changes[i] = Select(updated, 0, res_changes[i]);
+        }
+
+        float *sln = block->sln;
+        float *former_sln = block->former_sln;
+        float *sln_acc = block->sln_acc;
+        float *sln_changes = block->sln_changes;
+
+        for (size_t i = 0; i < ViewCtrlValues::BlockSize; ++i) {
+            bool updated = crossings[i] & ViewCtrlValues::UPDATED;
+            float acc = sln_acc[i] + sln[i] * decay;
+            float changes = sln_changes[i] + decay_change;
+            float change = acc / Select(changes > 1, changes, 1);
+            float value = Select((changes > 0) & (acc != 0), sln[i] + change, sln[i]);
+            former_sln[i] = Select(updated, sln[i], former_sln[i]);
+            sln[i] = Select(updated, AtomFloat(value < 0 ? 0 : (value > 1 ? 1 : value)), sln[i]);
+            sln_acc[i] = Select(updated, 0, sln_acc[i]);
+            sln_changes[i] = Select(updated, 0, sln_changes[i]);
+        }
+
+        float *act = block->act;
+        float *former_act = block->former_act;
+        float *act_acc = block->act_acc;
+        float *act_changes = block->act_changes;
+        const uint32_t *flags = block->flags;
+
+        for (size_t i = 0; i < ViewCtrlValues::BlockSize; ++i) {
+            bool updated = (crossings[i] & ViewCtrlValues::UPDATED) & ((flags[i] & ViewCtrlValues::HAS_ACT) != 0);
+            float change = act_acc[i] / Select(act_changes[i] > 1, act_changes[i], 1);
+            float value = Select((act_changes[i] > 0) & (act_acc[i] != 0), act[i] + change, act[i]);
+            former_act[i] = Select(updated, act[i], former_act[i]);
+            act[i] = Select(updated, AtomFloat(value < 0 ? 0 : (value > 1 ? 1 : value)), act[i]);
+            act_acc[i] = Select(updated, 0, act_acc[i]);
+            act_changes[i] = Select(updated, 0, act_changes[i]);
+        }
+
+        // threshold crossings, acted upon in Group::update().
+        for (size_t i = 0; i < ViewCtrlValues::BlockSize; ++i) {
+            uint32_t sln_crossings = (ViewCtrlValues::LOW_RES & Mask((res[i] > 0) & (res[i] < low_res_thr))) |
+                                     (ViewCtrlValues::LOW_SLN & Mask(sln[i] < low_sln_thr)) |
+                                     (ViewCtrlValues::HIGH_SLN & Mask(sln[i] > high_sln_thr)) |
+                                     (ViewCtrlValues::WAS_SALIENT & Mask(former_sln[i] > former_sln_thr)) |
+                                     (ViewCtrlValues::IS_SALIENT & Mask(sln[i] > sln_thr));
+            uint32_t act_crossings = (ViewCtrlValues::LOW_ACT & Mask(act[i] < low_act_thr)) |
+                                     (ViewCtrlValues::HIGH_ACT & Mask(act[i] > high_act_thr)) |
+                                     (ViewCtrlValues::WAS_ACTIVE & Mask(former_act[i] > act_thr)) |
+                                     (ViewCtrlValues::IS_ACTIVE & Mask(act[i] > act_thr));
+            crossings[i] = (ViewCtrlValues::UPDATED | sln_crossings | (act_crossings & Mask(flags[i] & ViewCtrlValues::HAS_ACT))) & Mask(crossings[i] & ViewCtrlValues::UPDATED);
+        }
+
+        uint32_t *periods_at_low_sln = block->periods_at_low_sln;
+        uint32_t *periods_at_high_sln = block->periods_at_high_sln;
+        uint32_t *periods_at_low_act = block->periods_at_low_act;
+        uint32_t *periods_at_high_act = block->periods_at_high_act;
+
+        for (size_t i = 0; i < ViewCtrlValues::BlockSize; ++i) { // periods spent below the low thresholds, or else above the high ones.
+            uint32_t updated = Mask(crossings[i] & ViewCtrlValues::UPDATED);
+            uint32_t low_sln = Mask(crossings[i] & ViewCtrlValues::LOW_SLN);
+            uint32_t high_sln = Mask(crossings[i] & ViewCtrlValues::HIGH_SLN);
+            uint32_t low_act = Mask(crossings[i] & ViewCtrlValues::LOW_ACT);
+            uint32_t high_act = Mask(crossings[i] & ViewCtrlValues::HIGH_ACT);
+            periods_at_low_sln[i] = (updated & low_sln & (periods_at_low_sln[i] + 1)) | (~updated & periods_at_low_sln[i]);
+            periods_at_high_sln[i] = (updated & ~low_sln & high_sln & (periods_at_high_sln[i] + 1)) | (~(updated & ~low_sln) & periods_at_high_sln[i]);
+            periods_at_low_act[i] = (updated & low_act & (periods_at_low_act[i] + 1)) | (~updated & periods_at_low_act[i]);
+            periods_at_high_act[i] = (updated & ~low_act & high_act & (periods_at_high_act[i] + 1)) | (~(updated & ~low_act) & periods_at_high_act[i]);
+        }
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -969,7 +1125,7 @@ bool Group::load(View *view, Code *object)
 {
     switch (object->code(0).getDescriptor()) {
     case Atom::GROUP: {
-        group_views[view->get_oid()] = view;
+        view_index.insert(ViewIndex::GROUP, view);
         // init viewing_group.
         bool viewing_c_active = get_c_act() > get_c_act_thr();
         bool viewing_c_salient = get_c_sln() > get_c_sln_thr();
@@ -983,9 +1139,9 @@ bool Group::load(View *view, Code *object)
     }
 
     case Atom::INSTANTIATED_PROGRAM: {
-        ipgm_views[view->get_oid()] = view;
         PGMController *c = new PGMController(view); // now will be added to the deadline at start time.
         view->controller = c;
+        view_index.insert(ViewIndex::IPGM, view);
 
         if (is_active_pgm(view)) {
             c->gain_activation();
@@ -995,7 +1151,7 @@ bool Group::load(View *view, Code *object)
     }
 
     case Atom::INSTANTIATED_INPUT_LESS_PROGRAM: {
-        input_less_ipgm_views[view->get_oid()] = view;
+        view_index.insert(ViewIndex::INPUT_LESS_IPGM, view);
         InputLessPGMController *c = new InputLessPGMController(view); // now will be added to the deadline at start time.
         view->controller = c;
 
@@ -1007,9 +1163,9 @@ bool Group::load(View *view, Code *object)
     }
 
     case Atom::INSTANTIATED_ANTI_PROGRAM: {
-        anti_ipgm_views[view->get_oid()] = view;
         AntiPGMController *c = new AntiPGMController(view); // now will be added to the deadline at start time.
         view->controller = c;
+        view_index.insert(ViewIndex::ANTI_IPGM, view);
 
         if (is_active_pgm(view)) {
             c->gain_activation();
@@ -1019,7 +1175,6 @@ bool Group::load(View *view, Code *object)
     }
 
     case Atom::INSTANTIATED_CPP_PROGRAM: {
-        ipgm_views[view->get_oid()] = view;
         std::string str = Utils::GetString<Code>(view->object, ICPP_PGM_NAME);
 
         LOG_DEBUG << "Loading ICCP_PGM_NME" << str;
@@ -1030,6 +1185,7 @@ bool Group::load(View *view, Code *object)
         }
 
         view->controller = c;
+        view_index.insert(ViewIndex::IPGM, view);
 
         if (is_active_pgm(view)) {
             c->gain_activation();
@@ -1039,9 +1195,9 @@ bool Group::load(View *view, Code *object)
     }
 
     case Atom::COMPOSITE_STATE: {
-        ipgm_views[view->get_oid()] = view;
         CSTController *c = new CSTController(view);
         view->controller = c;
+        view_index.insert(ViewIndex::IPGM, view);
         c->set_secondary_host(get_secondary_group());
 
         if (is_active_pgm(view)) {
@@ -1052,10 +1208,10 @@ bool Group::load(View *view, Code *object)
     }
 
     case Atom::MODEL: {
-        ipgm_views[view->get_oid()] = view;
         bool inject_in_secondary_group;
         MDLController *c = MDLController::New(view, inject_in_secondary_group);
         view->controller = c;
+        view_index.insert(ViewIndex::IPGM, view);
 
         if (inject_in_secondary_group) {
             get_secondary_group()->load_secondary_mdl_controller(view);
@@ -1073,11 +1229,11 @@ bool Group::load(View *view, Code *object)
             object->get_reference(i)->markers.push_back(object);
         }
 
-        other_views[view->get_oid()] = view;
+        view_index.insert(ViewIndex::OTHER, view);
         break;
 
     case Atom::OBJECT:
-        other_views[view->get_oid()] = view;
+        view_index.insert(ViewIndex::OTHER, view);
         break;
     }
 
@@ -1094,6 +1250,15 @@ void Group::update(uint64_t planned_time)
     }
 
     uint64_t now = Now();
+    // memory budgets: the pressure is that of the last update and of the injections since (see account()).
+    uint64_t soft_budget;
+    uint64_t hard_budget;
+    _Mem::Get()->get_memory_budgets(footprint, soft_budget, hard_budget);
+    double res_factor = (soft_budget > 0 && footprint > soft_budget) ? (double)soft_budget / footprint : 1; // for the evictable views that are not salient.
+    uint64_t new_footprint = 0;
+    std::vector<uint32_t> eviction_candidates; // slots.
+    ViewCtrlValues &ctrl_values = view_index.get_ctrl_values();
+    ctrl_values.recycle(); // the readers of the views deleted before the last update are done.
     //if(get_secondary_group()!=NULL)
     // LOG_DEBUG<<Utils::Timestamp(Now())<<" UPR";
     //if(this==_Mem::Get()->get_stdin())
@@ -1113,47 +1278,79 @@ void Group::update(uint64_t planned_time)
     update_vis_thr();
     GroupState state(get_sln_thr(), get_c_act() > get_c_act_thr(), update_c_act() > get_c_act_thr(), get_c_sln() > get_c_sln_thr(), update_c_sln() > get_c_sln_thr());
     reset_stats();
-    FOR_ALL_VIEWS_BEGIN_NO_INC(this, v)
+    update_ctrl_values(planned_time, state.former_sln_thr);
 
-    if (v->second->object->is_invalidated()) { // no need to update the view set.
-        delete_view(v);
-    } else {
-        uint64_t ijt = v->second->get_ijt();
+    for (size_t b = 0; b < ctrl_values.get_block_count(); ++b) { // act upon threshold crossings: the views are touched only then.
+        ViewCtrlValues::Block *block = ctrl_values.get_block(b);
 
-        if (ijt >= planned_time) { // in case the update happens later than planned, don't touch views that were injected after the planned update time: update next time.
-            ++v;
-            continue;
-        }
+        for (size_t i = 0; i < ViewCtrlValues::BlockSize; ++i) {
+            View *v = block->views[i];
+            uint32_t crossings = block->crossings[i];
+
+            if (!v || !(crossings & ViewCtrlValues::UPDATED)) { // free, injected since the planned time, or evicted on injection.
+                continue;
+            }
 
-        double res = update_res(v->second); // update resilience: decrement res by 1 in addition to the accumulated changes.
+            float res = block->res[i];
 
-        if (res > 0) {
-            _update_saliency(&state, v->second); // apply decay.
+            if (!(res > 0)) { // view has no resilience: delete it from the group.
+                v->delete_from_object();
+                delete_view(v);
+                continue;
+            }
 
-            switch (v->second->object->code(0).getDescriptor()) {
-            case Atom::GROUP:
-                _update_visibility(&state, v->second);
-                break;
+            update_res(block, i);
+            update_sln(block, i);
 
-            case Atom::NULL_PROGRAM:
-            case Atom::INSTANTIATED_PROGRAM:
-            case Atom::INSTANTIATED_ANTI_PROGRAM:
-            case Atom::INSTANTIATED_INPUT_LESS_PROGRAM:
-            case Atom::INSTANTIATED_CPP_PROGRAM:
-            case Atom::COMPOSITE_STATE:
-            case Atom::MODEL:
-                _update_activation(&state, v->second);
-                break;
+            if (!block->views[i]) { // evicted by the notifications.
+                continue;
             }
 
-            ++v;
-        } else { // view has no resilience: delete it from the group.
-            v->second->delete_from_object();
-            delete_view(v);
+            double old_sln = block->former_sln[i];
+            double sln = block->sln[i];
+            bool sync_on_front = (crossings & ViewCtrlValues::IS_SALIENT) && ((block->flags[i] & ViewCtrlValues::SYNC_ON_STATE) || !(crossings & ViewCtrlValues::WAS_SALIENT));
+
+            if (state.is_c_salient && (sync_on_front || (state.is_c_active && sln != old_sln))) {
+                _update_saliency(&state, v, old_sln, sln, crossings);
+            }
+
+            if (block->flags[i] & ViewCtrlValues::HAS_ACT) {
+                update_act(block, i);
+                bool was_on = state.was_c_active && state.was_c_salient;
+                bool is_on = state.is_c_active && state.is_c_salient;
+                bool was_active = crossings & ViewCtrlValues::WAS_ACTIVE;
+                bool is_active = crossings & ViewCtrlValues::IS_ACTIVE;
+
+                if (was_on ? (!is_on || was_active != is_active) : (is_on && is_active)) {
+                    _update_activation(&state, v, crossings);
+                }
+            } else if (block->flags[i] & ViewCtrlValues::GROUP_VIEW) {
+                _update_visibility(&state, v);
+            }
+
+            new_footprint += block->footprint[i];
+
+            if ((block->flags[i] & ViewCtrlValues::EVICTABLE) && res != std::numeric_limits<float>::infinity()) {
+                if (res_factor < 1 && !(crossings & ViewCtrlValues::IS_SALIENT)) { // not salient: decays faster.
+                    block->res[i] = AtomFloat(res * res_factor);
+                }
+
+                if (hard_budget > 0) { // the least salient go first.
+                    eviction_candidates.push_back((uint32_t)(b * ViewCtrlValues::BlockSize + i));
+                }
+            }
         }
     }
 
-    FOR_ALL_VIEWS_END
+    uint64_t evicted_view_count = 0;
+
+    if (hard_budget > 0 && new_footprint > hard_budget) {
+        evicted_view_count = eviction_candidates.size();
+        evict(eviction_candidates, hard_budget, new_footprint);
+        evicted_view_count -= eviction_candidates.size();
+    }
+
+    _Mem::Get()->report_footprint((int64_t)new_footprint - (int64_t)footprint.exchange(new_footprint), evicted_view_count);
 
     if (state.is_c_salient) {
         cov();
@@ -1170,14 +1367,12 @@ void Group::update(uint64_t planned_time)
         for (Controller *new_controller : new_controllers) {
             switch (new_controller->getObject()->code(0).getDescriptor()) {
             case Atom::INSTANTIATED_ANTI_PROGRAM: { // inject signaling jobs for |ipgm (tsc).
-                P<TimeJob> j = new AntiPGMSignalingJob(new_controller->getView(), now + Utils::GetTimestamp<Code>(new_controller->getObject(), IPGM_TSC));
-                _Mem::Get()->pushTimeJob(j);
+                ((_PGMController *)new_controller)->push_signaling_job(new AntiPGMSignalingJob(new_controller->getView(), now + Utils::GetTimestamp<Code>(new_controller->getObject(), IPGM_TSC)));
                 break;
             }
 
             case Atom::INSTANTIATED_INPUT_LESS_PROGRAM: { // inject a signaling job for an input-less pgm.
-                P<TimeJob> j = new InputLessPGMSignalingJob(new_controller->getView(), now + Utils::GetTimestamp<Code>(new_controller->getObject(), IPGM_TSC));
-                _Mem::Get()->pushTimeJob(j);
+                ((_PGMController *)new_controller)->push_signaling_job(new InputLessPGMSignalingJob(new_controller->getView(), now + Utils::GetTimestamp<Code>(new_controller->getObject(), IPGM_TSC)));
                 break;
             }
             }
@@ -1189,7 +1384,7 @@ void Group::update(uint64_t planned_time)
     update_stats(); // triggers notifications.
 
     if (get_upr() > 0) { // inject the next update job for the group.
-        _Mem::Get()->pushTimeJob(new UpdateJob(this, planned_time + get_upr()*Utils::GetBasePeriod()));
+        push_update_job(planned_time + get_upr() * Utils::GetBasePeriod());
     }
 
     //if(get_secondary_group()!=NULL)
@@ -1197,12 +1392,10 @@ void Group::update(uint64_t planned_time)
     // LOG_DEBUG<<Utils::Timestamp(Now())<<" ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++";
 }
 
-void Group::_update_saliency(GroupState *state, View *view)
+void Group::_update_saliency(GroupState *state, View *view, double view_old_sln, double view_new_sln, uint32_t crossings)
 {
-    double view_old_sln = view->get_sln();
-    bool wiew_was_salient = view_old_sln > state->former_sln_thr;
-    double view_new_sln = update_sln(view);
-    bool wiew_is_salient = view_new_sln > get_sln_thr();
+    bool wiew_was_salient = crossings & ViewCtrlValues::WAS_SALIENT;
+    bool wiew_is_salient = crossings & ViewCtrlValues::IS_SALIENT;
 
     if (state->is_c_salient) {
         if (wiew_is_salient) {
@@ -1265,10 +1458,10 @@ void Group::_update_visibility(GroupState *state, View *view)
     }
 }
 
-void Group::_update_activation(GroupState *state, View *view)
+void Group::_update_activation(GroupState *state, View *view, uint32_t crossings)
 {
-    bool view_was_active = view->get_act() > get_act_thr();
-    bool view_is_active = update_act(view) > get_act_thr();
+    bool view_was_active = crossings & ViewCtrlValues::WAS_ACTIVE;
+    bool view_is_active = crossings & ViewCtrlValues::IS_ACTIVE;
 
     // kill newly inactive controllers, register newly active ones.
     if (state->was_c_active && state->was_c_salient) {
@@ -1310,7 +1503,7 @@ void Group::_initiate_sln_propagation(Code *object, double change, double source
 
         // propagate to markers
         object->acq_markers();
-        r_code::list<Code *>::const_iterator m;
+        Code::MarkerList::const_iterator m;
 
         for (m = object->markers.begin(); m != object->markers.end(); ++m) {
             _propagate_sln(*m, change, source_sln_thr, path);
@@ -1339,7 +1532,7 @@ void Group::_initiate_sln_propagation(Code *object, double change, double source
 
         // propagate to markers
         object->acq_markers();
-        r_code::list<Code *>::const_iterator m;
+        Code::MarkerList::const_iterator m;
 
         for (m = object->markers.begin(); m != object->markers.end(); ++m) {
             _propagate_sln(*m, change, source_sln_thr, path);
@@ -1381,19 +1574,19 @@ void Group::inject_hlps(std::vector<View *> &views)
         switch (a.getDescriptor()) {
         case Atom::COMPOSITE_STATE: {
             LOG_DEBUG << "group inject hlp " << Utils::Timestamp(Now()) << " -> cst " << (*view)->object->get_oid();
-            ipgm_views[(*view)->get_oid()] = *view;
             CSTController *c = new CSTController(*view);
             (*view)->controller = c;
+            view_index.insert(ViewIndex::IPGM, *view);
             c->set_secondary_host(get_secondary_group());
             break;
         }
 
         case Atom::MODEL: {
             LOG_DEBUG << "group inject hlp " << Utils::Timestamp(Now()) << " -> mdl " << (*view)->object->get_oid();
-            ipgm_views[(*view)->get_oid()] = *view;
             bool inject_in_secondary_group;
             MDLController *c = MDLController::New(*view, inject_in_secondary_group);
             (*view)->controller = c;
+            view_index.insert(ViewIndex::IPGM, *view);
 
             if (inject_in_secondary_group) {
                 get_secondary_group()->inject_secondary_mdl_controller(*view);
@@ -1427,7 +1620,7 @@ void Group::inject(View *view)
 
     switch (a.getDescriptor()) {
     case Atom::NULL_PROGRAM: // the view comes with a controller.
-        ipgm_views[view->get_oid()] = view;
+        view_index.insert(ViewIndex::IPGM, view);
 
         if (is_active_pgm(view)) {
             view->controller->gain_activation();
@@ -1444,9 +1637,9 @@ void Group::inject(View *view)
         break;
 
     case Atom::INSTANTIATED_PROGRAM: {
-        ipgm_views[view->get_oid()] = view;
         PGMController *c = new PGMController(view);
         view->controller = c;
+        view_index.insert(ViewIndex::IPGM, view);
 
         if (is_active_pgm(view)) {
             c->gain_activation();
@@ -1461,7 +1654,6 @@ void Group::inject(View *view)
     }
 
     case Atom::INSTANTIATED_CPP_PROGRAM: {
-        ipgm_views[view->get_oid()] = view;
         std::string str = Utils::GetString<Code>(view->object, ICPP_PGM_NAME);
         Controller *c = CPPPrograms::New(str, view);
 
@@ -1470,6 +1662,7 @@ void Group::inject(View *view)
         }
 
         view->controller = c;
+        view_index.insert(ViewIndex::IPGM, view);
 
         if (is_active_pgm(view)) {
             c->gain_activation();
@@ -1484,9 +1677,9 @@ void Group::inject(View *view)
     }
 
     case Atom::INSTANTIATED_ANTI_PROGRAM: {
-        anti_ipgm_views[view->get_oid()] = view;
         AntiPGMController *c = new AntiPGMController(view);
         view->controller = c;
+        view_index.insert(ViewIndex::ANTI_IPGM, view);
 
         if (is_active_pgm(view)) {
             c->gain_activation();
@@ -1496,40 +1689,40 @@ void Group::inject(View *view)
                 c->_take_input(*v);    // view will be copied.
             }
 
-            _Mem::Get()->pushTimeJob(new AntiPGMSignalingJob(view, now + Utils::GetTimestamp<Code>(c->getObject(), IPGM_TSC)));
+            c->push_signaling_job(new AntiPGMSignalingJob(view, now + Utils::GetTimestamp<Code>(c->getObject(), IPGM_TSC)));
         }
 
         break;
     }
 
     case Atom::INSTANTIATED_INPUT_LESS_PROGRAM: {
-        input_less_ipgm_views[view->get_oid()] = view;
+        view_index.insert(ViewIndex::INPUT_LESS_IPGM, view);
         InputLessPGMController *c = new InputLessPGMController(view);
         view->controller = c;
 
         if (is_active_pgm(view)) {
             c->gain_activation();
-            _Mem::Get()->pushTimeJob(new InputLessPGMSignalingJob(view, now + Utils::GetTimestamp<Code>(view->object, IPGM_TSC)));
+            c->push_signaling_job(new InputLessPGMSignalingJob(view, now + Utils::GetTimestamp<Code>(view->object, IPGM_TSC)));
         }
 
         break;
     }
 
     case Atom::MARKER: // the marker has already been added to the mks of its references.
-        other_views[view->get_oid()] = view;
+        view_index.insert(ViewIndex::OTHER, view);
         cov(view);
         break;
 
     case Atom::OBJECT:
-        other_views[view->get_oid()] = view;
+        view_index.insert(ViewIndex::OTHER, view);
         cov(view);
         break;
 
     case Atom::COMPOSITE_STATE: {
         LOG_TRACE << Utils::Timestamp(Now()) << " cst " << view->object->get_oid() << " injected";
-        ipgm_views[view->get_oid()] = view;
         CSTController *c = new CSTController(view);
         view->controller = c;
+        view_index.insert(ViewIndex::IPGM, view);
         c->set_secondary_host(get_secondary_group());
 
         if (is_active_pgm(view)) {
@@ -1546,10 +1739,10 @@ void Group::inject(View *view)
 
     case Atom::MODEL: {
         LOG_TRACE << Utils::Timestamp(Now()) << " mdl " << view->object->get_oid() << " injected";
-        ipgm_views[view->get_oid()] = view;
         bool inject_in_secondary_group;
         MDLController *c = MDLController::New(view, inject_in_secondary_group);
         view->controller = c;
+        view_index.insert(ViewIndex::IPGM, view);
 
         if (inject_in_secondary_group) {
             get_secondary_group()->inject_secondary_mdl_controller(view);
@@ -1573,6 +1766,7 @@ void Group::inject(View *view)
         inject_reduction_jobs(view);
     }
 
+    account(view);
     //if(get_oid()==2)
     // LOG_DEBUG<<Utils::Timestamp(Now())<<" stdin <- "<<view->object->get_oid()<<std::endl;
 }
@@ -1628,7 +1822,7 @@ void Group::inject_existing_object(View *view)   // the view can hold anything b
             break;
         }
 
-        existing_view->code(VIEW_SYNC) = view->code(VIEW_SYNC);
+        existing_view->set_sync(view->get_sync());
         existing_view->set_ijt(Now());
         bool wiew_is_salient = view->get_sln() > get_sln_thr();
         bool wiew_was_salient = existing_view->get_sln() > get_sln_thr();
@@ -1647,7 +1841,7 @@ void Group::inject_existing_object(View *view)   // the view can hold anything b
 void Group::inject_group(View *view)
 {
     std::lock_guard<std::mutex> guard(mutex);
-    group_views[view->get_oid()] = view;
+    view_index.insert(ViewIndex::GROUP, view);
 
     if (get_c_sln() > get_c_sln_thr() && view->get_sln() > get_sln_thr()) { // group is c-salient and view is salient.
         if (view->get_vis() > get_vis_thr()) { // new visible group in a c-active and c-salient host.
@@ -1658,7 +1852,7 @@ void Group::inject_group(View *view)
     }
 
     if (((Group *)view->object)->get_upr() > 0) { // inject the next update job for the group.
-        _Mem::Get()->pushTimeJob(new UpdateJob((Group *)view->object, ((Group *)view->object)->get_next_upr_time(Now())));
+        ((Group *)view->object)->push_update_job(((Group *)view->object)->get_next_upr_time(Now()));
     }
 
     notifyNew(view);
@@ -1670,7 +1864,7 @@ void Group::inject_notification(View *view, bool lock)
         mutex.lock();
     }
 
-    notification_views[view->get_oid()] = view;
+    view_index.insert(ViewIndex::NOTIFICATION, view);
 
     for (uint64_t i = 0; i < view->object->references_size(); ++i) {
         Code *ref = view->object->get_reference(i);
@@ -1685,6 +1879,8 @@ void Group::inject_notification(View *view, bool lock)
         inject_reduction_jobs(view);
     }
 
+    account(view);
+
     if (lock) {
         mutex.unlock();
     }
@@ -1693,15 +1889,12 @@ void Group::inject_notification(View *view, bool lock)
 void Group::inject_reduction_jobs(View *view)
 {
     if (get_c_act() > get_c_act_thr()) { // host is c-active.
-        // build reduction jobs from host's own inputs and own overlays.
-        FOR_ALL_VIEWS_WITH_INPUTS_BEGIN(this, v)
-
-        if (v->second->get_act() > get_act_thr()) { //{ // active ipgm/icpp_pgm/rgrp view.
-            v->second->controller->_take_input(view);    // view will be copied.
-        }
-
-        //LOG_DEBUG<<std::hex<<(void *)v->second->controller<<std::dec<<" <- "<<view->object->get_oid()<<std::endl;}
-        FOR_ALL_VIEWS_WITH_INPUTS_END
+        // build reduction jobs from host's own inputs and own overlays: only the controllers that may take the input.
+        view_index.for_each_consumer(view->object, [this, view](View *v) {
+            if (v->get_act() > get_act_thr()) { // active ipgm/icpp_pgm/rgrp view.
+                v->controller->_take_input(view);    // view will be copied.
+            }
+        });
     }
 
     // build reduction jobs from host's own inputs and overlays from viewing groups, if no cov and view is not a notification.
@@ -1714,13 +1907,12 @@ void Group::inject_reduction_jobs(View *view)
             continue;
         }
 
-        FOR_ALL_VIEWS_WITH_INPUTS_BEGIN(vg->first, v)
-
-        if (v->second->get_act() > vg->first->get_act_thr()) { // active ipgm/icpp_pgm/rgrp view.
-            v->second->controller->_take_input(view);    // view will be copied.
-        }
-
-        FOR_ALL_VIEWS_WITH_INPUTS_END
+        Group *viewing_group = vg->first;
+        viewing_group->view_index.for_each_consumer(view->object, [viewing_group, view](View *v) {
+            if (v->get_act() > viewing_group->get_act_thr()) { // active ipgm/icpp_pgm/rgrp view.
+                v->controller->_take_input(view);    // view will be copied.
+            }
+        });
     }
 }
 
@@ -1783,72 +1975,13 @@ void Group::cov()
 
 void Group::delete_view(View *v)
 {
-    if (v->isNotification()) {
-        notification_views.erase(v->get_oid());
-    } else switch (v->object->code(0).getDescriptor()) {
-        case Atom::NULL_PROGRAM:
-        case Atom::INSTANTIATED_PROGRAM:
-        case Atom::INSTANTIATED_CPP_PROGRAM:
-        case Atom::COMPOSITE_STATE:
-        case Atom::MODEL:
-            ipgm_views.erase(v->get_oid());
-            break;
-
-        case Atom::INSTANTIATED_ANTI_PROGRAM:
-            anti_ipgm_views.erase(v->get_oid());
-            break;
-
-        case Atom::INSTANTIATED_INPUT_LESS_PROGRAM:
-            input_less_ipgm_views.erase(v->get_oid());
-            break;
-
-        case Atom::OBJECT:
-        case Atom::MARKER:
-            other_views.erase(v->get_oid());
-            break;
-
-        case Atom::GROUP:
-            group_views.erase(v->get_oid());
-            break;
-        }
-}
-
-void Group::delete_view(std::unordered_map<uint64_t, P<View> >::const_iterator &v)
-{
-    if (v->second->isNotification()) {
-        v = notification_views.erase(v);
-    } else switch (v->second->object->code(0).getDescriptor()) {
-        case Atom::NULL_PROGRAM:
-        case Atom::INSTANTIATED_PROGRAM:
-        case Atom::INSTANTIATED_CPP_PROGRAM:
-        case Atom::COMPOSITE_STATE:
-        case Atom::MODEL:
-            v = ipgm_views.erase(v);
-            break;
-
-        case Atom::INSTANTIATED_ANTI_PROGRAM:
-            v = anti_ipgm_views.erase(v);
-            break;
-
-        case Atom::INSTANTIATED_INPUT_LESS_PROGRAM:
-            v = input_less_ipgm_views.erase(v);
-            break;
-
-        case Atom::OBJECT:
-        case Atom::MARKER:
-            v = other_views.erase(v);
-            break;
-
-        case Atom::GROUP:
-            v = group_views.erase(v);
-            break;
-        }
+    view_index.erase(v->get_oid());
 }
 
 Group *Group::get_secondary_group()
 {
     Group *secondary = nullptr;
-    r_code::list<Code *>::const_iterator m;
+    Code::MarkerList::const_iterator m;
     acq_markers();
 
     for (m = markers.begin(); m != markers.end(); ++m) {
@@ -1870,9 +2003,9 @@ void Group::load_secondary_mdl_controller(View *view)
     View *_view = new View(view, true);
     _view->code(VIEW_ACT) = Atom::Float(0);
     _view->references[0] = this;
-    ipgm_views[_view->get_oid()] = _view;
     SecondaryMDLController *s = new SecondaryMDLController(_view);
     _view->controller = s;
+    view_index.insert(ViewIndex::IPGM, _view);
     view->object->views.insert(_view);
     p->set_secondary(s);
     s->set_primary(p);
@@ -1884,9 +2017,9 @@ void Group::inject_secondary_mdl_controller(View *view)
     View *_view = new View(view, true);
     _view->code(VIEW_ACT) = Atom::Float(0);
     _view->references[0] = this;
-    ipgm_views[_view->get_oid()] = _view;
     SecondaryMDLController *s = new SecondaryMDLController(_view);
     _view->controller = s;
+    view_index.insert(ViewIndex::IPGM, _view);
     view->object->views.insert(_view);
     p->set_secondary(s);
     s->set_primary(p);
@@ -1917,4 +2050,11 @@ uint64_t Group::get_prev_upr_time(uint64_t now) const
     uint64_t delta = (now - Utils::GetTimeReference()) % _upr;
     return now - delta;
 }
+
+void Group::push_update_job(uint64_t time)
+{
+    if (!is_invalidated()) {
+        _Mem::Get()->schedule_group_update(this, time);
+    }
+}
 }
@@ -34,8 +34,10 @@
 #include <r_code/object.h>     // for View, View::Less
 #include <r_exec/object.h>     // for LObject
 #include <r_exec/view.h>       // for View
+#include <r_exec/view_index.h>  // for ViewIndex
 #include <stddef.h>            // for size_t, NULL
 #include <stdint.h>            // for uint64_t, uint16_t, uint8_t, int64_t, etc
+#include <atomic>              // for atomic
 #include <mutex>               // for mutex
 #include <set>                 // for multiset
 #include <unordered_map>       // for unordered_map, etc
@@ -46,6 +48,7 @@
 
 namespace r_exec {
 class Controller;
+class _Mem;
 }  // namespace r_exec
 
 namespace r_exec
@@ -74,6 +77,21 @@ private:
     double acc_c_sln_thr;
     uint64_t c_act_thr_changes;
     double acc_c_act_thr;
+
+    friend class _Mem;
+    uint64_t next_update_time; // in the mem's schedule of group updates; Utils::MaxTime if none; guarded by the mem.
+
+    int64_t node; // NUMA node the jobs for the group prefer (see CPUAffinity::HomeNode()); -1: any.
+
+    // Passes over the ctrl values of the views, held in parallel arrays by the view index (see ViewCtrlValues): they
+    // vectorize. Deletes the views of invalidated objects, decrements res by one, applies the accumulated changes and
+    // decay, finds the crossings.
+    void update_ctrl_values(uint64_t planned_time, float former_sln_thr);
+
+    std::atomic<uint64_t> footprint; // approximate bytes held by the views and their objects: recomputed on update, grown on injection.
+    void evict(std::vector<uint32_t> &candidates, uint64_t budget, uint64_t &new_footprint); // slots; lowest sln first, until under budget.
+    void account(View *view); // on injection, mutex locked: past the hard budget, evicts without waiting for the next update.
+
     void reset_ctrl_values();
 
     // Stats.
@@ -130,8 +148,8 @@ private:
                    bool is_c_salient): former_sln_thr(former_sln_thr), was_c_active(was_c_active), is_c_active(is_c_active), was_c_salient(was_c_salient), is_c_salient(is_c_salient) {}
     };
 
-    void _update_saliency(GroupState *state, View *view);
-    void _update_activation(GroupState *state, View *view);
+    void _update_saliency(GroupState *state, View *view, double old_sln, double new_sln, uint32_t crossings);
+    void _update_activation(GroupState *state, View *view, uint32_t crossings);
     void _update_visibility(GroupState *state, View *view);
 
     void _initiate_sln_propagation(Code *object, double change, double source_sln_thr) const;
@@ -139,14 +157,9 @@ private:
     void _propagate_sln(Code *object, double change, double source_sln_thr, std::vector<Code *> &path) const;
 public:
     std::mutex mutex;
-    // xxx_views are meant for erasing views with res==0. They are specialized by type to ease update operations.
-    // Active overlays are to be found in xxx_ipgm_views.
-    std::unordered_map<uint64_t, P<View> > ipgm_views;
-    std::unordered_map<uint64_t, P<View> > anti_ipgm_views;
-    std::unordered_map<uint64_t, P<View> > input_less_ipgm_views;
-    std::unordered_map<uint64_t, P<View> > notification_views;
-    std::unordered_map<uint64_t, P<View> > group_views;
-    std::unordered_map<uint64_t, P<View> > other_views;
+    // The views are indexed by kind, to ease update operations; active overlays are to be found in the views of the
+    // IPGM, ANTI_IPGM and INPUT_LESS_IPGM kinds.
+    ViewIndex view_index;
 
     // Defined to create reduction jobs in the viewing groups from the viewed group.
     // Empty when the viewed group is invisible (this means that visible groups can be non c-active or non c-salient).
@@ -218,132 +231,30 @@ public:
 
     bool invalidate(); // removes all views of itself and of any other object.
 
-    bool all_views_cond(uint8_t &selector, std::unordered_map<uint64_t, P<View> >::const_iterator &it, std::unordered_map<uint64_t, P<View> >::const_iterator &end)
-    {
-        while (it == end) {
-            switch (selector++) {
-            case 0:
-                it = anti_ipgm_views.begin();
-                end = anti_ipgm_views.end();
-                break;
-
-            case 1:
-                it = input_less_ipgm_views.begin();
-                end = input_less_ipgm_views.end();
-                break;
-
-            case 2:
-                it = notification_views.begin();
-                end = notification_views.end();
-                break;
-
-            case 3:
-                it = group_views.begin();
-                end = group_views.end();
-                break;
-
-            case 4:
-                it = other_views.begin();
-                end = other_views.end();
-                break;
-
-            case 5:
-                selector = 0;
-                return false;
-            }
-        }
+    // Iterate over the views of kinds [first,last) (see ViewIndex::Kind); the body may delete the current view.
+#define FOR_VIEWS_OF_KINDS_BEGIN(g,v,first,last) \
+        for (uint8_t kind_##v = first; kind_##v < last; ++kind_##v) \
+            for (size_t position_##v = g->view_index.size(kind_##v); position_##v-- > 0;) { \
+                View *v = g->view_index.at(kind_##v, position_##v);
 
-        return true;
-    }
-
-#define FOR_ALL_VIEWS_BEGIN(g,it) { \
-        uint8_t selector; \
-        std::unordered_map<uint64_t,P<View> >::const_iterator it=g->ipgm_views.begin(); \
-        std::unordered_map<uint64_t,P<View> >::const_iterator end=g->ipgm_views.end(); \
-        for(selector=0;g->all_views_cond(selector,it,end);++it){
+#define FOR_ALL_VIEWS_BEGIN(g,v) FOR_VIEWS_OF_KINDS_BEGIN(g,v,ViewIndex::IPGM,ViewIndex::KindCount)
+#define FOR_ALL_VIEWS_END }
 
-#define FOR_ALL_VIEWS_BEGIN_NO_INC(g,it) { \
-        uint8_t selector; \
-        std::unordered_map<uint64_t,P<View> >::const_iterator it=g->ipgm_views.begin(); \
-        std::unordered_map<uint64_t,P<View> >::const_iterator end=g->ipgm_views.end(); \
-        for(selector=0;g->all_views_cond(selector,it,end);){
-
-#define FOR_ALL_VIEWS_END } \
-}
-
-    bool views_with_inputs_cond(uint8_t &selector, std::unordered_map<uint64_t, P<View> >::const_iterator &it, std::unordered_map<uint64_t, P<View> >::const_iterator &end)
-    {
-        while (it == end) {
-            switch (selector++) {
-            case 0:
-                it = anti_ipgm_views.begin();
-                end = anti_ipgm_views.end();
-                break;
-
-            case 1:
-                selector = 0;
-                return false;
-            }
-        }
+#define FOR_ALL_VIEWS_WITH_INPUTS_BEGIN(g,v) FOR_VIEWS_OF_KINDS_BEGIN(g,v,ViewIndex::IPGM,ViewIndex::INPUT_LESS_IPGM)
+#define FOR_ALL_VIEWS_WITH_INPUTS_END }
 
-        return true;
-    }
+#define FOR_ALL_NON_NTF_VIEWS_BEGIN(g,v) FOR_VIEWS_OF_KINDS_BEGIN(g,v,ViewIndex::IPGM,ViewIndex::NOTIFICATION)
+#define FOR_ALL_NON_NTF_VIEWS_END }
 
-#define FOR_ALL_VIEWS_WITH_INPUTS_BEGIN(g,it) { \
-        uint8_t selector; \
-        std::unordered_map<uint64_t,P<View> >::const_iterator it=g->ipgm_views.begin(); \
-        std::unordered_map<uint64_t,P<View> >::const_iterator end=g->ipgm_views.end(); \
-        for(selector=0;g->views_with_inputs_cond(selector,it,end);++it){
+    View *get_view_for_object(uint64_t OID);
 
-#define FOR_ALL_VIEWS_WITH_INPUTS_END } \
-}
+    uint32_t get_upr() const;
 
-    bool non_ntf_views_cond(uint8_t &selector, std::unordered_map<uint64_t, P<View> >::const_iterator &it, std::unordered_map<uint64_t, P<View> >::const_iterator &end)
+    int64_t get_node() const
     {
-        while (it == end) {
-            switch (selector++) {
-            case 0:
-                it = anti_ipgm_views.begin();
-                end = anti_ipgm_views.end();
-                break;
-
-            case 1:
-                it = input_less_ipgm_views.begin();
-                end = input_less_ipgm_views.end();
-                break;
-
-            case 2:
-                it = group_views.begin();
-                end = group_views.end();
-                break;
-
-            case 3:
-                it = other_views.begin();
-                end = other_views.end();
-                break;
-
-            case 4:
-                selector = 0;
-                return false;
-            }
-        }
-
-        return true;
+        return node;
     }
 
-#define FOR_ALL_NON_NTF_VIEWS_BEGIN(g,it) { \
-        uint8_t selector; \
-        std::unordered_map<uint64_t,P<View> >::const_iterator it=g->ipgm_views.begin(); \
-        std::unordered_map<uint64_t,P<View> >::const_iterator end=g->ipgm_views.end(); \
-        for(selector=0;g->non_ntf_views_cond(selector,it,end);++it){
-
-#define FOR_ALL_NON_NTF_VIEWS_END } \
-}
-
-    View *get_view_for_object(uint64_t OID);
-
-    uint32_t get_upr() const;
-
     float get_sln_thr() const;
     float get_act_thr() const;
     float get_vis_thr() const;
@@ -402,10 +313,10 @@ public:
     uint16_t get_ntf_grp_count();
     Group *get_ntf_grp(uint16_t i); // i starts at 1.
 
-    // Delegate to views; update stats and notifies.
-    double update_res(View *v);
-    double update_sln(View *v); // applies decay if any.
-    double update_act(View *v);
+    // Update stats and notify, once the view in the slot is updated (see update_ctrl_values()).
+    void update_res(ViewCtrlValues::Block *block, size_t slot);
+    void update_sln(ViewCtrlValues::Block *block, size_t slot);
+    void update_act(ViewCtrlValues::Block *block, size_t slot);
 
     // Target upr, spr, c_sln, c_act, sln_thr, act_thr, vis_thr, c_sln_thr, c_act_thr, sln_chg_thr,
     // sln_chg_prd, act_chg_thr, act_chg_prd, high_sln_thr, low_sln_thr, sln_ntf_prd, high_act_thr, low_act_thr, act_ntf_prd, low_res_thr, res_ntf_prd, ntf_new,
@@ -460,7 +371,6 @@ public:
     };
 
     void delete_view(View *v);
-    void delete_view(std::unordered_map<uint64_t, P<View> >::const_iterator &v);
 
     Group *get_secondary_group();
     void load_secondary_mdl_controller(View *view);
@@ -468,6 +378,7 @@ public:
 
     uint64_t get_next_upr_time(uint64_t now) const;
     uint64_t get_prev_upr_time(uint64_t now) const;
+    void push_update_job(uint64_t time); // schedules the next update of the group (see UpdateTickJob); an earlier one prevails.
 };
 }
 
@@ -30,14 +30,15 @@
 
 #include "hlp_context.h"
 
-#include <r_code/object.h>       // for Code
-#include <r_code/vector.h>       // for vector
-#include <r_exec/binding_map.h>  // for HLPBindingMap
-#include <r_exec/hlp_context.h>  // for HLPContext
-#include <r_exec/operator.h>     // for Operator, Context
-#include <r_exec/overlay.h>      // for Overlay
+#include <r_code/object.h>        // for Code
+#include <r_code/vector.h>        // for vector
+#include <r_exec/binding_map.h>   // for HLPBindingMap
+#include <r_exec/hlp_context.h>   // for HLPContext
+#include <r_exec/operator.h>      // for Operator, Context
+#include <r_exec/operator.tpl.h>  // for Operator::evaluate
+#include <r_exec/overlay.h>       // for Overlay
 
-#include <replicode_common.h>    // for P
+#include <replicode_common.h>     // for P
 
 
 namespace r_exec
@@ -151,9 +152,7 @@ bool HLPContext::evaluate_no_dereference(uint16_t &result_index) const
         }
 
         Operator op = Operator::Get((*this)[0].asOpcode());
-        HLPContext *c = new HLPContext(*this);
-        Context _c(c);
-        return op(_c, result_index);
+        return op.evaluate(*this, result_index);
     }
 
     case Atom::OBJECT:
@@ -38,6 +38,7 @@
 #include <r_exec/_context.h>     // for _Context::::STEM, _Context, etc
 #include <r_exec/hlp_overlay.h>  // for HLPOverlay
 #include <stdint.h>              // for uint16_t
+#include <new>                   // for operator new
 
 #include <replicode_common.h>     // for REPLICODE_EXPORT
 
@@ -77,10 +78,9 @@ public:
     bool evaluate_no_dereference(uint16_t &result_index) const;
 
     // __Context implementation.
-    _Context *assign(const _Context *c)
+    _Context *clone(void *storage) const
     {
-        HLPContext *_c = new HLPContext(*(HLPContext *)c);
-        return _c;
+        return new(storage) HLPContext(*this);
     }
 
     bool equal(const _Context *c) const
@@ -99,18 +99,18 @@ public:
     {
         return code[index].getAtomCount();
     }
-    _Context *_getChild(uint16_t index) const
+    _Context *_getChild(uint16_t index, void *storage) const
     {
-        HLPContext *_c = new HLPContext(getChild(index));
-        return _c;
+        return new(storage) HLPContext(getChild(index));
     }
 
-    _Context *dereference() const
+    _Context *dereference(void *storage) const
     {
-        HLPContext *_c = new HLPContext(**this);
-        return _c;
+        return new(storage) HLPContext(**this);
     }
 };
+
+static_assert(sizeof(HLPContext) <= _Context::MaxSize, "HLPContext does not fit in a Context");
 }
 
 
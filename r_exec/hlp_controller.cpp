@@ -31,11 +31,15 @@
 #include "hlp_controller.h"
 
 #include <r_code/atom.h>            // for Atom
+#include <r_code/replicode_defs.h>  // for HLP_OBJS, HLP_TPL_ARGS
+#include <r_exec/alpha_network.h>   // for AlphaNetwork, AlphaNode
 #include <r_exec/group.h>           // for Group
 #include <r_exec/hlp_controller.h>  // for HLPController, etc
 #include <r_exec/hlp_overlay.h>     // for HLPOverlay
 #include <r_exec/mem.h>             // for _Mem
+#include <r_exec/opcodes.h>         // for Opcodes, Opcodes::AntiFact, etc
 #include <atomic>                   // for atomic_int_fast64_t
+#include <utility>                  // for make_pair, move, pair
 
 
 namespace r_exec
@@ -49,6 +53,15 @@ HLPController::HLPController(r_code::View *view): OController(view), strong_requ
     _has_tpl_args = object->code(object->code(HLP_TPL_ARGS).asIndex()).getAtomCount() > 0;
     ref_count = 0;
     last_match_time = Now();
+    uint16_t obj_set_index = object->code(HLP_OBJS).asIndex();
+    uint16_t obj_count = object->code(obj_set_index).getAtomCount();
+
+    for (uint16_t i = 1; i <= obj_count; ++i) {
+        Code *pattern = object->get_reference(object->code(obj_set_index + i).asIndex());
+        P<AlphaNode> node;
+        AlphaNetwork::GetHLPNode(pattern, node);
+        alpha_nodes.push_back(std::make_pair(pattern, std::move(node)));
+    }
 }
 
 HLPController::~HLPController()
@@ -61,6 +74,24 @@ void HLPController::invalidate()
     controllers.clear();
 }
 
+AlphaNode *HLPController::get_alpha_node(const Code *pattern) const
+{
+    for (const std::pair<Code *, P<AlphaNode> > &node : alpha_nodes) {
+        if (node.first == pattern) {
+            return node.second;
+        }
+    }
+
+    return nullptr;
+}
+
+bool HLPController::get_input_heads(std::vector<InputHead> &heads) const
+{
+    heads.push_back(InputHead(Opcodes::Fact, AnyOpcode));
+    heads.push_back(InputHead(Opcodes::AntiFact, AnyOpcode));
+    return true;
+}
+
 void HLPController::add_requirement(bool strong)
 {
     std::lock_guard<std::mutex> guard(m_reductionMutex);
@@ -191,7 +222,7 @@ bool HLPController::become_invalidated()
         return true;
     }
 
-    for (P<HLPController> controller : controllers) {
+    for (const P<HLPController> &controller : controllers) {
         if (controller != nullptr && controller->is_invalidated()) {
             kill_views();
             return true;
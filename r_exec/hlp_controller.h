@@ -35,6 +35,7 @@
 #include <r_code/list.h>            // for list
 #include <r_code/object.h>          // for Code
 #include <r_code/replicode_defs.h>  // for MDL_HIDDEN_REFS
+#include <r_exec/alpha_network.h>   // for AlphaNode
 #include <r_exec/binding_map.h>     // for MatchResult
 #include <r_exec/factory.h>         // for _Fact
 #include <r_exec/init.h>            // for Now
@@ -42,6 +43,7 @@
 #include <r_exec/view.h>            // for View
 #include <stdint.h>                 // for uint64_t, uint16_t
 #include <mutex>                    // for mutex, lock_guard
+#include <utility>                  // for move, pair
 #include <vector>                   // for vector
 
 #include <replicode_common.h>       // for P
@@ -122,11 +124,13 @@ protected:
             }
         }
 
-        cache->evidences.push_front(e);
+        cache->evidences.push_front(std::move(e)); // hands the reference to the evidence over to the cache.
     }
 
     P<HLPBindingMap> bindings;
 
+    std::vector<std::pair<Code *, P<AlphaNode> > > alpha_nodes; // by pattern.
+
     bool evaluate_bwd_guards(HLPBindingMap *bm);
 
     MatchResult check_evidences(_Fact *target, _Fact *&evidence); // evidence with the match (positive or negative), get_absentee(target) otherwise.
@@ -148,6 +152,10 @@ public:
 
     void invalidate();
 
+    bool get_input_heads(std::vector<InputHead> &heads) const; // facts and |facts.
+
+    AlphaNode *get_alpha_node(const Code *pattern) const; // nullptr if none.
+
     Code *get_core_object() const
     {
         return getObject(); // cst or mdl.
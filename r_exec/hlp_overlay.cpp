@@ -32,6 +32,9 @@
 
 #include <r_code/atom.h>            // for Atom, Atom::::ASSIGN_PTR, etc
 #include <r_code/replicode_defs.h>  // for HLP_BWD_GUARDS, HLP_FWD_GUARDS
+#include <r_exec/alpha_network.h>   // for AlphaNode
+#include <r_exec/binding_map.h>     // for BindingMap
+#include <r_exec/factory.h>         // for _Fact
 #include <r_exec/hlp_context.h>     // for HLPContext
 #include <r_exec/hlp_controller.h>  // for HLPController
 #include <r_exec/hlp_overlay.h>     // for HLPOverlay
@@ -89,6 +92,25 @@ uint16_t HLPOverlay::get_value_code_size(uint16_t id) const
     return bindings->get_value_code_size(id);
 }
 
+bool HLPOverlay::may_match(_Fact *input, _Fact *pattern) const
+{
+    Code *object = input->get_reference(0);
+    AlphaNode *node = ((HLPController *)controller)->get_alpha_node(pattern);
+    bool passed;
+
+    if (node && node->get_outcome(object, passed)) {
+        return passed;
+    }
+
+    passed = BindingMap::MatchConstants(object, pattern->get_reference(0));
+
+    if (node) {
+        node->set_outcome(object, passed);
+    }
+
+    return passed;
+}
+
 inline bool HLPOverlay::evaluate_guards(uint16_t guard_set_iptr_index)
 {
     uint16_t guard_set_index = code[guard_set_iptr_index].asIndex();
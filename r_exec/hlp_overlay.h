@@ -72,6 +72,8 @@ protected:
 
     void store_evidence(_Fact *evidence, bool prediction, bool simulation); // stores both actual and non-simulated predicted evidences.
 
+    bool may_match(_Fact *input, _Fact *pattern) const; // false if the constants of the pattern rule out the input, whatever the bindings (see AlphaNode).
+
     HLPOverlay(Controller *c, HLPBindingMap *bindings);
 public:
     static bool EvaluateBWDGuards(Controller *c, HLPBindingMap *bindings); // updates the bindings.
@@ -156,6 +156,37 @@ namespace r_exec
 
 REPLICODE_EXPORT uint64_t(*Now)();
 
+std::atomic<uint64_t> VirtualTime::Time(0);
+std::atomic<uint64_t> VirtualTime::Limit(UINT64_MAX);
+
+uint64_t VirtualTime::Now()
+{
+    return Time.load(std::memory_order_acquire);
+}
+
+bool VirtualTime::Set(uint64_t time)
+{
+    uint64_t limit = Limit.load(std::memory_order_acquire);
+    bool reached = true;
+
+    if (time > limit) { // stop at the limit, so that whoever waits for it wakes up.
+        time = limit;
+        reached = false;
+    }
+
+    uint64_t t = Time.load(std::memory_order_relaxed);
+
+    while (t < time && !Time.compare_exchange_weak(t, time, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+
+    return reached;
+}
+
+void VirtualTime::SetLimit(uint64_t limit)
+{
+    Limit.store(limit, std::memory_order_release);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
 bool Compile(const char* filename,
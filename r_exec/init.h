@@ -33,6 +33,7 @@
 
 #include <r_code/list.h>       // for list
 #include <stdint.h>            // for uint64_t
+#include <atomic>              // for atomic
 #include <string>              // for string
 #include <thread>              // for thread
 #include <vector>              // for vector
@@ -54,6 +55,20 @@ namespace r_exec
 // Time base; either Time::Get or network-aware synced time.
 extern REPLICODE_EXPORT uint64_t(*Now)();
 
+// Discrete-event time base: pass VirtualTime::Now to Init() to run as fast as possible.
+// The time cores move the clock straight to the next deadline once the rMem has nothing left to do at the current
+// time (see TimerWheel::pop()).
+class REPLICODE_EXPORT VirtualTime
+{
+private:
+    static std::atomic<uint64_t> Time;
+    static std::atomic<uint64_t> Limit;
+public:
+    static uint64_t Now();
+    static bool Set(uint64_t time); // never moves the clock backward nor past the limit; false if time is past the limit.
+    static void SetLimit(uint64_t limit); // the clock stops there, e.g. at the end of a run.
+};
+
 // Loaded once for all.
 // Results from the compilation of user.classes.replicode.
 // The latter contains all class definitions and all shared objects (e.g. ontology); does not contain any dynamic (res!=forever) objects.
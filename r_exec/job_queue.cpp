@@ -0,0 +1,105 @@
+//	job_queue.cpp
+//
+//	Lock-free job pipes shared by the rMem cores.
+
+#include "job_queue.h"
+
+#include <chrono>            // for microseconds
+#include <limits.h>          // for INT_MAX
+
+#if defined(__linux__)
+#include <linux/futex.h>     // for FUTEX_WAIT_PRIVATE, FUTEX_WAKE_PRIVATE
+#include <sys/syscall.h>     // for SYS_futex
+#include <time.h>            // for timespec
+#include <unistd.h>          // for syscall
+#endif
+
+
+namespace r_exec
+{
+
+#if defined(__linux__)
+
+static inline void futex_wait(std::atomic<uint32_t> *address, uint32_t expected, const timespec *timeout)
+{
+    syscall(SYS_futex, (uint32_t *)address, FUTEX_WAIT_PRIVATE, expected, timeout, nullptr, 0);
+}
+
+static inline void futex_wake(std::atomic<uint32_t> *address, int count)
+{
+    syscall(SYS_futex, (uint32_t *)address, FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+}
+
+void Parker::wake(bool all)
+{
+    if (signaled.exchange(true, std::memory_order_seq_cst) && !all) {
+        return;
+    }
+
+    epoch.fetch_add(1, std::memory_order_seq_cst);
+    futex_wake(&epoch, all ? INT_MAX : 1);
+}
+
+void Parker::wait(uint32_t key)
+{
+    futex_wait(&epoch, key, nullptr);
+    woken();
+}
+
+void Parker::wait_for(uint32_t key, uint64_t timeout)
+{
+    timespec t;
+    t.tv_sec = timeout / 1000000;
+    t.tv_nsec = (timeout % 1000000) * 1000;
+    futex_wait(&epoch, key, &t);
+    woken();
+}
+
+#else
+
+void Parker::wake(bool all)
+{
+    if (signaled.exchange(true, std::memory_order_seq_cst) && !all) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        epoch.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    if (all) {
+        m_condition.notify_all();
+    } else {
+        m_condition.notify_one();
+    }
+}
+
+void Parker::wait(uint32_t key)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (epoch.load(std::memory_order_seq_cst) == key) {
+            m_condition.wait(lock);
+        }
+    }
+
+    woken();
+}
+
+void Parker::wait_for(uint32_t key, uint64_t timeout)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if (epoch.load(std::memory_order_seq_cst) == key) {
+            m_condition.wait_for(lock, std::chrono::microseconds(timeout));
+        }
+    }
+
+    woken();
+}
+
+#endif
+}
@@ -0,0 +1,372 @@
+//	job_queue.h
+//
+//	Lock-free job pipes shared by the rMem cores.
+
+#ifndef job_queue_h
+#define job_queue_h
+
+#include <stddef.h>            // for size_t
+#include <stdint.h>            // for uint32_t, uint64_t, intptr_t
+#include <atomic>              // for atomic, memory_order_*
+#include <condition_variable>  // for condition_variable
+#include <mutex>               // for mutex
+#include <thread>              // for thread::hardware_concurrency
+
+#include <replicode_common.h>  // for REPLICODE_EXPORT
+
+namespace r_exec
+{
+
+// Event count: lets idle cores sleep without a lock on the producers' side.
+// Waiters announce themselves with prepare_wait(), re-check their condition, then wait() (or cancel_wait()).
+// Notifiers pay for a fence and a load when nobody waits; otherwise they bump the epoch and wake sleepers
+// (futex on linux, condition variable elsewhere). Until a woken waiter runs, further notify_one() calls are
+// absorbed: the waiter re-checks its condition anyway and passes the signal on if there is more to do.
+class REPLICODE_EXPORT Parker
+{
+private:
+    std::atomic<uint32_t> epoch;
+    std::atomic<uint32_t> waiters;
+    std::atomic<bool> signaled; // a wake-up is in flight.
+#if !defined(__linux__)
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+#endif
+    void wake(bool all);
+    void woken()
+    {
+        waiters.fetch_sub(1, std::memory_order_seq_cst);
+        signaled.exchange(false, std::memory_order_seq_cst); // acquires what the absorbed notifiers published.
+    }
+public:
+    Parker(): epoch(0), waiters(0), signaled(false) {}
+
+    uint32_t prepare_wait()
+    {
+        waiters.fetch_add(1, std::memory_order_seq_cst);
+        signaled.exchange(false, std::memory_order_seq_cst); // later notifiers must wake us up.
+        std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the fence in notify_xxx().
+        return epoch.load(std::memory_order_seq_cst);
+    }
+    void cancel_wait()
+    {
+        waiters.fetch_sub(1, std::memory_order_seq_cst);
+    }
+    void wait(uint32_t key); // returns when notified after prepare_wait(), or spuriously.
+    void wait_for(uint32_t key, uint64_t timeout); // in us.
+
+    void notify_one()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (waiters.load(std::memory_order_relaxed) > 0) {
+            wake(false);
+        }
+    }
+    void notify_all()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (waiters.load(std::memory_order_relaxed) > 0) {
+            wake(true);
+        }
+    }
+};
+
+// Bounded multi-producer/multi-consumer queue (D. Vyukov's design): one CAS per operation, no lock.
+// Capacity is rounded up to a power of 2. T is a pointer: an element still in the queue can be swapped for another
+// (see try_replace()).
+template<typename T> class MPMCQueue
+{
+private:
+    static const size_t CacheLineSize = 64;
+
+    class Cell
+    {
+    public:
+        std::atomic<size_t> sequence;
+        std::atomic<T> data;
+    };
+
+    Cell *buffer;
+    size_t mask;
+    char pad0[CacheLineSize];
+    std::atomic<size_t> enqueue_pos;
+    char pad1[CacheLineSize - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> dequeue_pos;
+    char pad2[CacheLineSize - sizeof(std::atomic<size_t>)];
+
+    MPMCQueue(const MPMCQueue &);
+    MPMCQueue &operator =(const MPMCQueue &);
+public:
+    MPMCQueue(size_t capacity): enqueue_pos(0), dequeue_pos(0)
+    {
+        size_t size = 2;
+
+        while (size < capacity) {
+            size <<= 1;
+        }
+
+        buffer = new Cell[size];
+        mask = size - 1;
+
+        for (size_t i = 0; i < size; ++i) {
+            buffer[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    ~MPMCQueue()
+    {
+        delete[] buffer;
+    }
+
+    bool try_push(const T &data)
+    {
+        size_t pos;
+        return try_push(data, pos);
+    }
+
+    bool try_push(const T &data, size_t &pos) // pos: where the data went, for is_pending() and try_replace().
+    {
+        Cell *cell;
+        pos = enqueue_pos.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell = &buffer[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) { // full.
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data.store(data, std::memory_order_relaxed);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T &data)
+    {
+        Cell *cell;
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell = &buffer[pos & mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) { // empty.
+                return false;
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        data = cell->data.exchange(nullptr, std::memory_order_acq_rel); // exclusive of try_replace().
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Whether the element pushed at pos has not been popped yet; positions are compared modulo 2^32.
+    bool is_pending(size_t pos) const
+    {
+        return (uint32_t)buffer[pos & mask].sequence.load(std::memory_order_acquire) == (uint32_t)(pos + 1);
+    }
+
+    // Swaps the element pushed at pos for data, unless it has been popped meanwhile. The caller guarantees that
+    // expected cannot be pushed again meanwhile (e.g. it holds a reference to it).
+    bool try_replace(size_t pos, T expected, const T &data)
+    {
+        return buffer[pos & mask].data.compare_exchange_strong(expected, data, std::memory_order_acq_rel);
+    }
+
+    size_t capacity() const
+    {
+        return mask + 1;
+    }
+
+    size_t size() const // approximate when accessed concurrently.
+    {
+        size_t e = enqueue_pos.load(std::memory_order_relaxed);
+        size_t d = dequeue_pos.load(std::memory_order_relaxed);
+        return e > d ? e - d : 0;
+    }
+};
+
+// Bounded work-stealing deque (Chase & Lev, with the C11 orderings of Le et al.).
+// The owner pushes and pops at the bottom (LIFO); other threads steal from the top (FIFO).
+// Capacity is rounded up to a power of 2; push() fails when full.
+template<typename T> class WorkStealingDeque
+{
+private:
+    static const size_t CacheLineSize = 64;
+
+    std::atomic<T> *buffer;
+    int64_t mask;
+    char pad0[CacheLineSize];
+    std::atomic<int64_t> top;
+    char pad1[CacheLineSize - sizeof(std::atomic<int64_t>)];
+    std::atomic<int64_t> bottom;
+    char pad2[CacheLineSize - sizeof(std::atomic<int64_t>)];
+
+    WorkStealingDeque(const WorkStealingDeque &);
+    WorkStealingDeque &operator =(const WorkStealingDeque &);
+public:
+    WorkStealingDeque(size_t capacity): top(0), bottom(0)
+    {
+        size_t size = 2;
+
+        while (size < capacity) {
+            size <<= 1;
+        }
+
+        buffer = new std::atomic<T>[size];
+        mask = size - 1;
+    }
+    ~WorkStealingDeque()
+    {
+        delete[] buffer;
+    }
+
+    bool push(const T &data) // owner only.
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+
+        if (b - t > mask) { // full.
+            return false;
+        }
+
+        buffer[b & mask].store(data, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool pop(T &data) // owner only.
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b) { // empty.
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        data = buffer[b & mask].load(std::memory_order_relaxed);
+
+        if (t == b) { // last one: race against the thieves.
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        return true;
+    }
+
+    bool steal(T &data) // any thread; fails when empty or when losing a race.
+    {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return false;
+        }
+
+        data = buffer[t & mask].load(std::memory_order_relaxed);
+        return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    size_t size() const // approximate when accessed concurrently.
+    {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? b - t : 0;
+    }
+};
+
+// Blocking pipe of jobs: producers wait when full, consumers when empty.
+// On multi-core hosts, both sides spin briefly before parking.
+template<class Type> class JobQueue
+{
+private:
+    MPMCQueue<Type *> m_jobs;
+    Parker m_canPush;
+    Parker m_canPop;
+    const uint16_t m_spinCount;
+public:
+    JobQueue(size_t capacity = 1024): m_jobs(capacity), m_spinCount(std::thread::hardware_concurrency() > 1 ? 64 : 0) {}
+
+    void pushJob(Type *job)
+    {
+        for (uint16_t i = 0; !m_jobs.try_push(job); ++i) {
+            if (i < m_spinCount) {
+                continue;
+            }
+
+            uint32_t key = m_canPush.prepare_wait();
+
+            if (m_jobs.try_push(job)) {
+                m_canPush.cancel_wait();
+                break;
+            }
+
+            m_canPush.wait(key);
+        }
+
+        if (m_jobs.size() < m_jobs.capacity()) {
+            m_canPush.notify_one();
+        }
+
+        m_canPop.notify_one();
+    }
+
+    Type *popJob()
+    {
+        Type *job;
+
+        for (uint16_t i = 0; !m_jobs.try_pop(job); ++i) {
+            if (i < m_spinCount) {
+                continue;
+            }
+
+            uint32_t key = m_canPop.prepare_wait();
+
+            if (m_jobs.try_pop(job)) {
+                m_canPop.cancel_wait();
+                break;
+            }
+
+            m_canPop.wait(key);
+        }
+
+        if (m_jobs.size() > 0) { // wake up another core if there is more to do.
+            m_canPop.notify_one();
+        }
+
+        m_canPush.notify_one();
+        return job;
+    }
+
+    size_t size() const
+    {
+        return m_jobs.size();
+    }
+};
+}
+
+
+#endif
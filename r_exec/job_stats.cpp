@@ -0,0 +1,344 @@
+//	job_stats.cpp
+//
+//	Latency histograms of the jobs, per core and per job class.
+
+#include "job_stats.h"
+
+#include <string.h>          // for memset
+
+#if defined(__GNUC__)
+#include <cxxabi.h>          // for __cxa_demangle
+#include <stdlib.h>          // for free
+#endif
+
+
+namespace r_exec
+{
+
+static thread_local JobStats *AttachedStats = nullptr;
+static thread_local void *AttachedCore = nullptr;
+
+////////////////////////////////////////////////////////////////
+
+size_t LatencyHistogram::Bucket(uint64_t value)
+{
+    if (value < SubBucketCount) {
+        return value;
+    }
+
+    if (value >= (uint64_t(1) << MaxBits)) {
+        value = (uint64_t(1) << MaxBits) - 1;
+    }
+
+    uint64_t msb = core::HighestBit(value);
+    uint64_t shift = msb - SubBucketBits;
+    return (msb - SubBucketBits + 1) * SubBucketCount + ((value >> shift) & (SubBucketCount - 1));
+}
+
+uint64_t LatencyHistogram::Value(size_t bucket)
+{
+    if (bucket < SubBucketCount) {
+        return bucket;
+    }
+
+    uint64_t shift = bucket / SubBucketCount - 1;
+    uint64_t lower = (SubBucketCount + bucket % SubBucketCount) << shift;
+    return lower + ((uint64_t(1) << shift) >> 1);
+}
+
+LatencyHistogram::LatencyHistogram(): sum(0), count(0)
+{
+    for (size_t i = 0; i < BucketCount; ++i) {
+        counts[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+////////////////////////////////////////////////////////////////
+
+LatencyDistribution::LatencyDistribution(): count(0), sum(0)
+{
+    memset(counts, 0, sizeof(counts));
+}
+
+void LatencyDistribution::drain(LatencyHistogram &h)
+{
+    if (h.count.exchange(0, std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    sum += h.sum.exchange(0, std::memory_order_relaxed);
+
+    for (size_t i = 0; i < LatencyHistogram::BucketCount; ++i) {
+        if (h.counts[i].load(std::memory_order_relaxed) > 0) {
+            uint64_t c = h.counts[i].exchange(0, std::memory_order_relaxed);
+            counts[i] += c;
+            count += c;
+        }
+    }
+}
+
+void LatencyDistribution::add(const LatencyDistribution &d)
+{
+    for (size_t i = 0; i < LatencyHistogram::BucketCount; ++i) {
+        counts[i] += d.counts[i];
+    }
+
+    count += d.count;
+    sum += d.sum;
+}
+
+uint64_t LatencyDistribution::mean() const
+{
+    return count > 0 ? sum / count : 0;
+}
+
+uint64_t LatencyDistribution::percentile(double p) const
+{
+    if (count == 0) {
+        return 0;
+    }
+
+    uint64_t rank = (uint64_t)(p * count + 0.5);
+
+    if (rank < 1) {
+        rank = 1;
+    } else if (rank > count) {
+        rank = count;
+    }
+
+    uint64_t seen = 0;
+
+    for (size_t i = 0; i < LatencyHistogram::BucketCount; ++i) {
+        seen += counts[i];
+
+        if (seen >= rank) {
+            return LatencyHistogram::Value(i);
+        }
+    }
+
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////
+
+JobStats::Core::Core(): attached(false)
+{
+    for (size_t i = 0; i < MaxClasses * MetricCount; ++i) {
+        histograms[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+JobStats::Core::~Core()
+{
+    for (size_t i = 0; i < MaxClasses * MetricCount; ++i) {
+        delete histograms[i].load(std::memory_order_relaxed);
+    }
+}
+
+LatencyHistogram *JobStats::Core::get(size_t job_class, Metric metric)
+{
+    std::atomic<LatencyHistogram *> &slot = histograms[job_class * MetricCount + metric];
+    LatencyHistogram *h = slot.load(std::memory_order_acquire);
+
+    if (h) {
+        return h;
+    }
+
+    LatencyHistogram *_h = new LatencyHistogram();
+
+    if (slot.compare_exchange_strong(h, _h, std::memory_order_acq_rel)) { // the shared core has concurrent writers.
+        return _h;
+    }
+
+    delete _h;
+    return h;
+}
+
+////////////////////////////////////////////////////////////////
+
+JobStats::JobStats()
+{
+    for (size_t i = 0; i < TableSize; ++i) {
+        types[i].store(nullptr, std::memory_order_relaxed);
+        type_classes[i] = 0;
+    }
+
+    for (size_t i = 0; i < MaxCores; ++i) {
+        cores[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+JobStats::~JobStats()
+{
+    for (size_t i = 0; i < MaxCores; ++i) {
+        delete cores[i].load(std::memory_order_relaxed);
+    }
+}
+
+static std::string ClassName(const std::type_info &type)
+{
+    std::string name = type.name();
+#if defined(__GNUC__)
+    int status;
+    char *demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+
+    if (status == 0 && demangled) {
+        name = demangled;
+    }
+
+    free(demangled);
+#endif
+
+    for (size_t i; (i = name.find("r_exec::")) != std::string::npos;) { // all the jobs live there.
+        name.erase(i, 8);
+    }
+
+    return name;
+}
+
+size_t JobStats::get_class(const std::type_info &type)
+{
+    size_t i = ((uintptr_t)&type >> 4) % TableSize;
+
+    for (size_t probes = 0; probes < TableSize; ++probes, i = (i + 1) % TableSize) {
+        const std::type_info *t = types[i].load(std::memory_order_acquire);
+
+        if (t == &type) {
+            return type_classes[i];
+        }
+
+        if (t == nullptr) {
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(m_classMutex);
+    i = ((uintptr_t)&type >> 4) % TableSize;
+
+    for (size_t probes = 0; probes < TableSize; ++probes, i = (i + 1) % TableSize) {
+        const std::type_info *t = types[i].load(std::memory_order_relaxed);
+
+        if (t == &type) { // inserted meanwhile.
+            return type_classes[i];
+        }
+
+        if (t == nullptr) {
+            break;
+        }
+    }
+
+    size_t job_class = MaxClasses - 1;
+
+    for (size_t j = 0; j < TableSize; ++j) { // the same type may have several type_info objects (one per shared library).
+        const std::type_info *t = types[j].load(std::memory_order_relaxed);
+
+        if (t && *t == type) {
+            job_class = type_classes[j];
+            break;
+        }
+    }
+
+    if (job_class == MaxClasses - 1 && class_names.size() < MaxClasses) {
+        job_class = class_names.size();
+        class_names.push_back(job_class == MaxClasses - 1 ? "other" : ClassName(type));
+    }
+
+    if (types[i].load(std::memory_order_relaxed) == nullptr) { // else the table is full: look the type up again next time.
+        type_classes[i] = (uint16_t)job_class;
+        types[i].store(&type, std::memory_order_release);
+    }
+
+    return job_class;
+}
+
+void JobStats::attach()
+{
+    std::lock_guard<std::mutex> guard(m_coreMutex);
+
+    for (size_t i = 0; i < MaxCores; ++i) {
+        Core *core = cores[i].load(std::memory_order_relaxed);
+
+        if (!core) {
+            core = new Core();
+            cores[i].store(core, std::memory_order_release);
+        } else if (core->attached.load(std::memory_order_relaxed)) {
+            continue;
+        }
+
+        core->attached.store(true, std::memory_order_relaxed);
+        AttachedStats = this;
+        AttachedCore = core;
+        return;
+    }
+}
+
+void JobStats::detach()
+{
+    if (AttachedStats != this) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(m_coreMutex);
+    ((Core *)AttachedCore)->attached.store(false, std::memory_order_relaxed);
+    AttachedStats = nullptr;
+    AttachedCore = nullptr;
+}
+
+void JobStats::record(const std::type_info &job_type, Metric metric, uint64_t value)
+{
+    Core *core = AttachedStats == this ? (Core *)AttachedCore : &shared;
+    core->get(get_class(job_type), metric)->record(value);
+}
+
+void JobStats::collect(std::vector<Sample> &samples)
+{
+    size_t class_count;
+    {
+        std::lock_guard<std::mutex> guard(m_classMutex);
+        class_count = class_names.size();
+    }
+
+    for (size_t c = 0; c < class_count; ++c) {
+        for (size_t m = 0; m < MetricCount; ++m) {
+            Sample s;
+
+            for (size_t i = 0; i <= MaxCores; ++i) {
+                Core *core = i < MaxCores ? cores[i].load(std::memory_order_acquire) : &shared;
+
+                if (!core) {
+                    continue;
+                }
+
+                LatencyHistogram *h = core->histograms[c * MetricCount + m].load(std::memory_order_acquire);
+
+                if (h) {
+                    s.distribution.drain(*h);
+                }
+            }
+
+            if (s.distribution.count > 0) {
+                {
+                    std::lock_guard<std::mutex> guard(m_classMutex);
+                    s.job_class = class_names[c];
+                }
+                s.metric = (Metric)m;
+                samples.push_back(s);
+            }
+        }
+    }
+}
+
+const char *JobStats::MetricName(Metric metric)
+{
+    switch (metric) {
+    case WAIT:
+        return "wait";
+
+    case RUN:
+        return "run";
+
+    default:
+        return "lateness";
+    }
+}
+}
@@ -0,0 +1,133 @@
+//	job_stats.h
+//
+//	Latency histograms of the jobs, per core and per job class.
+
+#ifndef job_stats_h
+#define job_stats_h
+
+#include <stddef.h>            // for size_t
+#include <stdint.h>            // for uint64_t, uint16_t
+#include <atomic>              // for atomic
+#include <mutex>               // for mutex
+#include <string>              // for string
+#include <typeinfo>            // for type_info
+#include <vector>              // for vector
+
+#include <replicode_common.h>  // for REPLICODE_EXPORT
+
+namespace r_exec
+{
+
+// Log-linear buckets (as in HDR histograms): 16 linear sub-buckets per power of 2, i.e. a relative error under 6.25%.
+// Values are in us and clamped to 2^40 us (about 12 days).
+// record() is lock-free: one relaxed increment on a counter that is shared only with the collecting thread.
+class REPLICODE_EXPORT LatencyHistogram
+{
+public:
+    static const uint64_t SubBucketBits = 4;
+    static const uint64_t SubBucketCount = 1 << SubBucketBits;
+    static const uint64_t MaxBits = 40;
+    static const size_t BucketCount = (MaxBits - SubBucketBits + 1) * SubBucketCount;
+
+    static size_t Bucket(uint64_t value);
+    static uint64_t Value(size_t bucket); // middle of the range of values that fall in the bucket.
+private:
+    std::atomic<uint64_t> counts[BucketCount];
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> count;
+public:
+    LatencyHistogram();
+
+    void record(uint64_t value)
+    {
+        counts[Bucket(value)].fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    friend class LatencyDistribution;
+};
+
+// Plain copy of histograms, merged across cores, for computing percentiles.
+class REPLICODE_EXPORT LatencyDistribution
+{
+private:
+    uint64_t counts[LatencyHistogram::BucketCount];
+public:
+    uint64_t count;
+    uint64_t sum;
+
+    LatencyDistribution();
+
+    void drain(LatencyHistogram &h); // moves the counts of h here; h keeps what is recorded meanwhile.
+    void add(const LatencyDistribution &d);
+
+    uint64_t mean() const;
+    uint64_t percentile(double p) const; // p in [0,1]; 0 when empty.
+};
+
+// One set of histograms per core and per job class, for three metrics:
+// the time a reduction job waits in the pipe (WAIT), the time a job takes to run (RUN) and how late a time job fires
+// (LATENESS). Cores attach to a set of histograms of their own; other threads share one set.
+// Job classes are identified by their dynamic type: no job needs to register.
+class REPLICODE_EXPORT JobStats
+{
+public:
+    typedef enum {
+        WAIT = 0,
+        RUN = 1,
+        LATENESS = 2
+    } Metric;
+    static const size_t MetricCount = 3;
+    static const size_t MaxClasses = 64; // beyond that, classes are merged into the last one.
+    static const size_t MaxCores = 128; // beyond that, cores share the histograms of the other threads.
+
+    class Sample
+    {
+    public:
+        std::string job_class;
+        Metric metric;
+        LatencyDistribution distribution;
+    };
+private:
+    static const size_t TableSize = 2 * MaxClasses;
+
+    class Core
+    {
+    public:
+        std::atomic<bool> attached;
+        std::atomic<LatencyHistogram *> histograms[MaxClasses * MetricCount]; // allocated on first use.
+        Core();
+        ~Core();
+        LatencyHistogram *get(size_t job_class, Metric metric);
+    };
+
+    std::atomic<const std::type_info *> types[TableSize]; // open addressing, keyed by the address of the type_info.
+    uint16_t type_classes[TableSize];
+    std::vector<std::string> class_names;
+    std::mutex m_classMutex; // serializes the insertion of new types.
+
+    Core shared; // for the threads that are not attached.
+    std::atomic<Core *> cores[MaxCores];
+    std::mutex m_coreMutex;
+
+    size_t get_class(const std::type_info &type);
+public:
+    JobStats();
+    ~JobStats();
+
+    // Binds the calling thread to a set of histograms of its own (reused by the next core once detached).
+    void attach();
+    void detach();
+
+    void record(const std::type_info &job_type, Metric metric, uint64_t value);
+
+    // Moves everything recorded since the last call into one sample per job class and metric (empty ones are skipped).
+    void collect(std::vector<Sample> &samples);
+
+    static const char *MetricName(Metric metric);
+};
+}
+
+
+#endif
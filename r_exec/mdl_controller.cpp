@@ -42,6 +42,7 @@
 #include <r_exec/opcodes.h>         // for Opcodes, Opcodes::IMdl, etc
 #include <r_exec/overlay.h>         // for Controller
 #include <r_exec/p_monitor.h>       // for PMonitor
+#include <r_exec/time_job.h>        // for TimeJobHandle
 #include <r_exec/view.h>            // for View, NotificationView
 #include <ostream>                  // for operator<<, basic_ostream, etc
 #include <string>                   // for operator<<, char_traits, etc
@@ -91,6 +92,10 @@ Overlay *PrimaryMDLOverlay::reduce(_Fact *input, Fact *f_p_f_imdl, MDLController
         simulation = false;
     }
 
+    if (!may_match(input_object, ((MDLController *)controller)->get_lhs())) {
+        return nullptr;
+    }
+
     P<HLPBindingMap> bm = new HLPBindingMap(bindings);
     bm->reset_fwd_timings(input_object);
 
@@ -178,7 +183,7 @@ Overlay *PrimaryMDLOverlay::reduce(_Fact *input, Fact *f_p_f_imdl, MDLController
 
 bool PrimaryMDLOverlay::check_simulated_chaining(HLPBindingMap *bm, Fact *f_imdl, Pred *prediction)
 {
-    for (P<Sim> simulation : prediction->simulations) {
+    for (const P<Sim> &simulation : prediction->simulations) {
         switch (((MDLController *)controller)->retrieve_simulated_imdl_fwd(bm, f_imdl, simulation->root)) {
         case NO_R:
         case WR_ENABLED:
@@ -205,6 +210,10 @@ SecondaryMDLOverlay::~SecondaryMDLOverlay()
 Overlay *SecondaryMDLOverlay::reduce(_Fact *input, Fact *f_p_f_imdl, MDLController *req_controller)   // no caching since no bwd.
 {
     //std::cout<<std::hex<<this<<std::dec<<" "<<input->object->get_oid();
+    if (!may_match(input, ((MDLController *)controller)->get_lhs())) {
+        return nullptr;
+    }
+
     P<HLPBindingMap> bm = new HLPBindingMap(bindings);
     bm->reset_fwd_timings(input);
 
@@ -347,6 +356,7 @@ bool MDLController::monitor_predictions(_Fact *input)
 
     for (m = p_monitors.begin(); m != p_monitors.end();) {
         if ((*m)->reduce(input)) {
+            (*m)->retire();
             m = p_monitors.erase(m);
             r = true;
         } else {
@@ -357,6 +367,29 @@ bool MDLController::monitor_predictions(_Fact *input)
     return r;
 }
 
+void MDLController::get_monitor_jobs(std::vector<P<TimeJobHandle> > &jobs)
+{
+    r_code::list<P<PMonitor> >::const_iterator m;
+    std::lock_guard<std::mutex> guard(m_monitorMutex);
+
+    for (m = p_monitors.begin(); m != p_monitors.end(); ++m) {
+        if ((*m)->get_job() != nullptr) {
+            jobs.push_back((*m)->get_job());
+        }
+    }
+}
+
+void MDLController::invalidate()
+{
+    HLPController::invalidate();
+    std::vector<P<TimeJobHandle> > jobs;
+    get_monitor_jobs(jobs);
+
+    for (TimeJobHandle *job : jobs) { // outside the monitor lists' locks: a cancelled job is released with its monitor.
+        job->cancel();
+    }
+}
+
 void MDLController::add_monitor(PMonitor *m)
 {
     std::lock_guard<std::mutex> guard(m_monitorMutex);
@@ -966,6 +999,25 @@ PMDLController::PMDLController(r_code::View *view): MDLController(view)
 {
 }
 
+void PMDLController::get_monitor_jobs(std::vector<P<TimeJobHandle> > &jobs)
+{
+    MDLController::get_monitor_jobs(jobs);
+    r_code::list<P<_GMonitor> >::const_iterator m;
+    std::lock_guard<std::mutex> guard(m_gMonitorsMutex);
+
+    for (m = g_monitors.begin(); m != g_monitors.end(); ++m) {
+        if ((*m)->get_job() != nullptr) {
+            jobs.push_back((*m)->get_job());
+        }
+    }
+
+    for (m = r_monitors.begin(); m != r_monitors.end(); ++m) {
+        if ((*m)->get_job() != nullptr) {
+            jobs.push_back((*m)->get_job());
+        }
+    }
+}
+
 void PMDLController::add_g_monitor(_GMonitor *m)
 {
     std::lock_guard<std::mutex> guard(m_gMonitorsMutex);
@@ -1031,6 +1083,7 @@ bool PMDLController::monitor_goals(_Fact *input)
 
     for (m = g_monitors.begin(); m != g_monitors.end();) {
         if ((*m)->reduce(input)) {
+            (*m)->retire();
             m = g_monitors.erase(m);
             r = true;
         } else {
@@ -1291,7 +1344,7 @@ void TopLevelMDLController::register_simulated_goal_outcome(Fact *goal, bool suc
 
     Pred *pred = new Pred(f_success_object, 1);
 
-    for (P<Sim> simulation : evidence_pred->simulations) {
+    for (const P<Sim> &simulation : evidence_pred->simulations) {
         pred->simulations.push_back(simulation);
     }
 
@@ -1333,6 +1386,7 @@ void PrimaryMDLController::store_requirement(_Fact *f_p_f_imdl, MDLController *c
                 m = r_monitors.erase(m);
             } else {
                 if ((*m)->signal(simulation)) {
+                    (*m)->retire();
                     m = r_monitors.erase(m);
                 } else {
                     ++m;
@@ -1442,7 +1496,7 @@ void PrimaryMDLController::predict(HLPBindingMap *bm, _Fact *input, Fact *f_imdl
             }
         }
     } else { // no monitoring for simulated predictions.
-        for (P<Sim> simulation : prediction->simulations) {
+        for (const P<Sim> &simulation : prediction->simulations) {
             pred->simulations.push_back(simulation);
         }
 
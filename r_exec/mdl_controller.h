@@ -210,10 +210,14 @@ protected:
     /// predictions are admissible inputs (for checking predicted counter-evidences).
     bool monitor_predictions(_Fact *input);
 
+    virtual void get_monitor_jobs(std::vector<P<TimeJobHandle> > &jobs); // called by invalidate().
+
     MDLController(r_code::View *view);
 public:
     static MDLController *New(View *view, bool &inject_in_secondary_group);
 
+    void invalidate(); // also cancels the monitoring jobs.
+
     void add_monitor(PMonitor *m);
     void remove_monitor(PMonitor *m);
 
@@ -267,6 +271,8 @@ protected:
 
     bool monitor_goals(_Fact *input);
 
+    void get_monitor_jobs(std::vector<P<TimeJobHandle> > &jobs);
+
     uint64_t get_sim_thz(uint64_t now, uint64_t deadline) const;
 
     PMDLController(r_code::View *view);
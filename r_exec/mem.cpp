@@ -30,22 +30,28 @@
 
 #include "mem.h"
 
+#include <r_code/reclaimer.h>       // for Reclaimer
 #include <r_code/replicode_defs.h>  // for HLP_FWD_GUARDS, HLP_OUT_GRPS, etc
 #include <r_comp/segments.h>        // for Image
+#include <r_exec/cpu_affinity.h>    // for CPUAffinity
 #include <r_exec/factory.h>         // for Fact, Perf
-#include <r_exec/init.h>            // for Now
+#include <r_exec/init.h>            // for Now, VirtualTime
 #include <r_exec/mem.h>             // for _Mem, MemStatic, MemVolatile, etc
 #include <r_exec/model_base.h>      // for ModelBase
 #include <r_exec/object.h>          // for LObject
 #include <r_exec/opcodes.h>         // for Opcodes, Opcodes::AntiFact, etc
 #include <r_exec/overlay.h>         // for Controller
+#include <r_exec/pgm_controller.h>  // for _PGMController
 #include <r_exec/reduction_core.h>  // for runReductionCore
 #include <r_exec/reduction_job.h>   // for AsyncInjectionJob, etc
 #include <r_exec/time_core.h>       // for runTimeCore
 #include <r_exec/time_job.h>        // for EInjectionJob, InjectionJob, etc
 #include <r_exec/view.h>            // for View
+#include <algorithm>                // for find
+#include <fstream>                  // for ofstream
 #include <iostream>                 // for ostream, cout
 #include <set>                      // for multiset
+#include <string>                   // for string, to_string
 #include <unordered_map>            // for _Node_const_iterator, etc
 #include <unordered_set>            // for unordered_set, etc
 #include <utility>                  // for pair
@@ -56,7 +62,8 @@
 namespace r_exec
 {
 
-_Mem::_Mem(): r_code::Mem(), state(NOT_STARTED), deleted(false)
+// 1ms ticks: level 0 of the time wheel spans 64ms, level 3 about 4.6 hours.
+_Mem::_Mem(): r_code::Mem(), m_timeJobWheel(1000), state(NOT_STARTED), deleted(false)
 {
     LOG_DEBUG << "_Mem() called";
     new ModelBase();
@@ -67,7 +74,18 @@ _Mem::~_Mem() {}
 
 void _Mem::init(uint64_t base_period,
                 uint64_t reduction_core_count,
+                uint64_t min_reduction_core_count,
+                uint64_t max_reduction_core_count,
                 uint64_t time_core_count,
+                const std::vector<uint64_t> &reduction_core_cpus,
+                const std::vector<uint64_t> &time_core_cpus,
+                bool numa,
+                uint64_t reclamation_period,
+                bool reduction_job_affinity,
+                bool reduction_job_priority,
+                uint64_t reduction_job_aging_window,
+                uint64_t reduction_job_capacity,
+                ReductionPipe::OverflowPolicy reduction_job_overflow,
                 double mdl_inertia_sr_thr,
                 uint64_t mdl_inertia_cnt_thr,
                 double tpx_dsr_thr,
@@ -76,10 +94,16 @@ void _Mem::init(uint64_t base_period,
                 double sim_time_horizon,
                 uint64_t tpx_time_horizon,
                 uint64_t perf_sampling_period,
+                const std::string &perf_stats_file,
                 double float_tolerance,
                 uint64_t time_tolerance,
                 uint64_t primary_thz,
                 uint64_t secondary_thz,
+                bool hash_consing,
+                uint64_t memory_soft_budget,
+                uint64_t memory_hard_budget,
+                uint64_t group_memory_soft_budget,
+                uint64_t group_memory_hard_budget,
                 bool debug,
                 uint64_t ntf_mk_res,
                 uint64_t goal_pred_success_res,
@@ -87,8 +111,31 @@ void _Mem::init(uint64_t base_period,
                 uint64_t traces)
 {
     this->base_period = base_period;
+    this->min_reduction_core_count = min_reduction_core_count > 0 ? min_reduction_core_count : reduction_core_count;
+    this->max_reduction_core_count = max_reduction_core_count > 0 ? max_reduction_core_count : reduction_core_count;
+
+    if (this->max_reduction_core_count < this->min_reduction_core_count) {
+        this->max_reduction_core_count = this->min_reduction_core_count;
+    }
+
+    if (reduction_core_count < this->min_reduction_core_count) {
+        reduction_core_count = this->min_reduction_core_count;
+    } else if (reduction_core_count > this->max_reduction_core_count) {
+        reduction_core_count = this->max_reduction_core_count;
+    }
+
     this->reduction_core_count = reduction_core_count;
     this->time_core_count = time_core_count;
+    this->reduction_core_cpus = reduction_core_cpus;
+    this->time_core_cpus = time_core_cpus;
+    this->numa = numa;
+    CPUAffinity::SetNUMA(numa); // before load(): groups get their home node upon creation.
+    this->reclamation_period = reclamation_period;
+    this->reduction_job_affinity = reduction_job_affinity;
+    this->reduction_job_priority = reduction_job_priority;
+    this->reduction_job_aging_window = reduction_job_aging_window;
+    this->reduction_job_capacity = reduction_job_capacity;
+    this->reduction_job_overflow = reduction_job_overflow;
     this->mdl_inertia_sr_thr = mdl_inertia_sr_thr;
     this->mdl_inertia_cnt_thr = mdl_inertia_cnt_thr;
     this->tpx_dsr_thr = tpx_dsr_thr;
@@ -97,10 +144,16 @@ void _Mem::init(uint64_t base_period,
     this->sim_time_horizon = sim_time_horizon;
     this->tpx_time_horizon = tpx_time_horizon;
     this->perf_sampling_period = perf_sampling_period;
+    this->perf_stats_file = perf_stats_file;
     this->float_tolerance = float_tolerance;
     this->time_tolerance = time_tolerance;
     this->primary_thz = primary_thz * 1000000;
     this->secondary_thz = secondary_thz * 1000000;
+    this->hash_consing = hash_consing;
+    this->memory_soft_budget = memory_soft_budget * 1024;
+    this->memory_hard_budget = memory_hard_budget * 1024;
+    this->group_memory_soft_budget = group_memory_soft_budget * 1024;
+    this->group_memory_hard_budget = group_memory_hard_budget * 1024;
     this->debug = debug;
 
     if (debug) {
@@ -111,9 +164,10 @@ void _Mem::init(uint64_t base_period,
 
     this->goal_pred_success_res = goal_pred_success_res;
     this->probe_level = probe_level;
-    reduction_job_count = time_job_count = 0;
-    reduction_job_avg_latency = _reduction_job_avg_latency = 0;
-    time_job_avg_latency = _time_job_avg_latency = 0;
+    _reduction_job_avg_latency = _time_job_avg_latency = 0;
+    reduction_job_tail_latency = 0;
+    memory_footprint = 0;
+    evicted_view_count = 0;
 }
 
 ////////////////////////////////////////////////////////////////
@@ -148,17 +202,76 @@ _Mem::State _Mem::check_state()
     return s;
 }
 
-void _Mem::start_core()
+void _Mem::spawn_reduction_core()
+{
+    for (uint64_t i = 0; i < m_reductionCoreSlots.size(); ++i) {
+        if (m_reductionCoreSlots[i]) {
+            continue;
+        }
+
+        if (m_reductionCoreThreads[i].joinable()) { // the previous core in this slot has exited.
+            m_reductionCoreThreads[i].join();
+        }
+
+        m_reductionCoreSlots[i] = true;
+        m_reductionCoreThreads[i] = std::thread(&r_exec::runReductionCore, i);
+        ++reduction_core_target;
+        return;
+    }
+}
+
+void _Mem::release_reduction_core(uint64_t core)
 {
-    std::unique_lock<std::mutex> guard(m_coreCountMutex);
-    m_coreCount++;
+    std::lock_guard<std::mutex> guard(m_reductionCoreMutex);
+    m_reductionCoreSlots[core] = false;
 }
 
-void _Mem::shutdown_core()
+void _Mem::pin_core(bool reduction, uint64_t core)
 {
-    std::unique_lock<std::mutex> guard(m_coreCountMutex);
-    m_coreCount--;
-    m_coresRunning.notify_all();
+    const std::vector<uint64_t> &cpus = reduction ? reduction_core_cpus : time_core_cpus;
+    bool pinned = true;
+
+    if (numa) { // spread the cores round robin over the nodes of their cpus.
+        pinned = CPUAffinity::PinToNode(cpus, core);
+    } else if (!cpus.empty()) {
+        pinned = CPUAffinity::Pin(cpus);
+    }
+
+    if (!pinned) {
+        LOG_WARNING << (reduction ? "reduction" : "time") << " core " << core << " could not be pinned";
+    }
+}
+
+void _Mem::scale_reduction_cores()
+{
+    static const uint64_t IdlePeriods = 20; // before shrinking the pool.
+    uint64_t latency = reduction_job_tail_latency.load(std::memory_order_relaxed); // last sample.
+    size_t depth = m_reductionJobPipe.size();
+    std::lock_guard<std::mutex> stateGuard(m_stateMutex);
+
+    if (state != RUNNING) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(m_reductionCoreMutex);
+
+    if (depth > reduction_core_target || (depth > 0 && latency > base_period)) { // jobs wait: grow.
+        reduction_core_idle_periods = 0;
+
+        if (reduction_core_target < max_reduction_core_count) {
+            spawn_reduction_core();
+            LOG_DEBUG << "reduction cores: " << reduction_core_target << " (" << depth << " jobs pending)";
+        }
+    } else if (depth == 0 && latency < base_period) { // idle: shrink, slowly.
+        if (++reduction_core_idle_periods >= IdlePeriods && reduction_core_target > min_reduction_core_count) {
+            pushReductionJob(new ShutdownReductionCore()); // the first core to pop it exits.
+            --reduction_core_target;
+            reduction_core_idle_periods = 0;
+            LOG_DEBUG << "reduction cores: " << reduction_core_target << " (idle)";
+        }
+    } else {
+        reduction_core_idle_periods = 0;
+    }
 }
 
 ////////////////////////////////////////////////////////////////
@@ -214,7 +327,7 @@ bool _Mem::load(std::vector<r_code::Code *> *objects, uint64_t stdin_oid, uint64
             break;
         }
 
-        std::unordered_set<r_code::View *, r_code::View::Hash, r_code::View::Equal>::const_iterator v;
+        r_code::Code::ViewSet::const_iterator v;
 
         for (v = object->views.begin(); v != object->views.end(); ++v) {
             // init hosts' member_set.
@@ -267,11 +380,22 @@ uint64_t _Mem::start()
         return 0;
     }
 
-    m_coreCount = 0;
     std::vector<std::pair<View *, Group *> > initial_reduction_jobs;
     uint64_t i;
     uint64_t now = Now();
     Utils::SetTimeReference(now);
+    m_timeJobWheel.reset(now);
+    m_reductionJobPipe.configure(reduction_job_affinity, reduction_job_priority, reduction_job_aging_window, reduction_job_capacity, reduction_job_overflow, numa ? CPUAffinity::GetNodeCount() : 0);
+    m_reductionJobPipe.reset(max_reduction_core_count);
+
+    if (Now == &VirtualTime::Now) { // the time cores move the clock when there is nothing left to do.
+        m_timeJobWheel.set_virtual_time([this]() {
+            return m_reductionJobPipe.idle();
+        });
+        m_reductionJobPipe.set_idle_callback([this]() {
+            m_timeJobWheel.wake();
+        });
+    }
     ModelBase::Get()->set_thz(secondary_thz);
     init_timings(now);
 
@@ -280,60 +404,79 @@ uint64_t _Mem::start()
         bool c_active = g->get_c_act() > g->get_c_act_thr();
         bool c_salient = g->get_c_sln() > g->get_c_sln_thr();
         FOR_ALL_VIEWS_BEGIN(g, v)
-        Utils::SetIndirectTimestamp<View>(v->second, VIEW_IJT, now); // init injection time for the view.
+        v->set_ijt(now); // init injection time for the view.
         FOR_ALL_VIEWS_END
 
         if (c_active) {
-            std::unordered_map<uint64_t, P<View> >::const_iterator v;
-
             // build signaling jobs for active input-less overlays.
-            for (v = g->input_less_ipgm_views.begin(); v != g->input_less_ipgm_views.end(); ++v) {
-                if (v->second->controller != nullptr && v->second->controller->is_activated()) {
-                    pushTimeJob(new InputLessPGMSignalingJob(v->second, now + Utils::GetTimestamp<Code>(v->second->object, IPGM_TSC)));
-                }
+            FOR_VIEWS_OF_KINDS_BEGIN(g, v, ViewIndex::INPUT_LESS_IPGM, ViewIndex::INPUT_LESS_IPGM + 1)
+
+            if (v->controller != nullptr && v->controller->is_activated()) {
+                ((_PGMController *)v->controller)->push_signaling_job(new InputLessPGMSignalingJob(v, now + Utils::GetTimestamp<Code>(v->object, IPGM_TSC)));
             }
 
+            FOR_ALL_VIEWS_END
             // build signaling jobs for active anti-pgm overlays.
-            for (v = g->anti_ipgm_views.begin(); v != g->anti_ipgm_views.end(); ++v) {
-                if (v->second->controller != nullptr && v->second->controller->is_activated()) {
-                    pushTimeJob(new AntiPGMSignalingJob(v->second, now + Utils::GetTimestamp<Code>(v->second->object, IPGM_TSC)));
-                }
+            FOR_VIEWS_OF_KINDS_BEGIN(g, v, ViewIndex::ANTI_IPGM, ViewIndex::ANTI_IPGM + 1)
+
+            if (v->controller != nullptr && v->controller->is_activated()) {
+                ((_PGMController *)v->controller)->push_signaling_job(new AntiPGMSignalingJob(v, now + Utils::GetTimestamp<Code>(v->object, IPGM_TSC)));
             }
+
+            FOR_ALL_VIEWS_END
         }
 
         if (c_salient) {
             // build reduction jobs for each salient view and each active overlay - regardless of the view's sync mode.
             FOR_ALL_VIEWS_BEGIN(g, v)
 
-            if (v->second->get_sln() > g->get_sln_thr()) { // salient view.
-                g->newly_salient_views.insert(v->second);
-                initial_reduction_jobs.push_back(std::pair<View *, Group *>(v->second, g));
+            if (v->get_sln() > g->get_sln_thr()) { // salient view.
+                g->newly_salient_views.insert(v);
+                initial_reduction_jobs.push_back(std::pair<View *, Group *>(v, g));
             }
 
             FOR_ALL_VIEWS_END
         }
 
         if (g->get_upr() > 0) { // inject the next update job for the group.
-            pushTimeJob(new UpdateJob(g, g->get_next_upr_time(now)));
+            g->push_update_job(g->get_next_upr_time(now));
         }
     }
 
     initial_groups.clear();
     state = RUNNING;
+    pushTimeJob(new UpdateTickJob(now + base_period, base_period));
     pushTimeJob(new PerfSamplingJob(now + perf_sampling_period, perf_sampling_period));
 
-    for (i = 0; i < reduction_core_count; ++i) {
-        m_coreThreads.push_back(std::thread(&r_exec::runReductionCore));
+    if (min_reduction_core_count < max_reduction_core_count) {
+        pushTimeJob(new CoreScalingJob(now + base_period, base_period));
     }
 
-    for (i = 0; i < time_core_count; ++i) {
-        m_coreThreads.push_back(std::thread(&r_exec::runTimeCore));
+    if (reclamation_period > 0) {
+        r_code::Reclaimer::Start(reclamation_period);
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_reductionCoreMutex);
+        m_reductionCoreThreads.resize(max_reduction_core_count);
+        m_reductionCoreSlots.assign(max_reduction_core_count, false);
+        reduction_core_target = 0;
+        reduction_core_idle_periods = 0;
+
+        for (i = 0; i < reduction_core_count; ++i) {
+            spawn_reduction_core();
+        }
     }
 
+    // before the time cores: in virtual time, they would see an idle pipe and move the clock.
     for (auto & initial_reduction_job : initial_reduction_jobs) {
         initial_reduction_job.second->inject_reduction_jobs(initial_reduction_job.first);
     }
 
+    for (i = 0; i < time_core_count; ++i) {
+        m_coreThreads.push_back(std::thread(&r_exec::runTimeCore, i));
+    }
+
     return now;
 }
 
@@ -349,10 +492,15 @@ void _Mem::stop()
     // We need to do this because things are wait()ing
     uint64_t i;
 
-    for (i = 0; i < reduction_core_count; ++i) {
+    m_reductionCoreMutex.lock();
+
+    for (i = 0; i < reduction_core_target; ++i) {
         pushReductionJob(new ShutdownReductionCore());
     }
 
+    reduction_core_target = 0;
+    m_reductionCoreMutex.unlock();
+
     for (i = 0; i < time_core_count; ++i) {
         pushTimeJob(new ShutdownTimeCore());
     }
@@ -365,14 +513,30 @@ void _Mem::stop()
         m_coreThreads[i].join();
     }
 
-    std::unique_lock<std::mutex> lock(m_coreCountMutex);
-
-    if (m_coreCount > 0) {
-        m_coresRunning.wait(lock);
+    for (i = 0; i < m_reductionCoreThreads.size(); ++i) {
+        if (m_reductionCoreThreads[i].joinable()) {
+            m_reductionCoreThreads[i].join();
+        }
     }
+
     LOG_DEBUG << "_Mem::_stop() clearing core threads...";
 
     m_coreThreads.clear();
+    m_reductionCoreThreads.clear();
+    m_timeJobWheel.reset(Now()); // release the jobs still waiting for their deadline.
+    m_reductionJobPipe.reset(0); // and those no core got to.
+
+    std::lock_guard<std::mutex> guard(m_groupUpdateMutex);
+
+    for (auto &updates : group_updates) {
+        for (auto &group : updates.second) {
+            group->next_update_time = Utils::MaxTime;
+        }
+    }
+
+    group_updates.clear();
+    r_code::Reclaimer::Stop(); // deletes what the cores released last.
+    LOG_DEBUG << "_Mem::_stop() " << r_code::Reclaimer::GetReclaimedCount() << " objects deleted by the reclaimer";
 }
 
 ////////////////////////////////////////////////////////////////
@@ -383,7 +547,7 @@ _ReductionJob *_Mem::popReductionJob()
         return nullptr;
     }
 
-    return m_reductionJobQueue.popJob();
+    return m_reductionJobPipe.pop();
 }
 
 void _Mem::pushReductionJob(_ReductionJob *j)
@@ -393,7 +557,7 @@ void _Mem::pushReductionJob(_ReductionJob *j)
     }
 
     j->ijt = Now();
-    m_reductionJobQueue.pushJob(j);
+    m_reductionJobPipe.push(j);
 }
 
 TimeJob *_Mem::popTimeJob()
@@ -402,7 +566,7 @@ TimeJob *_Mem::popTimeJob()
         return nullptr;
     }
 
-    return m_timeJobQueue.popJob();
+    return m_timeJobWheel.pop();
 }
 
 void _Mem::pushTimeJob(r_exec::TimeJob *j)
@@ -411,7 +575,18 @@ void _Mem::pushTimeJob(r_exec::TimeJob *j)
         return;
     }
 
-    m_timeJobQueue.pushJob(j);
+    m_timeJobWheel.push(j);
+}
+
+void _Mem::pushTimeJob(r_exec::TimeJob *j, P<TimeJobHandle> &handle)
+{
+    handle = j->get_handle(); // before the job can run and be released.
+    pushTimeJob(j);
+}
+
+void _Mem::cancelTimeJob(r_exec::TimeJob *j)
+{
+    m_timeJobWheel.cancel(j);
 }
 
 ////////////////////////////////////////////////////////////////
@@ -432,6 +607,111 @@ void _Mem::inject_copy(View *view, Group *destination)
     inject_existing_object(copied_view, view->object, destination);
 }
 
+void _Mem::schedule_group_update(Group *group, uint64_t time)
+{
+    std::lock_guard<std::mutex> guard(m_groupUpdateMutex);
+
+    if (time >= group->next_update_time) {
+        return;
+    }
+
+    P<Group> _group = group; // holds the group while it is moved.
+
+    if (group->next_update_time != Utils::MaxTime) {
+        std::vector<P<Group> > &updates = group_updates[group->next_update_time];
+        updates.erase(std::find(updates.begin(), updates.end(), _group));
+
+        if (updates.empty()) {
+            group_updates.erase(group->next_update_time);
+        }
+    }
+
+    group->next_update_time = time;
+    group_updates[time].push_back(_group);
+}
+
+void _Mem::unschedule_group_update(Group *group)
+{
+    std::lock_guard<std::mutex> guard(m_groupUpdateMutex);
+
+    if (group->next_update_time == Utils::MaxTime) {
+        return;
+    }
+
+    P<Group> _group = group;
+    std::vector<P<Group> > &updates = group_updates[group->next_update_time];
+    updates.erase(std::find(updates.begin(), updates.end(), _group));
+
+    if (updates.empty()) {
+        group_updates.erase(group->next_update_time);
+    }
+
+    group->next_update_time = Utils::MaxTime;
+}
+
+// Share of a global budget for a group holding footprint bytes.
+static uint64_t GetShare(uint64_t budget, uint64_t footprint, int64_t global_footprint)
+{
+    if (budget == 0 || global_footprint <= (int64_t)budget) { // not exceeded: no constraint on the group.
+        return 0;
+    }
+
+    return (uint64_t)((double)budget * footprint / global_footprint);
+}
+
+// The tighter of two budgets; 0: none.
+static uint64_t Tighter(uint64_t budget, uint64_t other_budget)
+{
+    if (budget == 0) {
+        return other_budget;
+    }
+
+    if (other_budget == 0) {
+        return budget;
+    }
+
+    return std::min(budget, other_budget);
+}
+
+void _Mem::get_memory_budgets(uint64_t footprint, uint64_t &soft_budget, uint64_t &hard_budget) const
+{
+    int64_t global_footprint = memory_footprint.load(std::memory_order_relaxed);
+    soft_budget = Tighter(group_memory_soft_budget, GetShare(memory_soft_budget, footprint, global_footprint));
+    hard_budget = Tighter(group_memory_hard_budget, GetShare(memory_hard_budget, footprint, global_footprint));
+}
+
+void _Mem::report_footprint(int64_t delta, uint64_t evicted_view_count)
+{
+    memory_footprint.fetch_add(delta, std::memory_order_relaxed);
+
+    if (evicted_view_count > 0) {
+        this->evicted_view_count.fetch_add(evicted_view_count, std::memory_order_relaxed);
+    }
+}
+
+void _Mem::update_groups(uint64_t time)
+{
+    P<GroupUpdateBatch> batch = new GroupUpdateBatch();
+    bool empty = true;
+    {
+        std::lock_guard<std::mutex> guard(m_groupUpdateMutex);
+
+        while (!group_updates.empty() && group_updates.begin()->first <= time) {
+            for (auto &group : group_updates.begin()->second) {
+                group->next_update_time = Utils::MaxTime; // the update may schedule the next one.
+                batch->add(group, group_updates.begin()->first);
+                empty = false;
+            }
+
+            group_updates.erase(group_updates.begin());
+        }
+    }
+
+    if (!empty) { // the groups are locked (to be sorted) once m_groupUpdateMutex is released.
+        batch->start();
+    }
+}
+
 void _Mem::inject_existing_object(View *view, Code *object, Group *host)
 {
     view->set_object(object); // the object already exists (content-wise): have the view point to the existing one.
@@ -472,6 +752,22 @@ void _Mem::inject_new_object(View *view)
     }
 }
 
+bool _Mem::exists(Code *object)
+{
+    if (object->is_registered()) {
+        return true;
+    }
+
+    if (!hash_consing) { // MemVolatile: only the objects reused by check_existence() are told apart.
+        return false;
+    }
+
+    object->acq_views();
+    bool viewed = object->views.size() > 0;
+    object->rel_views();
+    return viewed;
+}
+
 void _Mem::inject(View *view)
 {
     if (view->object->is_invalidated()) {
@@ -487,7 +783,7 @@ void _Mem::inject(View *view)
     uint64_t now = Now();
     uint64_t ijt = view->get_ijt();
 
-    if (view->object->is_registered()) { // existing object.
+    if (exists(view->object)) { // existing object.
         if (ijt <= now) {
             inject_existing_object(view, view->object, host);
         } else {
@@ -521,7 +817,7 @@ void _Mem::inject_async(View *view)
         P<_ReductionJob> j = new AsyncInjectionJob(view);
         pushReductionJob(j);
     } else {
-        if (view->object->is_registered()) { // existing object.
+        if (exists(view->object)) { // existing object.
             pushTimeJob(new EInjectionJob(view, ijt));
         } else {
             pushTimeJob(new InjectionJob(view, ijt));
@@ -550,51 +846,86 @@ void _Mem::inject_notification(View *view, bool lock)   // no notification for n
 
 ////////////////////////////////////////////////////////////////
 
-void _Mem::register_reduction_job_latency(uint64_t latency)
-{
-    std::lock_guard<std::mutex> guard(m_reductionJobMutex);
-    ++reduction_job_count;
-    reduction_job_avg_latency += latency;
-}
-
-void _Mem::register_time_job_latency(uint64_t latency)
-{
-    std::lock_guard<std::mutex> guard(m_timeJobMutex);
-    ++time_job_count;
-    time_job_avg_latency += latency;
-}
-
 void _Mem::inject_perf_stats()
 {
-    m_reductionJobMutex.lock();
-    m_timeJobMutex.lock();
-    int64_t d_reduction_job_avg_latency;
+    uint64_t now = Now();
+    std::vector<JobStats::Sample> samples;
+    job_stats.collect(samples);
+    LatencyDistribution reduction_job_latency; // all classes merged.
+    LatencyDistribution time_job_latency;
+    std::ofstream stats_file;
 
-    if (reduction_job_count > 0) {
-        reduction_job_avg_latency /= reduction_job_count;
-        d_reduction_job_avg_latency = reduction_job_avg_latency - _reduction_job_avg_latency;
-    } else {
-        reduction_job_avg_latency = d_reduction_job_avg_latency = 0;
+    if (!perf_stats_file.empty()) {
+        stats_file.open(perf_stats_file, std::ios::app);
+
+        if (stats_file.tellp() == 0) {
+            stats_file << "time\tjob\tmetric\tcount\tmean\tp50\tp99\tp999" << std::endl;
+        }
     }
 
-    int64_t d_time_job_avg_latency;
+    for (const JobStats::Sample &s : samples) {
+        if (s.metric == JobStats::WAIT) {
+            reduction_job_latency.add(s.distribution);
+        } else if (s.metric == JobStats::LATENESS) {
+            time_job_latency.add(s.distribution);
+        }
 
-    if (time_job_count > 0) {
-        time_job_avg_latency /= time_job_count;
-        d_time_job_avg_latency = time_job_avg_latency - _time_job_avg_latency;
-    } else {
-        time_job_avg_latency = d_time_job_avg_latency = 0;
+        if (stats_file.is_open()) {
+            stats_file << now - Utils::GetTimeReference() << "\t" << s.job_class << "\t" << JobStats::MetricName(s.metric) << "\t" << s.distribution.count << "\t" << s.distribution.mean() << "\t" << s.distribution.percentile(0.5) << "\t" << s.distribution.percentile(0.99) << "\t" << s.distribution.percentile(0.999) << std::endl;
+        } else {
+            LOG_DEBUG << "job latency (us) " << s.job_class << " " << JobStats::MetricName(s.metric) << ": " << s.distribution.count << " jobs, mean " << s.distribution.mean() << ", p50 " << s.distribution.percentile(0.5) << ", p99 " << s.distribution.percentile(0.99) << ", p999 " << s.distribution.percentile(0.999);
+        }
     }
 
+    // the perf class has a fixed arity: the means go there, the percentiles to the stats file or the log.
+    uint64_t reduction_job_avg_latency = reduction_job_latency.mean();
+    int64_t d_reduction_job_avg_latency = reduction_job_latency.count > 0 ? (int64_t)(reduction_job_avg_latency - _reduction_job_avg_latency) : 0;
+    uint64_t time_job_avg_latency = time_job_latency.mean();
+    int64_t d_time_job_avg_latency = time_job_latency.count > 0 ? (int64_t)(time_job_avg_latency - _time_job_avg_latency) : 0;
     Code *perf = new Perf(reduction_job_avg_latency, d_reduction_job_avg_latency, time_job_avg_latency, d_time_job_avg_latency);
-    // reset stats.
-    reduction_job_count = time_job_count = 0;
     _reduction_job_avg_latency = reduction_job_avg_latency;
     _time_job_avg_latency = time_job_avg_latency;
-    m_timeJobMutex.unlock();
-    m_reductionJobMutex.unlock();
+    reduction_job_tail_latency.store(reduction_job_latency.percentile(0.99), std::memory_order_relaxed);
+    // the state of the reduction pipe and the memory footprint go to the stats file too (in the count column), and
+    // to the log when critical.
+    uint64_t dropped_job_count;
+    uint64_t blocked_job_count;
+    m_reductionJobPipe.get_overflow_stats(dropped_job_count, blocked_job_count);
+    int64_t footprint = memory_footprint.load(std::memory_order_relaxed);
+    uint64_t evicted = evicted_view_count.exchange(0, std::memory_order_relaxed);
+
+    if (stats_file.is_open()) {
+        uint64_t t = now - Utils::GetTimeReference();
+        stats_file << t << "\treduction pipe\tdropped\t" << dropped_job_count << "\t\t\t\t" << std::endl;
+        stats_file << t << "\treduction pipe\tblocked\t" << blocked_job_count << "\t\t\t\t" << std::endl;
+        stats_file << t << "\tmemory\tfootprint (KB)\t" << footprint / 1024 << "\t\t\t\t" << std::endl;
+        stats_file << t << "\tmemory\tevicted views\t" << evicted << "\t\t\t\t" << std::endl;
+    }
+
+    if (dropped_job_count > 0 || blocked_job_count > 0) {
+        LOG_WARNING << "reduction pipe full: " << dropped_job_count << " jobs dropped, " << blocked_job_count << " producers blocked";
+    }
+
+    if ((memory_soft_budget > 0 && footprint > (int64_t)memory_soft_budget) || evicted > 0) {
+        LOG_WARNING << "memory footprint " << footprint / 1024 << " KB (budgets: soft " << memory_soft_budget / 1024 << " KB, hard " << memory_hard_budget / 1024 << " KB), " << evicted << " views evicted";
+    } else {
+        LOG_DEBUG << "memory footprint " << footprint / 1024 << " KB";
+    }
+
+    std::vector<size_t> shard_depths;
+    m_reductionJobPipe.get_shard_depths(shard_depths);
+
+    if (!shard_depths.empty()) {
+        std::string depths;
+
+        for (size_t depth : shard_depths) {
+            depths += " " + std::to_string(depth);
+        }
+
+        LOG_DEBUG << "reduction shard depths:" << depths;
+    }
+
     // inject f->perf in stdin.
-    uint64_t now = Now();
     Code *f_perf = new Fact(perf, now, now + perf_sampling_period, 1, 1);
     View *view = new View(View::SYNC_ONCE, now, 1, 1, _stdin, nullptr, f_perf); // sync front, sln=1, res=1.
     inject(view);
@@ -616,7 +947,7 @@ void _Mem::propagate_sln(Code *object, double change, double source_sln_thr)
         return;
     }
 
-    std::unordered_set<r_code::View *, r_code::View::Hash, r_code::View::Equal>::const_iterator it;
+    r_code::Code::ViewSet::const_iterator it;
 
     for (it = object->views.begin(); it != object->views.end(); ++it) {
         double morphed_sln_change = View::MorphChange(change, source_sln_thr, ((r_exec::View*)*it)->get_host()->get_sln_thr());
@@ -36,14 +36,18 @@
 #include <r_code/object.h>     // for Mem
 #include <r_code/utils.h>      // for Utils
 #include <r_exec/group.h>      // for Group
+#include <r_exec/job_stats.h>  // for JobStats
+#include <r_exec/reduction_pipe.h>  // for ReductionPipe
+#include <r_exec/timer_wheel.h>  // for TimerWheel
 #include <stddef.h>            // for NULL
 #include <stdint.h>            // for uint64_t, uint16_t, int64_t
 #include <atomic>              // for atomic, atomic_int_fast64_t
-#include <condition_variable>  // for condition_variable
 #include <iosfwd>              // for ostream
+#include <map>                 // for map
 #include <mutex>               // for mutex, unique_lock
-#include <queue>               // for queue
+#include <string>              // for string
 #include <thread>              // for thread
+#include <unordered_map>       // for unordered_map
 #include <vector>              // for vector
 
 #include <replicode_common.h>  // for P, REPLICODE_EXPORT
@@ -55,6 +59,7 @@ class Metadata;
 namespace r_exec {
 class Controller;
 class TimeJob;
+class TimeJobHandle;
 class View;
 class _ReductionJob;
 }  // namespace r_exec
@@ -64,6 +69,8 @@ namespace r_exec
 
 // The rMem.
 // Maintains 2 pipes of jobs (injection, update, etc.). each job is processed asynchronously by instances of ReductionCore and TimeCore.
+// The reduction pipe gives each reduction core its own deque, with work stealing between cores.
+// The time pipe is a timer wheel: time cores sleep until the earliest deadline and fire due jobs themselves.
 // Pipes and threads are created at starting time and deleted at stopping time.
 // Groups and IPGMControllers are cleared up when only held by jobs;
 // - when a group is not projected anywhere anymore, it is invalidated (it releases all its views) and when a job attempts an update, the latter is cancelled.
@@ -84,8 +91,19 @@ public:
 protected:
     // Parameters::Init.
     uint64_t base_period;
-    uint64_t reduction_core_count;
+    uint64_t reduction_core_count; // initial count.
+    uint64_t min_reduction_core_count;
+    uint64_t max_reduction_core_count;
     uint64_t time_core_count;
+    std::vector<uint64_t> reduction_core_cpus; // the reduction cores are pinned to these; empty: not pinned.
+    std::vector<uint64_t> time_core_cpus; // same for the time cores.
+    bool numa; // pin each core to one node and route the jobs for a group to its node (see CPUAffinity).
+    uint64_t reclamation_period; // 0: no reclaimer thread (see r_code::Reclaimer).
+    bool reduction_job_affinity; // route the jobs of a controller to one core at a time (see ReductionPipe).
+    bool reduction_job_priority; // schedule reduction jobs by urgency instead of FIFO (see ReductionPipe).
+    uint64_t reduction_job_aging_window; // in us; with priority scheduling, how long a job can be overtaken.
+    uint64_t reduction_job_capacity; // max number of jobs waiting in the shared queue, in a shard or in the heap.
+    ReductionPipe::OverflowPolicy reduction_job_overflow; // what to do when they are full.
 
     // Parameters::System.
     double mdl_inertia_sr_thr;
@@ -96,10 +114,16 @@ protected:
     double sim_time_horizon;
     uint64_t tpx_time_horizon;
     uint64_t perf_sampling_period;
+    std::string perf_stats_file; // the latency percentiles are appended there; empty: they go to the log.
     double float_tolerance;
     uint64_t time_tolerance;
     uint64_t primary_thz;
     uint64_t secondary_thz;
+    bool hash_consing; // see Mem::check_existence().
+    uint64_t memory_soft_budget; // in bytes, for all groups; 0: none (see get_memory_budgets()).
+    uint64_t memory_hard_budget;
+    uint64_t group_memory_soft_budget; // in bytes, for each group; 0: none.
+    uint64_t group_memory_hard_budget;
 
     // Parameters::Debug.
     bool debug;
@@ -109,77 +133,31 @@ protected:
     // Parameters::Run.
     uint64_t probe_level;
 
-    template <class Type> struct JobQueue {
-        void pushJob(Type *job)
-        {
-            std::unique_lock<std::mutex> lock(m_pushMutex);
-            m_mutex.lock();
+    ReductionPipe m_reductionJobPipe;
+    TimerWheel m_timeJobWheel;
 
-            while (m_jobs.size() > 1024) { // while, because spurious wakeups
-                m_mutex.unlock();
-                m_canPushCondition.wait(lock);
-                m_mutex.lock();
-            }
+    std::vector<std::thread> m_coreThreads; // time cores.
 
-            m_jobs.push(job);
+    // Elastic pool of reduction cores: core i runs in m_reductionCoreThreads[i] and uses the i-th deque of the pipe.
+    std::vector<std::thread> m_reductionCoreThreads;
+    std::vector<bool> m_reductionCoreSlots; // true from the spawning of a core to its exit.
+    uint64_t reduction_core_target; // cores running, minus those asked to shut down.
+    uint64_t reduction_core_idle_periods; // consecutive scaling periods without pending jobs.
+    std::mutex m_reductionCoreMutex;
 
-            if (m_jobs.size() == 1) {
-                m_canPopCondition.notify_all();
-            }
+    void spawn_reduction_core(); // m_reductionCoreMutex locked.
 
-            m_mutex.unlock();
-        }
-
-        Type *popJob()
-        {
-            std::unique_lock<std::mutex> lock(m_popMutex);
-            m_mutex.lock();
-
-            while (m_jobs.size() < 1) { // while, because of spurious wakeups
-                m_mutex.unlock();
-                m_canPopCondition.wait(lock);
-                m_mutex.lock();
-            }
-
-            Type *r = m_jobs.front();
-            m_jobs.pop();
-
-            if (m_jobs.size() < 1024) {
-                m_canPushCondition.notify_all();
-            }
-
-            m_mutex.unlock();
-            return r;
-        }
-
-    private:
-        std::mutex m_mutex;
-        std::queue<Type*> m_jobs;
-
-        std::mutex m_pushMutex;
-        std::condition_variable m_canPushCondition;
-        std::mutex m_popMutex;
-        std::condition_variable m_canPopCondition;
-    };
-
-    JobQueue<_ReductionJob> m_reductionJobQueue;
-    JobQueue<TimeJob> m_timeJobQueue;
-    std::mutex m_timeJobMutex;
-    std::mutex m_reductionJobMutex;
-
-    std::vector<std::thread> m_coreThreads;
+    // Group updates: at most one pending per group (see Group::next_update_time), run by an UpdateTickJob.
+    std::map<uint64_t, std::vector<P<Group> > > group_updates; // by planned time.
+    std::mutex m_groupUpdateMutex; // never locked before a group's mutex.
 
     // Performance stats.
-    uint64_t reduction_job_count;
-    uint64_t reduction_job_avg_latency; // latency: popping time.-pushing time; the lower the better.
-    uint64_t _reduction_job_avg_latency; // previous value.
-    uint64_t time_job_count;
-    uint64_t time_job_avg_latency; // latency: deadline-the time the job is popped from the pipe; if <0, not registered (as it is too late for action); the higher the better.
-    uint64_t _time_job_avg_latency; // previous value.
-
-    std::atomic<uint64_t> m_coreCount;
-    std::condition_variable m_coresRunning;
-    std::mutex m_coreCountMutex; // blocks the rMem until all cores terminate.
+    JobStats job_stats; // latency histograms, per core and per job class; merged every perf_sampling_period.
+    uint64_t _reduction_job_avg_latency; // previous value of the mean wait: popping time-pushing time; the lower the better.
+    uint64_t _time_job_avg_latency; // previous value of the mean lateness: the time the job fires-its deadline; the lower the better.
+    std::atomic<uint64_t> reduction_job_tail_latency; // p99 of the wait over the last sampling period.
+    std::atomic<int64_t> memory_footprint; // sum of the footprints of the groups (see Group::update()).
+    std::atomic<uint64_t> evicted_view_count; // since the last sampling period.
 
     State state;
     std::mutex m_stateMutex;
@@ -223,7 +201,18 @@ public:
 
     void init(uint64_t base_period,
               uint64_t reduction_core_count,
+              uint64_t min_reduction_core_count,
+              uint64_t max_reduction_core_count,
               uint64_t time_core_count,
+              const std::vector<uint64_t> &reduction_core_cpus,
+              const std::vector<uint64_t> &time_core_cpus,
+              bool numa,
+              uint64_t reclamation_period,
+              bool reduction_job_affinity,
+              bool reduction_job_priority,
+              uint64_t reduction_job_aging_window,
+              uint64_t reduction_job_capacity,
+              ReductionPipe::OverflowPolicy reduction_job_overflow,
               double mdl_inertia_sr_thr,
               uint64_t mdl_inertia_cnt_thr,
               double tpx_dsr_thr,
@@ -232,10 +221,16 @@ public:
               double sim_time_horizon,
               uint64_t tpx_time_horizon,
               uint64_t perf_sampling_period,
+              const std::string &perf_stats_file,
               double float_tolerance,
               uint64_t time_tolerance,
               uint64_t primary_thz,
               uint64_t secondary_thz,
+              bool hash_consing,
+              uint64_t memory_soft_budget,
+              uint64_t memory_hard_budget,
+              uint64_t group_memory_soft_budget,
+              uint64_t group_memory_hard_budget,
               bool debug,
               uint64_t ntf_mk_res,
               uint64_t goal_pred_success_res,
@@ -310,9 +305,10 @@ public:
     r_code::Code *get_stdout() const;
     r_code::Code *get_self() const;
 
-    State check_state(); // called by delegates after waiting in case stop() is called in the meantime.
-    void start_core(); // called upon creation of a delegate.
-    void shutdown_core(); // called upon completion of a delegate's task.
+    State check_state(); // called by time cores after waiting in case stop() is called in the meantime.
+    void scale_reduction_cores(); // called periodically by a CoreScalingJob.
+    void release_reduction_core(uint64_t core); // called by a reduction core upon exiting.
+    void pin_core(bool reduction, uint64_t core); // called by a core upon starting.
 
     /// call before start; no mod/set/eje will be executed (only inj);
     /// no cov at init time.
@@ -323,12 +319,15 @@ public:
 
     // Internal core processing ////////////////////////////////////////////////////////////////
 
-    _ReductionJob *popReductionJob();
-    void pushReductionJob(_ReductionJob *j);
-    TimeJob *popTimeJob();
-    void pushTimeJob(TimeJob *j);
+    _ReductionJob *popReductionJob(); // blocks until a job is available; the caller owns a reference to the job.
+    void pushReductionJob(_ReductionJob *j); // the pipe holds a reference to the job until it is popped.
+    TimeJob *popTimeJob(); // blocks until a job is due; the caller owns a reference to the job.
+    void pushTimeJob(TimeJob *j); // the pipe holds a reference to the job until it is popped.
+    void pushTimeJob(TimeJob *j, P<TimeJobHandle> &handle); // also returns a handle to cancel the job.
+    void cancelTimeJob(TimeJob *j); // called by TimeJobHandle::cancel().
 
     // Called upon successful reduction.
+    bool exists(r_code::Code *object); // injected already: registered (MemStatic), or hash-consed and viewed.
     void inject(View *view);
     void inject_async(View *view);
     void inject_new_object(View *view);
@@ -342,10 +341,23 @@ public:
 
     // Called by groups.
     void inject_copy(View *view, Group *destination); // for cov; NB: no cov for groups, r-groups, models, pgm or notifications.
+    void schedule_group_update(Group *group, uint64_t time); // an earlier update prevails.
+    // Budgets for a group holding footprint bytes: its own budgets, tightened to its share of the global budgets
+    // (pro rata of the global footprint); 0: none.
+    // Past the soft budget, the views that are not salient lose their resilience faster; past the hard one, views are
+    // evicted, the least salient first (see Group::update() and Group::account()).
+    void get_memory_budgets(uint64_t footprint, uint64_t &soft_budget, uint64_t &hard_budget) const;
+    void report_footprint(int64_t delta, uint64_t evicted_view_count);
+    void unschedule_group_update(Group *group);
+
+    // Called by the UpdateTickJob: updates the groups due by time.
+    void update_groups(uint64_t time);
 
     // Called by cores.
-    void register_reduction_job_latency(uint64_t latency);
-    void register_time_job_latency(uint64_t latency);
+    JobStats &get_job_stats()
+    {
+        return job_stats;
+    }
     void inject_perf_stats();
 
     // rMem to rMem.
@@ -429,6 +441,35 @@ public:
 template<class O, class S> class Mem:
     public S
 {
+private:
+    // Hash-consing table: the objects produced by programs, keyed on their content (O::Hash, O::Equal), sharded by
+    // hash value. The table holds the objects until they are invalidated or lose all their views (checked as the
+    // shards grow).
+    static const uint64_t ConsShardCount = 16;
+
+    class ConsEntry
+    {
+    public:
+        P<O> object;
+        uint64_t touch_time; // last time the object was produced.
+        ConsEntry(O *object, uint64_t touch_time): object(object), touch_time(touch_time) {}
+    };
+
+    class ConsShard
+    {
+    public:
+        std::mutex mutex;
+        std::unordered_map<O *, ConsEntry, typename O::Hash, typename O::Equal> objects;
+        size_t trim_size; // the shard is trimmed when it reaches that size.
+        ConsShard(): trim_size(MinConsTrimSize) {}
+    };
+
+    static const size_t MinConsTrimSize = 64;
+
+    ConsShard cons_shards[ConsShardCount];
+
+    r_code::Code *cons(O *object);
+    void trim(ConsShard &shard, uint64_t now);
 public:
     Mem();
     virtual ~Mem();
@@ -53,6 +53,10 @@ template<class O, class S> Mem<O, S>::~Mem()
 
     this->deleted = true;
     this->objects.clear();
+
+    for (uint64_t i = 0; i < ConsShardCount; ++i) {
+        cons_shards[i].objects.clear();
+    }
 }
 
 ////////////////////////////////////////////////////////////////
@@ -170,7 +174,80 @@ template<class O, class S> Code *Mem<O, S>::check_existence(Code *object)
         _object = (O *)object;
     }
 
-    return _object;
+    if (!this->hash_consing) {
+        return _object;
+    }
+
+    O *consed = dynamic_cast<O *>(object); // notifications and some markers are built as mere r_code::LObjects.
+
+    if (!consed) {
+        return _object;
+    }
+
+    return cons(consed);
+}
+
+// Returns the existing object if it has been injected already, object otherwise. An existing object that has not
+// been injected yet (e.g. still waiting for its injection time) is not reused: object is a duplicate.
+template<class O, class S> Code *Mem<O, S>::cons(O *object)
+{
+    uint64_t hash = typename O::Hash()(object);
+    ConsShard &shard = cons_shards[(hash ^ (hash >> 32)) % ConsShardCount];
+    uint64_t now = Now();
+    P<Code> discarded; // deleted once the shard is unlocked.
+    std::lock_guard<std::mutex> guard(shard.mutex);
+    auto e = shard.objects.find(object);
+
+    if (e != shard.objects.end()) {
+        O *existing = e->first;
+
+        if (!existing->is_invalidated()) {
+            if (!this->exists(existing)) {
+                return object;
+            }
+
+            e->second.touch_time = now;
+            discarded = object;
+            return existing;
+        }
+
+        shard.objects.erase(e);
+    }
+
+    shard.objects.emplace(object, ConsEntry(object, now));
+
+    if (shard.objects.size() >= shard.trim_size) {
+        trim(shard, now);
+    }
+
+    return object;
+}
+
+// Drops the invalidated objects, and the objects left without views that were not produced during the last period.
+template<class O, class S> void Mem<O, S>::trim(ConsShard &shard, uint64_t now)
+{
+    for (auto e = shard.objects.begin(); e != shard.objects.end();) {
+        O *object = e->first;
+        bool keep = !object->is_invalidated();
+
+        if (keep && now - e->second.touch_time > this->base_period) {
+            object->acq_views();
+            keep = object->views.size() > 0;
+            object->rel_views();
+        }
+
+        if (keep) {
+            ++e;
+        } else {
+            e = shard.objects.erase(e);
+        }
+    }
+
+    shard.trim_size = shard.objects.size() * 2;
+
+    if (shard.trim_size < MinConsTrimSize) {
+        shard.trim_size = MinConsTrimSize;
+    }
 }
 
 template<class O, class S> void Mem<O, S>::inject(O *object, View *view)
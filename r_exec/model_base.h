@@ -32,6 +32,7 @@
 #define model_base_h
 
 
+#include <r_code/list.h>        // for list
 #include <stddef.h>            // for size_t
 #include <stdint.h>            // for uint64_t
 #include <mutex>               // for mutex
@@ -41,7 +42,6 @@
 
 namespace r_code {
 class Code;
-template <typename T> class list;
 }  // namespace r_code
 namespace r_exec {
 class _Fact;
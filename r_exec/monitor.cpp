@@ -33,6 +33,7 @@
 #include <r_exec/factory.h>         // for Fact
 #include <r_exec/mdl_controller.h>  // for MDLController
 #include <r_exec/monitor.h>         // for Monitor
+#include <r_exec/time_job.h>        // for TimeJobHandle
 
 #include <replicode_common.h>       // for P, _Object
 
@@ -51,4 +52,11 @@ bool Monitor::is_alive() const
 {
     return !controller->is_invalidated() && controller->is_activated() && !target->is_invalidated();
 }
+
+void Monitor::retire()
+{
+    if (job != nullptr && (controller->is_invalidated() || target->is_invalidated())) { // for good: deactivated controllers may come back.
+        job->cancel();
+    }
+}
 }
@@ -37,6 +37,7 @@
 namespace r_exec {
 class BindingMap;
 class Fact;
+class TimeJobHandle;
 class _Fact;
 }  // namespace r_exec
 
@@ -54,12 +55,19 @@ protected:
 
     MDLController *controller;
 
+    core::P<TimeJobHandle> job; // the monitoring job.
+
     Monitor(MDLController *controller,
             BindingMap *bindings,
             Fact *target); // fact.
 public:
     bool is_alive() const;
     virtual bool reduce(_Fact *input) = 0;
+    void retire(); // called when the controller drops the monitor: cancels the monitoring job if it would not run anyway.
+    TimeJobHandle *get_job() const
+    {
+        return job;
+    }
 };
 }
 
@@ -123,12 +123,16 @@ public:
     class Equal
     {
     public:
-        bool operator()(const U *lhs, const U *rhs) const   // lhs and rhs have the same hash value, i.e. same opcode, same code size and same reference size.
+        bool operator()(const U *lhs, const U *rhs) const
         {
             if (lhs->code(0).asOpcode() == Opcodes::Ent || rhs->code(0).asOpcode() == Opcodes::Ent) {
                 return lhs == rhs;
             }
 
+            if (lhs->code_size() != rhs->code_size() || lhs->references_size() != rhs->references_size()) { // the hash values may still collide.
+                return false;
+            }
+
             uint16_t i;
 
             for (i = 0; i < lhs->references_size(); ++i)
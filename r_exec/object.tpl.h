@@ -60,6 +60,11 @@ template<class C, class U> bool Object<C, U>::invalidate()
 
     invalidated = 1; //std::cout<<std::dec<<get_oid()<<" invalidated\n";
     acq_views();
+
+    for (r_code::View *v : this->views) {
+        v->object_invalidated();
+    }
+
     this->views.clear();
     rel_views();
 
@@ -81,6 +86,25 @@ template<class C, class U> void Object<C, U>::compute_hash_value()
     hash_value = this->code(0).asOpcode() << 20; // 12 bits for the opcode.
     hash_value |= (this->code_size() & 0x00000FFF) << 8; // 12 bits for the code size.
     hash_value |= this->references_size() & 0x000000FF; // 8 bits for the reference set size.
+    // the content spreads the objects of a class over the buckets; the psln_thr is left out as mod and set change it.
+    size_t content = 0;
+    uint16_t psln_thr = this->code(0).getAtomCount();
+
+    for (uint16_t i = 1; i < this->code_size(); ++i) {
+        if (i != psln_thr) {
+            content = content * 31 + this->code(i).atom;
+        }
+    }
+
+    for (uint16_t i = 0; i < this->references_size(); ++i) {
+        content = content * 31 + (size_t)this->get_reference(i);
+    }
+
+    hash_value ^= content * 0x9E3779B97F4A7C15ull;
+
+    if (hash_value == 0) { // 0 means not computed yet.
+        hash_value = 1;
+    }
 }
 
 template<class C, class U> double Object<C, U>::get_psln_thr()
@@ -126,7 +150,7 @@ template<class C, class U> r_code::View *Object<C, U>::get_view(r_code::Code *gr
 
     r_code::View probe;
     probe.references[0] = group;
-    std::unordered_set<r_code::View *, r_code::View::Hash, r_code::View::Equal>::const_iterator v = this->views.find(&probe);
+    typename C::ViewSet::const_iterator v = this->views.find(&probe);
 
     if (v != this->views.end()) {
         if (lock) {
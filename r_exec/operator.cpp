@@ -30,12 +30,13 @@
 
 #include "operator.h"
 
-#include <math.h>             // for fabs, exp, log, log10, pow
-#include <r_code/utils.h>     // for Utils
-#include <r_exec/context.h>   // for IPGMContext
-#include <r_exec/init.h>      // for Now
-#include <r_exec/operator.h>  // for Context, Operator
-#include <stdlib.h>           // for rand
+#include <math.h>                 // for fabs, exp, log, log10, pow
+#include <r_code/utils.h>         // for Utils
+#include <r_exec/context.h>       // for IPGMContext
+#include <r_exec/init.h>          // for Now
+#include <r_exec/operator.h>      // for Context, Operator
+#include <r_exec/operator.tpl.h>  // for _equ, _add, etc
+#include <stdlib.h>               // for rand
 
 
 namespace r_exec
@@ -52,6 +53,55 @@ void Operator::Register(uint16_t opcode, bool (*o)(const Context &, uint16_t &in
     }
 }
 
+uint8_t Operator::GetStd(bool (*o)(const Context &, uint16_t &))
+{
+    if (o == equ) {
+        return EQU;
+    }
+
+    if (o == neq) {
+        return NEQ;
+    }
+
+    if (o == gtr) {
+        return GTR;
+    }
+
+    if (o == lsr) {
+        return LSR;
+    }
+
+    if (o == gte) {
+        return GTE;
+    }
+
+    if (o == lse) {
+        return LSE;
+    }
+
+    if (o == add) {
+        return ADD;
+    }
+
+    if (o == sub) {
+        return SUB;
+    }
+
+    if (o == mul) {
+        return MUL;
+    }
+
+    if (o == div) {
+        return DIV;
+    }
+
+    if (o == dis) {
+        return DIS;
+    }
+
+    return NONE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 bool now(const Context &context, uint16_t &index)
@@ -80,356 +130,77 @@ bool rnd(const Context &context, uint16_t &index)
 
 bool equ(const Context &context, uint16_t &index)
 {
-    Context lhs = *context.getChild(1);
-    Context rhs = *context.getChild(2);
-    bool r = (lhs == rhs);
-    index = context.setAtomicResult(Atom::Boolean(r));
-    return r;
+    return _equ(context, index);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 bool neq(const Context &context, uint16_t &index)
 {
-    bool r = *context.getChild(1) != *context.getChild(2);
-    index = context.setAtomicResult(Atom::Boolean(r));
-    return r;
+    return _neq(context, index);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 bool gtr(const Context &context, uint16_t &index)
 {
-    Context lhs = *context.getChild(1);
-    Context rhs = *context.getChild(2);
-
-    if (lhs[0].isFloat()) {
-        if (rhs[0].isFloat()) {
-            bool r = lhs[0].asFloat() > rhs[0].asFloat();
-            index = context.setAtomicResult(Atom::Boolean(r));
-            return r;
-        }
-    } else if (lhs[0].getDescriptor() == Atom::TIMESTAMP) {
-        if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
-            bool r = Utils::GetTimestamp(&lhs[0]) > Utils::GetTimestamp(&rhs[0]);
-            index = context.setAtomicResult(Atom::Boolean(r));
-            return r;
-        }
-    }
-
-    index = context.setAtomicResult(Atom::UndefinedBoolean());
-    return false;
+    return _gtr(context, index);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 bool lsr(const Context &context, uint16_t &index)
 {
-    Context lhs = *context.getChild(1);
-    Context rhs = *context.getChild(2);
-
-    if (lhs[0].isFloat()) {
-        if (rhs[0].isFloat()) {
-            bool r = lhs[0].asFloat() < rhs[0].asFloat();
-            index = context.setAtomicResult(Atom::Boolean(r));
-            return r;
-        }
-    } else if (lhs[0].getDescriptor() == Atom::TIMESTAMP) {
-        if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
-            bool r = Utils::GetTimestamp(&lhs[0]) < Utils::GetTimestamp(&rhs[0]);
-            index = context.setAtomicResult(Atom::Boolean(r));
-            return r;
-        }
-    }
-
-    index = context.setAtomicResult(Atom::UndefinedBoolean());
-    return false;
+    return _lsr(context, index);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 bool gte(const Context &context, uint16_t &index)
 {
-    Context lhs = *context.getChild(1);
-    Context rhs = *context.getChild(2);
-
-    if (lhs[0].isFloat()) {
-        if (rhs[0].isFloat()) {
-            bool r = lhs[0].asFloat() >= rhs[0].asFloat();
-            index = context.setAtomicResult(Atom::Boolean(r));
-            return r;
-        }
-    } else if (lhs[0].getDescriptor() == Atom::TIMESTAMP) {
-        if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
-            bool r = Utils::GetTimestamp(&lhs[0]) >= Utils::GetTimestamp(&rhs[0]);
-            index = context.setAtomicResult(Atom::Boolean(r));
-            return r;
-        }
-    }
-
-    index = context.setAtomicResult(Atom::UndefinedBoolean());
-    return false;
+    return _gte(context, index);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 bool lse(const Context &context, uint16_t &index)
 {
-    Context lhs = *context.getChild(1);
-    Context rhs = *context.getChild(2);
-
-    if (lhs[0].isFloat()) {
-        if (rhs[0].isFloat()) {
-            bool r = lhs[0].asFloat() <= rhs[0].asFloat();
-            index = context.setAtomicResult(Atom::Boolean(r));
-            return r;
-        }
-    } else if (lhs[0].getDescriptor() == Atom::TIMESTAMP) {
-        if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
-            bool r = Utils::GetTimestamp(&lhs[0]) <= Utils::GetTimestamp(&rhs[0]);
-            index = context.setAtomicResult(Atom::Boolean(r));
-            return r;
-        }
-    }
-
-    index = context.setAtomicResult(Atom::UndefinedBoolean());
-    return false;
+    return _lse(context, index);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 bool add(const Context &context, uint16_t &index)
 {
-    Context lhs = *context.getChild(1);
-    Context rhs = *context.getChild(2);
-
-    if (lhs[0].isFloat()) {
-        if (rhs[0].isFloat()) {
-            if (lhs[0] == Atom::PlusInfinity()) {
-                index = context.setAtomicResult(Atom::PlusInfinity());
-                return true;
-            }
-
-            if (rhs[0] == Atom::PlusInfinity()) {
-                index = context.setAtomicResult(Atom::PlusInfinity());
-                return true;
-            }
-
-            index = context.setAtomicResult(Atom::Float(lhs[0].asFloat() + rhs[0].asFloat()));
-            return true;
-        } else if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
-            if (lhs[0] != Atom::PlusInfinity()) {
-                index = context.setTimestampResult(Utils::GetTimestamp(&rhs[0]) + lhs[0].asFloat());
-                return true;
-            }
-        }
-    } else if (lhs[0].getDescriptor() == Atom::TIMESTAMP) {
-        if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
-            index = context.setTimestampResult(Utils::GetTimestamp(&lhs[0]) + Utils::GetTimestamp(&rhs[0]));
-            return true;
-        } else if (rhs[0].isFloat()) {
-            if (rhs[0] != Atom::PlusInfinity()) {
-                index = context.setTimestampResult(Utils::GetTimestamp(&lhs[0]) + rhs[0].asFloat());
-                return true;
-            }
-        }
-    }
-
-    index = context.setAtomicResult(Atom::Nil());
-    return false;
+    return _add(context, index);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 bool sub(const Context &context, uint16_t &index)
 {
-    Context lhs = *context.getChild(1);
-    Context rhs = *context.getChild(2);
-
-    if (lhs[0].isFloat()) {
-        if (rhs[0].isFloat()) {
-            if (lhs[0] == Atom::PlusInfinity()) {
-                index = context.setAtomicResult(Atom::PlusInfinity());
-                return true;
-            }
-
-            if (rhs[0] == Atom::PlusInfinity()) {
-                index = context.setAtomicResult(Atom::Float(0));
-                return true;
-            }
-
-            index = context.setAtomicResult(Atom::Float(lhs[0].asFloat() - rhs[0].asFloat()));
-            return true;
-        }
-    } else if (lhs[0].getDescriptor() == Atom::TIMESTAMP) {
-        if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
-            index = context.setTimestampResult(Utils::GetTimestamp(&lhs[0]) - Utils::GetTimestamp(&rhs[0]));
-            return true;
-        } else if (rhs[0].isFloat()) {
-            if (rhs[0] != Atom::PlusInfinity()) {
-                index = context.setTimestampResult(Utils::GetTimestamp(&lhs[0]) - rhs[0].asFloat());
-                return true;
-            }
-        }
-    }
-
-    index = context.setAtomicResult(Atom::Nil());
-    return false;
+    return _sub(context, index);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 bool mul(const Context &context, uint16_t &index)
 {
-    Context lhs = *context.getChild(1);
-    Context rhs = *context.getChild(2);
-
-    if (lhs[0].isFloat()) {
-        if (rhs[0].isFloat()) {
-            if (lhs[0] == Atom::PlusInfinity()) {
-                if (rhs[0] == Atom::PlusInfinity()) {
-                    index = context.setAtomicResult(Atom::PlusInfinity());
-                    return true;
-                }
-
-                if (rhs[0].asFloat() > 0) {
-                    index = context.setAtomicResult(Atom::PlusInfinity());
-                    return true;
-                }
-
-                if (rhs[0].asFloat() <= 0) {
-                    index = context.setAtomicResult(Atom::Float(0));
-                    return true;
-                }
-            }
-
-            if (rhs[0] == Atom::PlusInfinity()) {
-                if (lhs[0].asFloat() > 0) {
-                    index = context.setAtomicResult(Atom::PlusInfinity());
-                    return true;
-                }
-
-                if (lhs[0].asFloat() <= 0) {
-                    index = context.setAtomicResult(Atom::Float(0));
-                    return true;
-                }
-            }
-
-            index = context.setAtomicResult(Atom::Float(lhs[0].asFloat() * rhs[0].asFloat()));
-            return true;
-        } else if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
-            index = context.setAtomicResult(Atom::Float(Utils::GetTimestamp(&rhs[0]) * lhs[0].asFloat()));
-            return true;
-        }
-    } else if (lhs[0].getDescriptor() == Atom::TIMESTAMP) {
-        if (rhs[0].isFloat()) {
-            index = context.setTimestampResult(Utils::GetTimestamp(&lhs[0]) * rhs[0].asFloat());
-            return true;
-        } else if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
-            index = context.setAtomicResult(Atom::Float(Utils::GetTimestamp(&lhs[0]) * Utils::GetTimestamp(&lhs[0])));
-            return true;
-        }
-    }
-
-    index = context.setAtomicResult(Atom::Nil());
-    return false;
+    return _mul(context, index);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 bool div(const Context &context, uint16_t &index)
 {
-    Context lhs = *context.getChild(1);
-    Context rhs = *context.getChild(2);
-
-    if (lhs[0].isFloat()) {
-        if (rhs[0].isFloat()) {
-            if (rhs[0].asFloat() != 0) {
-                if (lhs[0] == Atom::PlusInfinity()) {
-                    if (rhs[0] == Atom::PlusInfinity()) {
-                        index = context.setAtomicResult(Atom::PlusInfinity());
-                        return true;
-                    }
-
-                    if (rhs[0].asFloat() > 0) {
-                        index = context.setAtomicResult(Atom::PlusInfinity());
-                        return true;
-                    }
-
-                    if (rhs[0].asFloat() <= 0) {
-                        index = context.setAtomicResult(Atom::Float(0));
-                        return true;
-                    }
-                }
-
-                if (rhs[0] == Atom::PlusInfinity()) {
-                    if (lhs[0].asFloat() > 0) {
-                        index = context.setAtomicResult(Atom::PlusInfinity());
-                        return true;
-                    }
-
-                    if (lhs[0].asFloat() <= 0) {
-                        index = context.setAtomicResult(Atom::Float(0));
-                        return true;
-                    }
-                }
-
-                index = context.setAtomicResult(Atom::Float(lhs[0].asFloat() / rhs[0].asFloat()));
-                return true;
-            }
-        } else if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
-            double rhs_t = (double)Utils::GetTimestamp(&rhs[0]);
-
-            if (rhs_t != 0) {
-                index = context.setAtomicResult(Atom::Float(lhs[0].asFloat() / rhs_t));
-                return true;
-            }
-        }
-    } else if (lhs[0].getDescriptor() == Atom::TIMESTAMP) {
-        if (rhs[0].isFloat()) {
-            if (rhs[0].asFloat() != 0) {
-                double lhs_t = (double)Utils::GetTimestamp(&lhs[0]);
-                index = context.setTimestampResult(lhs_t / rhs[0].asFloat());
-                return true;
-            }
-        } else if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
-            double rhs_t = (double)Utils::GetTimestamp(&rhs[0]);
-
-            if (rhs_t != 0) {
-                double lhs_t = (double)Utils::GetTimestamp(&lhs[0]);
-                index = context.setAtomicResult(Atom::Float(lhs_t / rhs_t));
-                return true;
-            }
-        }
-    }
-
-    index = context.setAtomicResult(Atom::Nil());
-    return false;
+    return _div(context, index);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 bool dis(const Context &context, uint16_t &index)
 {
-    Context lhs = *context.getChild(1);
-    Context rhs = *context.getChild(2);
-
-    if (lhs[0].isFloat()) {
-        if (rhs[0].isFloat()) {
-            index = context.setAtomicResult(Atom::Float(fabs(lhs[0].asFloat() - rhs[0].asFloat())));
-            return true;
-        }
-    } else if (lhs[0].getDescriptor() == Atom::TIMESTAMP) {
-        if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
-            uint64_t lhs_t = Utils::GetTimestamp(&lhs[0]);
-            uint64_t rhs_t = Utils::GetTimestamp(&rhs[0]);
-            index = context.setTimestampResult(fabs((double)(lhs_t - rhs_t)));
-            return true;
-        }
-    }
-
-    index = context.setAtomicResult(Atom::Nil());
-    return false;
+    return _dis(context, index);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
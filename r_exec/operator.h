@@ -39,6 +39,7 @@
 #include <r_exec/_context.h>  // for _Context
 #include <stddef.h>           // for NULL
 #include <stdint.h>           // for uint16_t, uint64_t
+#include <type_traits>        // for aligned_storage
 
 #include <replicode_common.h>  // for REPLICODE_EXPORT
 
@@ -47,15 +48,33 @@ namespace r_exec
 
 // Wrapper class for evaluation contexts.
 // Template operator functions is not an option since some operators are defined in usr_operators.dll.
+// A value: the implementation is held in place, so that passing, copying, dereferencing and getting the children of a
+// Context do not allocate.
 class REPLICODE_EXPORT Context
 {
 private:
-    _Context *implementation;
+    _Context *implementation; // in storage, unless given on the heap (compatibility: see Context(_Context *)).
+    std::aligned_storage<_Context::MaxSize, alignof(void *)>::type storage;
+
+    Context(): implementation(NULL) {}
+
+    void release()
+    {
+        if ((void *)implementation == (void *)&storage) {
+            implementation->~_Context();
+        } else {
+            delete implementation;
+        }
+
+        implementation = NULL;
+    }
 public:
-    Context(_Context *implementation): implementation(implementation) {}
+    Context(_Context *implementation): implementation(implementation) {} // takes ownership of a heap-allocated implementation.
+    explicit Context(const _Context &implementation): implementation(implementation.clone(&storage)) {}
+    Context(const Context &c): implementation(c.implementation ? c.implementation->clone(&storage) : NULL) {}
     virtual ~Context()
     {
-        delete implementation;
+        release();
     }
 
     _Context *get_implementation() const
@@ -69,17 +88,24 @@ public:
     }
     Context getChild(uint16_t index) const
     {
-        return Context(implementation->_getChild(index));
+        Context c;
+        c.implementation = implementation->_getChild(index, &c.storage);
+        return c;
     }
 
     Context operator *() const
     {
-        return Context(implementation->dereference());
+        Context c;
+        c.implementation = implementation->dereference(&c.storage);
+        return c;
     }
     Context &operator =(const Context &c)
     {
-        delete implementation;
-        implementation = implementation->assign(c.get_implementation());
+        if (this != &c) {
+            release();
+            implementation = c.implementation ? c.implementation->clone(&storage) : NULL;
+        }
+
         return *this;
     }
 
@@ -129,16 +155,34 @@ class Operator
 private:
     static r_code::vector<Operator> Operators; // indexed by opcodes.
 
+    typedef enum { // std operators evaluated on the context itself (see evaluate()).
+        NONE = 0,
+        EQU = 1,
+        NEQ = 2,
+        GTR = 3,
+        LSR = 4,
+        GTE = 5,
+        LSE = 6,
+        ADD = 7,
+        SUB = 8,
+        MUL = 9,
+        DIV = 10,
+        DIS = 11
+    } Std;
+
+    static uint8_t GetStd(bool (*o)(const Context &, uint16_t &));
+
     bool (*_operator)(const Context &, uint16_t &);
     bool (*_overload)(const Context &, uint16_t &);
+    uint8_t std_operator; // resolved once, at registration.
 public:
     static void Register(uint16_t opcode, bool (*op)(const Context &, uint16_t &)); // first, register std operators; next register user-defined operators (may be registered as overloads).
     static Operator Get(uint16_t opcode)
     {
         return Operators[opcode];
     }
-    Operator(): _operator(NULL), _overload(NULL) {}
-    Operator(bool (*o)(const Context &, uint16_t &)): _operator(o), _overload(NULL) {}
+    Operator(): _operator(NULL), _overload(NULL), std_operator(NONE) {}
+    Operator(bool (*o)(const Context &, uint16_t &)): _operator(o), _overload(NULL), std_operator(GetStd(o)) {}
     ~Operator() {}
 
     void setOverload(bool (*o)(const Context &, uint16_t &))
@@ -159,6 +203,11 @@ public:
         return false;
     }
 
+    // Same as operator(), on an IPGMContext or a HLPContext: the std operators run inline on the context, with no
+    // Context and no call through a function pointer; the others, and the overloads, get a Context. Defined in
+    // operator.tpl.h.
+    template<class C> bool evaluate(const C &context, uint16_t &index) const;
+
     bool is_red() const
     {
         return _operator == red;
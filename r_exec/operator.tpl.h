@@ -0,0 +1,441 @@
+//	operator.tpl.h
+//
+//	Std operators on any kind of context, and their evaluation on IPGMContext and HLPContext.
+
+#ifndef operator_tpl_h
+#define operator_tpl_h
+
+#include <math.h>             // for fabs
+#include <r_code/atom.h>      // for Atom
+#include <r_code/utils.h>     // for Utils
+#include <r_exec/operator.h>  // for Context, Operator
+#include <stdint.h>           // for uint16_t, uint64_t
+
+
+namespace r_exec
+{
+
+// C is Context (as for user-defined operators), IPGMContext or HLPContext: the latter are held on the stack.
+
+template<class C> bool _equ(const C &context, uint16_t &index)
+{
+    C lhs = *context.getChild(1);
+    C rhs = *context.getChild(2);
+    bool r = (lhs == rhs);
+    index = context.setAtomicResult(Atom::Boolean(r));
+    return r;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template<class C> bool _neq(const C &context, uint16_t &index)
+{
+    bool r = *context.getChild(1) != *context.getChild(2);
+    index = context.setAtomicResult(Atom::Boolean(r));
+    return r;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template<class C> bool _gtr(const C &context, uint16_t &index)
+{
+    C lhs = *context.getChild(1);
+    C rhs = *context.getChild(2);
+
+    if (lhs[0].isFloat()) {
+        if (rhs[0].isFloat()) {
+            bool r = lhs[0].asFloat() > rhs[0].asFloat();
+            index = context.setAtomicResult(Atom::Boolean(r));
+            return r;
+        }
+    } else if (lhs[0].getDescriptor() == Atom::TIMESTAMP) {
+        if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
+            bool r = Utils::GetTimestamp(&lhs[0]) > Utils::GetTimestamp(&rhs[0]);
+            index = context.setAtomicResult(Atom::Boolean(r));
+            return r;
+        }
+    }
+
+    index = context.setAtomicResult(Atom::UndefinedBoolean());
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template<class C> bool _lsr(const C &context, uint16_t &index)
+{
+    C lhs = *context.getChild(1);
+    C rhs = *context.getChild(2);
+
+    if (lhs[0].isFloat()) {
+        if (rhs[0].isFloat()) {
+            bool r = lhs[0].asFloat() < rhs[0].asFloat();
+            index = context.setAtomicResult(Atom::Boolean(r));
+            return r;
+        }
+    } else if (lhs[0].getDescriptor() == Atom::TIMESTAMP) {
+        if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
+            bool r = Utils::GetTimestamp(&lhs[0]) < Utils::GetTimestamp(&rhs[0]);
+            index = context.setAtomicResult(Atom::Boolean(r));
+            return r;
+        }
+    }
+
+    index = context.setAtomicResult(Atom::UndefinedBoolean());
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template<class C> bool _gte(const C &context, uint16_t &index)
+{
+    C lhs = *context.getChild(1);
+    C rhs = *context.getChild(2);
+
+    if (lhs[0].isFloat()) {
+        if (rhs[0].isFloat()) {
+            bool r = lhs[0].asFloat() >= rhs[0].asFloat();
+            index = context.setAtomicResult(Atom::Boolean(r));
+            return r;
+        }
+    } else if (lhs[0].getDescriptor() == Atom::TIMESTAMP) {
+        if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
+            bool r = Utils::GetTimestamp(&lhs[0]) >= Utils::GetTimestamp(&rhs[0]);
+            index = context.setAtomicResult(Atom::Boolean(r));
+            return r;
+        }
+    }
+
+    index = context.setAtomicResult(Atom::UndefinedBoolean());
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template<class C> bool _lse(const C &context, uint16_t &index)
+{
+    C lhs = *context.getChild(1);
+    C rhs = *context.getChild(2);
+
+    if (lhs[0].isFloat()) {
+        if (rhs[0].isFloat()) {
+            bool r = lhs[0].asFloat() <= rhs[0].asFloat();
+            index = context.setAtomicResult(Atom::Boolean(r));
+            return r;
+        }
+    } else if (lhs[0].getDescriptor() == Atom::TIMESTAMP) {
+        if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
+            bool r = Utils::GetTimestamp(&lhs[0]) <= Utils::GetTimestamp(&rhs[0]);
+            index = context.setAtomicResult(Atom::Boolean(r));
+            return r;
+        }
+    }
+
+    index = context.setAtomicResult(Atom::UndefinedBoolean());
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template<class C> bool _add(const C &context, uint16_t &index)
+{
+    C lhs = *context.getChild(1);
+    C rhs = *context.getChild(2);
+
+    if (lhs[0].isFloat()) {
+        if (rhs[0].isFloat()) {
+            if (lhs[0] == Atom::PlusInfinity()) {
+                index = context.setAtomicResult(Atom::PlusInfinity());
+                return true;
+            }
+
+            if (rhs[0] == Atom::PlusInfinity()) {
+                index = context.setAtomicResult(Atom::PlusInfinity());
+                return true;
+            }
+
+            index = context.setAtomicResult(Atom::Float(lhs[0].asFloat() + rhs[0].asFloat()));
+            return true;
+        } else if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
+            if (lhs[0] != Atom::PlusInfinity()) {
+                index = context.setTimestampResult(Utils::GetTimestamp(&rhs[0]) + lhs[0].asFloat());
+                return true;
+            }
+        }
+    } else if (lhs[0].getDescriptor() == Atom::TIMESTAMP) {
+        if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
+            index = context.setTimestampResult(Utils::GetTimestamp(&lhs[0]) + Utils::GetTimestamp(&rhs[0]));
+            return true;
+        } else if (rhs[0].isFloat()) {
+            if (rhs[0] != Atom::PlusInfinity()) {
+                index = context.setTimestampResult(Utils::GetTimestamp(&lhs[0]) + rhs[0].asFloat());
+                return true;
+            }
+        }
+    }
+
+    index = context.setAtomicResult(Atom::Nil());
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template<class C> bool _sub(const C &context, uint16_t &index)
+{
+    C lhs = *context.getChild(1);
+    C rhs = *context.getChild(2);
+
+    if (lhs[0].isFloat()) {
+        if (rhs[0].isFloat()) {
+            if (lhs[0] == Atom::PlusInfinity()) {
+                index = context.setAtomicResult(Atom::PlusInfinity());
+                return true;
+            }
+
+            if (rhs[0] == Atom::PlusInfinity()) {
+                index = context.setAtomicResult(Atom::Float(0));
+                return true;
+            }
+
+            index = context.setAtomicResult(Atom::Float(lhs[0].asFloat() - rhs[0].asFloat()));
+            return true;
+        }
+    } else if (lhs[0].getDescriptor() == Atom::TIMESTAMP) {
+        if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
+            index = context.setTimestampResult(Utils::GetTimestamp(&lhs[0]) - Utils::GetTimestamp(&rhs[0]));
+            return true;
+        } else if (rhs[0].isFloat()) {
+            if (rhs[0] != Atom::PlusInfinity()) {
+                index = context.setTimestampResult(Utils::GetTimestamp(&lhs[0]) - rhs[0].asFloat());
+                return true;
+            }
+        }
+    }
+
+    index = context.setAtomicResult(Atom::Nil());
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template<class C> bool _mul(const C &context, uint16_t &index)
+{
+    C lhs = *context.getChild(1);
+    C rhs = *context.getChild(2);
+
+    if (lhs[0].isFloat()) {
+        if (rhs[0].isFloat()) {
+            if (lhs[0] == Atom::PlusInfinity()) {
+                if (rhs[0] == Atom::PlusInfinity()) {
+                    index = context.setAtomicResult(Atom::PlusInfinity());
+                    return true;
+                }
+
+                if (rhs[0].asFloat() > 0) {
+                    index = context.setAtomicResult(Atom::PlusInfinity());
+                    return true;
+                }
+
+                if (rhs[0].asFloat() <= 0) {
+                    index = context.setAtomicResult(Atom::Float(0));
+                    return true;
+                }
+            }
+
+            if (rhs[0] == Atom::PlusInfinity()) {
+                if (lhs[0].asFloat() > 0) {
+                    index = context.setAtomicResult(Atom::PlusInfinity());
+                    return true;
+                }
+
+                if (lhs[0].asFloat() <= 0) {
+                    index = context.setAtomicResult(Atom::Float(0));
+                    return true;
+                }
+            }
+
+            index = context.setAtomicResult(Atom::Float(lhs[0].asFloat() * rhs[0].asFloat()));
+            return true;
+        } else if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
+            index = context.setAtomicResult(Atom::Float(Utils::GetTimestamp(&rhs[0]) * lhs[0].asFloat()));
+            return true;
+        }
+    } else if (lhs[0].getDescriptor() == Atom::TIMESTAMP) {
+        if (rhs[0].isFloat()) {
+            index = context.setTimestampResult(Utils::GetTimestamp(&lhs[0]) * rhs[0].asFloat());
+            return true;
+        } else if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
+            index = context.setAtomicResult(Atom::Float(Utils::GetTimestamp(&lhs[0]) * Utils::GetTimestamp(&lhs[0])));
+            return true;
+        }
+    }
+
+    index = context.setAtomicResult(Atom::Nil());
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template<class C> bool _div(const C &context, uint16_t &index)
+{
+    C lhs = *context.getChild(1);
+    C rhs = *context.getChild(2);
+
+    if (lhs[0].isFloat()) {
+        if (rhs[0].isFloat()) {
+            if (rhs[0].asFloat() != 0) {
+                if (lhs[0] == Atom::PlusInfinity()) {
+                    if (rhs[0] == Atom::PlusInfinity()) {
+                        index = context.setAtomicResult(Atom::PlusInfinity());
+                        return true;
+                    }
+
+                    if (rhs[0].asFloat() > 0) {
+                        index = context.setAtomicResult(Atom::PlusInfinity());
+                        return true;
+                    }
+
+                    if (rhs[0].asFloat() <= 0) {
+                        index = context.setAtomicResult(Atom::Float(0));
+                        return true;
+                    }
+                }
+
+                if (rhs[0] == Atom::PlusInfinity()) {
+                    if (lhs[0].asFloat() > 0) {
+                        index = context.setAtomicResult(Atom::PlusInfinity());
+                        return true;
+                    }
+
+                    if (lhs[0].asFloat() <= 0) {
+                        index = context.setAtomicResult(Atom::Float(0));
+                        return true;
+                    }
+                }
+
+                index = context.setAtomicResult(Atom::Float(lhs[0].asFloat() / rhs[0].asFloat()));
+                return true;
+            }
+        } else if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
+            double rhs_t = (double)Utils::GetTimestamp(&rhs[0]);
+
+            if (rhs_t != 0) {
+                index = context.setAtomicResult(Atom::Float(lhs[0].asFloat() / rhs_t));
+                return true;
+            }
+        }
+    } else if (lhs[0].getDescriptor() == Atom::TIMESTAMP) {
+        if (rhs[0].isFloat()) {
+            if (rhs[0].asFloat() != 0) {
+                double lhs_t = (double)Utils::GetTimestamp(&lhs[0]);
+                index = context.setTimestampResult(lhs_t / rhs[0].asFloat());
+                return true;
+            }
+        } else if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
+            double rhs_t = (double)Utils::GetTimestamp(&rhs[0]);
+
+            if (rhs_t != 0) {
+                double lhs_t = (double)Utils::GetTimestamp(&lhs[0]);
+                index = context.setAtomicResult(Atom::Float(lhs_t / rhs_t));
+                return true;
+            }
+        }
+    }
+
+    index = context.setAtomicResult(Atom::Nil());
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template<class C> bool _dis(const C &context, uint16_t &index)
+{
+    C lhs = *context.getChild(1);
+    C rhs = *context.getChild(2);
+
+    if (lhs[0].isFloat()) {
+        if (rhs[0].isFloat()) {
+            index = context.setAtomicResult(Atom::Float(fabs(lhs[0].asFloat() - rhs[0].asFloat())));
+            return true;
+        }
+    } else if (lhs[0].getDescriptor() == Atom::TIMESTAMP) {
+        if (rhs[0].getDescriptor() == Atom::TIMESTAMP) {
+            uint64_t lhs_t = Utils::GetTimestamp(&lhs[0]);
+            uint64_t rhs_t = Utils::GetTimestamp(&rhs[0]);
+            index = context.setTimestampResult(fabs((double)(lhs_t - rhs_t)));
+            return true;
+        }
+    }
+
+    index = context.setAtomicResult(Atom::Nil());
+    return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+template<class C> bool Operator::evaluate(const C &context, uint16_t &index) const
+{
+    bool r;
+
+    switch (std_operator) {
+    case EQU:
+        r = _equ(context, index);
+        break;
+
+    case NEQ:
+        r = _neq(context, index);
+        break;
+
+    case GTR:
+        r = _gtr(context, index);
+        break;
+
+    case LSR:
+        r = _lsr(context, index);
+        break;
+
+    case GTE:
+        r = _gte(context, index);
+        break;
+
+    case LSE:
+        r = _lse(context, index);
+        break;
+
+    case ADD:
+        r = _add(context, index);
+        break;
+
+    case SUB:
+        r = _sub(context, index);
+        break;
+
+    case MUL:
+        r = _mul(context, index);
+        break;
+
+    case DIV:
+        r = _div(context, index);
+        break;
+
+    case DIS:
+        r = _dis(context, index);
+        break;
+
+    default: {
+        Context c(context);
+        return (*this)(c, index);
+    }
+    }
+
+    if (r || !_overload) {
+        return r;
+    }
+
+    Context c(context);
+    return _overload(c, index);
+}
+}
+
+
+#endif
@@ -150,6 +150,8 @@ r_code::Code *Overlay::build_object(Atom head) const
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+const uint16_t Controller::AnyOpcode;
+
 Controller::Controller(r_code::View *view): _Object(), invalidated(0), activated(0), view(view)
 {
     if (!view) {
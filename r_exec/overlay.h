@@ -34,9 +34,11 @@
 #include <r_code/atom.h>       // for Atom
 #include <r_code/list.h>       // for list
 #include <r_code/object.h>     // for View
+#include <r_code/reclaimer.h>  // for EPOCH_RECLAIMED
 #include <r_code/vector.h>     // for vector
 #include <stdint.h>            // for uint16_t, uint64_t
 #include <mutex>               // for mutex
+#include <utility>             // for pair
 #include <vector>              // for vector
 
 #include <replicode_common.h>  // for P, _Object, REPLICODE_EXPORT
@@ -54,6 +56,8 @@ class View;
 class REPLICODE_EXPORT Controller:
     public _Object
 {
+public:
+    EPOCH_RECLAIMED
 protected:
     volatile uint64_t invalidated; // 32 bit alignment.
     volatile uint64_t activated; // 32 bit alignment.
@@ -99,6 +103,17 @@ public:
 
     virtual Code *get_core_object() const = 0;
 
+    // Head of an input: its opcode and, for a fact or |fact, the opcode of its object (AnyOpcode: any).
+    typedef std::pair<uint16_t, uint16_t> InputHead;
+    static const uint16_t AnyOpcode = 0xFFFF; // opcodes take 12 bits.
+
+    // Fills heads with the heads of all the inputs take_input() may use, so that the groups offer the controller these
+    // inputs only (see ViewIndex); returns false if it may use any input. Must not change over the controller's life.
+    virtual bool get_input_heads(std::vector<InputHead> &heads) const
+    {
+        return false;
+    }
+
     r_code::Code *getObject() const
     {
         return view->object; // return the reduction object (e.g. ipgm, icpp_pgm, cst, mdl).
@@ -130,6 +145,8 @@ class REPLICODE_EXPORT Overlay:
     friend class _Context;
     friend class IPGMContext;
     friend class HLPContext;
+public:
+    EPOCH_RECLAIMED
 protected:
     volatile uint64_t invalidated;
 
@@ -152,7 +169,7 @@ protected:
     void unpatch_code(uint16_t patch_index);
 
     void rollback(); // reset the overlay to the last commited state: unpatch code and values.
-    void commit(); // empty the patch_indices and set value_commit_index to values.size().
+    virtual void commit(); // empty the patch_indices and set value_commit_index to values.size().
 
     Code *get_core_object() const; // pgm, mdl, cst.
 
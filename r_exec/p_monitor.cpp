@@ -52,7 +52,7 @@ PMonitor::PMonitor(MDLController *controller,
     prediction_target = prediction->get_pred()->get_target(); // f1.
     bindings->reset_fwd_timings(prediction_target);
     MonitoringJob<PMonitor> *j = new MonitoringJob<PMonitor>(this, prediction_target->get_before() + Utils::GetTimeTolerance());
-    _Mem::Get()->pushTimeJob(j);
+    _Mem::Get()->pushTimeJob(j, job);
 }
 
 PMonitor::~PMonitor()
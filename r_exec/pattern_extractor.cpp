@@ -124,7 +124,7 @@ bool TPX::filter(View *input, _Fact *abstracted_input, BindingMap *bm)
         return false;
     }
 
-    for (P<BindingMap> new_map : new_maps)
+    for (const P<BindingMap> &new_map : new_maps)
         if (new_map->intersect(bm)) { //std::cout<<" lvl1"<<std::endl;
             return true;
         }
@@ -195,7 +195,7 @@ void _TPX::filter_icst_components(ICST *icst, uint64_t icst_index, std::vector<C
     uint64_t *found = new uint64_t[icst->components.size()];
 
     for (uint64_t j = 0; j < components.size(); ++j) {
-        for (P<_Fact> component : icst->components) {
+        for (const P<_Fact> &component : icst->components) {
             if (components[j].discarded) {
                 continue;
             }
@@ -495,7 +495,7 @@ void GTPX::reduce(r_exec::View *input)   // input->object: f->success.
     _Fact *consequent = (_Fact *)input->object->get_reference(0)->get_reference(1);
     P<BindingMap> consequent_bm = new BindingMap();
 
-    for (P<_Fact> prediction : predictions) { // check if some models have successfully predicted the target: if so, abort.
+    for (const P<_Fact> &prediction : predictions) { // check if some models have successfully predicted the target: if so, abort.
         P<BindingMap> bm = new BindingMap(consequent_bm);
         bm->reset_fwd_timings(prediction);
 
@@ -32,16 +32,19 @@
 
 #include <r_code/atom.h>            // for Atom
 #include <r_code/list.h>            // for list<>::const_iterator, list, etc
-#include <r_code/replicode_defs.h>  // for IPGM_RUN, IPGM_TSC
+#include <r_code/replicode_defs.h>  // for IPGM_RUN, IPGM_TSC, PGM_INPUTS
 #include <r_code/utils.h>           // for Utils
+#include <r_exec/alpha_network.h>   // for AlphaNetwork, AlphaNode
 #include <r_exec/group.h>           // for Group
 #include <r_exec/init.h>            // for Now
 #include <r_exec/mem.h>             // for _Mem
+#include <r_exec/opcodes.h>         // for Opcodes, Opcodes::Ptn, etc
 #include <r_exec/pgm_controller.h>  // for AntiPGMController, PGMController, etc
 #include <r_exec/pgm_overlay.h>     // for AntiPGMOverlay, etc
 #include <r_exec/time_job.h>        // for AntiPGMSignalingJob, etc
 #include <r_exec/view.h>            // for View
 #include <stdint.h>                 // for uint64_t
+#include <utility>                  // for make_pair, move, pair
 
 #include <replicode_common.h>       // for P
 
@@ -53,12 +56,93 @@ namespace r_exec
 _PGMController::_PGMController(r_code::View *ipgm_view): OController(ipgm_view)
 {
     run_once = !ipgm_view->object->code(IPGM_RUN).asBoolean();
+    Code *pgm = get_core_object();
+    uint16_t pattern_set_index = pgm->code(PGM_INPUTS).asIndex();
+    uint16_t pattern_count = pgm->code(pattern_set_index).getAtomCount();
+
+    for (uint16_t i = 1; i <= pattern_count; ++i) {
+        uint16_t pattern_index = pgm->code(pattern_set_index + i).asIndex();
+        P<AlphaNode> node;
+        AlphaNetwork::GetPGMNode(pgm, getObject(), pgm->code(pattern_index + 1).asIndex(), node);
+
+        if (node != nullptr) {
+            alpha_nodes.push_back(std::make_pair(pattern_index, std::move(node)));
+        }
+    }
 }
 
 _PGMController::~_PGMController()
 {
 }
 
+AlphaNode *_PGMController::get_alpha_node(uint16_t pattern_index) const
+{
+    for (const std::pair<uint16_t, P<AlphaNode> > &node : alpha_nodes) {
+        if (node.first == pattern_index) {
+            return node.second;
+        }
+    }
+
+    return nullptr;
+}
+
+void _PGMController::invalidate()
+{
+    OController::invalidate();
+    std::lock_guard<std::mutex> guard(m_signalingJobMutex);
+
+    if (signaling_job != nullptr) { // release it now rather than at its deadline.
+        signaling_job->cancel();
+        signaling_job = nullptr;
+    }
+}
+
+void _PGMController::push_signaling_job(TimeJob *job)
+{
+    P<TimeJob> _job = job; // released here if not pushed.
+    std::lock_guard<std::mutex> guard(m_signalingJobMutex);
+
+    if (!is_invalidated()) {
+        _Mem::Get()->pushTimeJob(job, signaling_job);
+    }
+}
+
+bool _PGMController::get_input_heads(std::vector<InputHead> &heads) const
+{
+    Code *pgm = get_core_object();
+    uint16_t pattern_set_index = pgm->code(PGM_INPUTS).asIndex();
+    uint16_t pattern_count = pgm->code(pattern_set_index).getAtomCount();
+
+    for (uint16_t i = 1; i <= pattern_count; ++i) {
+        uint16_t pattern_index = pgm->code(pattern_set_index + i).asIndex();
+
+        if (pgm->code(pattern_index).asOpcode() != Opcodes::Ptn) { // |ptn: takes what does not match.
+            return false;
+        }
+
+        uint16_t skeleton_index = pgm->code(pattern_index + 1).asIndex();
+        Atom head = pgm->code(skeleton_index);
+
+        if (!head.isStructural()) { // variable or wildcard.
+            return false;
+        }
+
+        uint16_t object_opcode = AnyOpcode;
+
+        if (head.asOpcode() == Opcodes::Fact || head.asOpcode() == Opcodes::AntiFact) {
+            Atom object = pgm->code(skeleton_index + 1);
+
+            if (object.getDescriptor() == Atom::I_PTR && pgm->code(object.asIndex()).isStructural()) {
+                object_opcode = pgm->code(object.asIndex()).asOpcode();
+            }
+        }
+
+        heads.push_back(InputHead(head.asOpcode(), object_opcode));
+    }
+
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 InputLessPGMController::InputLessPGMController(r_code::View *ipgm_view): _PGMController(ipgm_view)
@@ -86,7 +170,7 @@ void InputLessPGMController::signal_input_less_pgm()
 
                 if (host->get_c_act() > host->get_c_act_thr() && // c-active group.
                     host->get_c_sln() > host->get_c_sln_thr()) { // c-salient group.
-                    _Mem::Get()->pushTimeJob(new InputLessPGMSignalingJob((r_exec::View*)view, Now() + tsc));
+                    push_signaling_job(new InputLessPGMSignalingJob((r_exec::View*)view, Now() + tsc));
                 }
             }
         }
@@ -264,7 +348,7 @@ void AntiPGMController::push_new_signaling_job()
     if (getView()->get_act() > host->get_act_thr() && // active ipgm.
         host->get_c_act() > host->get_c_act_thr() && // c-active group.
         host->get_c_sln() > host->get_c_sln_thr()) { // c-salient group.
-        _Mem::Get()->pushTimeJob(new AntiPGMSignalingJob((r_exec::View*)view, Now() + Utils::GetTimestamp<Code>(getObject(), IPGM_TSC)));
+        push_signaling_job(new AntiPGMSignalingJob((r_exec::View*)view, Now() + Utils::GetTimestamp<Code>(getObject(), IPGM_TSC)));
     }
 }
 }
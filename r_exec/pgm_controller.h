@@ -32,13 +32,19 @@
 #define pgm_controller_h
 
 
-#include <r_code/object.h>    // for Code
-#include <r_exec/overlay.h>   // for OController
-#include <mutex>              // for mutex
+#include <r_code/object.h>         // for Code
+#include <r_exec/alpha_network.h>  // for AlphaNode
+#include <r_exec/overlay.h>        // for OController
+#include <stdint.h>                // for uint16_t
+#include <mutex>                   // for mutex
+#include <utility>                 // for pair
+#include <vector>                  // for vector
 
 #include <replicode_common.h>  // for REPLICODE_EXPORT
 
 namespace r_exec {
+class TimeJob;
+class TimeJobHandle;
 class View;
 }  // namespace r_exec
 
@@ -48,9 +54,14 @@ namespace r_exec
 class REPLICODE_EXPORT _PGMController:
     public OController
 {
+private:
+    P<TimeJobHandle> signaling_job; // the pending signaling job, cancelled when the controller is invalidated.
+    std::mutex m_signalingJobMutex;
 protected:
     bool run_once;
 
+    std::vector<std::pair<uint16_t, P<AlphaNode> > > alpha_nodes; // by pattern index; none for the skeletons that depend on the overlays.
+
     _PGMController(r_code::View *ipgm_view);
     virtual ~_PGMController();
 public:
@@ -58,6 +69,13 @@ public:
     {
         return getObject()->get_reference(0);
     }
+
+    bool get_input_heads(std::vector<InputHead> &heads) const; // from the skeletons of the patterns.
+
+    AlphaNode *get_alpha_node(uint16_t pattern_index) const; // nullptr if none.
+
+    void invalidate();
+    void push_signaling_job(TimeJob *job); // replaces the pending one; the job is dropped if the controller is invalidated.
 };
 
 // TimeCores holding InputLessPGMSignalingJob trigger the injection of the productions.
@@ -34,6 +34,7 @@
 #include <r_code/replicode_defs.h>  // for MK_RDX_ARITY, IPGM_ARGS, etc
 #include <r_code/utils.h>           // for Utils
 #include <r_code/vector.h>          // for vector
+#include <r_exec/alpha_network.h>   // for AlphaNode
 #include <r_exec/callbacks.h>       // for Callbacks, Callbacks::Callback
 #include <r_exec/context.h>         // for IPGMContext, etc
 #include <r_exec/factory.h>         // for Fact
@@ -450,13 +451,67 @@ Code *InputLessPGMOverlay::get_mk_rdx(uint16_t &extent_index) const
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+PGMCodePool::PGMCodePool(const Atom *clean_code, uint16_t code_size): _Object(), code_size(code_size)
+{
+    this->clean_code = new Atom[code_size];
+    memcpy(this->clean_code, clean_code, code_size * sizeof(Atom));
+}
+
+PGMCodePool::~PGMCodePool()
+{
+    for (Atom *buffer : buffers) {
+        delete[] buffer;
+    }
+
+    delete[] clean_code;
+}
+
+Atom *PGMCodePool::acquire()
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+
+        if (!buffers.empty()) {
+            Atom *buffer = buffers.back();
+            buffers.pop_back();
+            return buffer;
+        }
+    }
+    Atom *buffer = new Atom[code_size];
+    memcpy(buffer, clean_code, code_size * sizeof(Atom));
+    return buffer;
+}
+
+void PGMCodePool::restore(Atom *code, const std::vector<uint16_t> &patch_indices) const
+{
+    for (uint16_t patch_index : patch_indices) {
+        code[patch_index] = clean_code[patch_index];
+    }
+}
+
+void PGMCodePool::release(Atom *code)
+{
+    {
+        std::lock_guard<std::mutex> guard(mutex);
+
+        if (buffers.size() < MaxBufferCount) {
+            buffers.push_back(code);
+            return;
+        }
+    }
+    delete[] code;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 PGMOverlay::PGMOverlay(Controller *c): InputLessPGMOverlay(c)
 {
     is_volatile = c->getObject()->code(IPGM_RES).asBoolean();
+    code_pool = new PGMCodePool(code, code_size); // the code is clean at this point.
     init();
 }
 
-PGMOverlay::PGMOverlay(PGMOverlay *original, uint16_t last_input_index, uint16_t value_commit_index): InputLessPGMOverlay()
+PGMOverlay::PGMOverlay(PGMOverlay *original, uint16_t last_input_index, uint16_t value_commit_index): InputLessPGMOverlay(), code_pool(original->code_pool), committed_patches(original->committed_patches)
 {
     controller = original->controller;
     input_pattern_indices = original->input_pattern_indices;
@@ -466,15 +521,16 @@ PGMOverlay::PGMOverlay(PGMOverlay *original, uint16_t last_input_index, uint16_t
         input_views.push_back(original->input_views[i]);
     }
 
+    // the original as of its last commit: the clean code with the committed patches, not the others.
     code_size = original->code_size;
-    code = new r_code::Atom[code_size];
-    memcpy(code, original->code, code_size * sizeof(r_code::Atom)); // copy patched code.
-    Atom *original_code = &getObject()->get_reference(0)->code(0);
+    code = code_pool->acquire();
 
-    for (uint16_t patch_index : original->patch_indices) { // unpatch code.
-        code[patch_index] = original_code[patch_index];
+    for (uint16_t patch_index : committed_patches) {
+        code[patch_index] = original->code[patch_index];
     }
 
+    code_pool->restore(code, original->patch_indices);
+
     this->value_commit_index = value_commit_index;
 
     for (uint16_t i = 0; i < value_commit_index; ++i) { // copy values up to the last commit index.
@@ -485,8 +541,14 @@ PGMOverlay::PGMOverlay(PGMOverlay *original, uint16_t last_input_index, uint16_t
     birth_time = original->birth_time;
 }
 
-inline PGMOverlay::~PGMOverlay()
+PGMOverlay::~PGMOverlay()
 {
+    if (code) { // give the code back clean, for the next offspring.
+        code_pool->restore(code, committed_patches);
+        code_pool->restore(code, patch_indices);
+        code_pool->release(code);
+        code = nullptr;
+    }
 }
 
 inline void PGMOverlay::init()
@@ -506,15 +568,22 @@ inline void PGMOverlay::reset()
 {
     InputLessPGMOverlay::reset();
     patch_indices.clear();
+    committed_patches.clear();
     input_views.clear();
     input_pattern_indices.clear();
     init();
 }
 
+void PGMOverlay::commit()
+{
+    committed_patches.insert(committed_patches.end(), patch_indices.begin(), patch_indices.end());
+    Overlay::commit();
+}
+
 bool PGMOverlay::is_invalidated()
 {
     if (is_volatile) {
-        for (P<r_code::View> input_view : input_views) {
+        for (const P<r_code::View> &input_view : input_views) {
             if (input_view->object->is_invalidated()) {
                 return (invalidated = 1);
             }
@@ -682,10 +751,7 @@ PGMOverlay::MatchResult PGMOverlay::match(r_exec::View *input, uint16_t &input_i
 inline PGMOverlay::MatchResult PGMOverlay::_match(r_exec::View *input, uint16_t pattern_index)
 {
     if (code[pattern_index].asOpcode() == Opcodes::AntiPtn) {
-        IPGMContext input_object = IPGMContext::GetContextFromInput(input, this);
-        IPGMContext pattern_skeleton(getObject()->get_reference(0), getView(), code, code[pattern_index + 1].asIndex(), this); // pgm_code[pattern_index] is the first atom of the pattern; pgm_code[pattern_index+1] is an iptr to the skeleton.
-
-        if (!pattern_skeleton.match(input_object)) {
+        if (!match_skeleton(input, pattern_index)) {
             return SUCCESS;
         }
 
@@ -700,10 +766,7 @@ inline PGMOverlay::MatchResult PGMOverlay::_match(r_exec::View *input, uint16_t
             return FAILURE;
         }
     } else if (code[pattern_index].asOpcode() == Opcodes::Ptn) {
-        IPGMContext input_object = IPGMContext::GetContextFromInput(input, this);
-        IPGMContext pattern_skeleton(getObject()->get_reference(0), getView(), code, code[pattern_index + 1].asIndex(), this); // pgm_code[pattern_index] is the first atom of the pattern; pgm_code[pattern_index+1] is an iptr to the skeleton.
-
-        if (!pattern_skeleton.match(input_object)) {
+        if (!match_skeleton(input, pattern_index)) {
             return IMPOSSIBLE;
         }
 
@@ -713,6 +776,26 @@ inline PGMOverlay::MatchResult PGMOverlay::_match(r_exec::View *input, uint16_t
     return IMPOSSIBLE;
 }
 
+inline bool PGMOverlay::match_skeleton(r_exec::View *input, uint16_t pattern_index)
+{
+    AlphaNode *node = ((_PGMController *)controller)->get_alpha_node(pattern_index);
+    bool passed;
+
+    if (node && node->get_outcome(input->object, passed)) {
+        return passed;
+    }
+
+    IPGMContext input_object = IPGMContext::GetContextFromInput(input, this);
+    IPGMContext pattern_skeleton(getObject()->get_reference(0), getView(), code, code[pattern_index + 1].asIndex(), this); // pgm_code[pattern_index] is the first atom of the pattern; pgm_code[pattern_index+1] is an iptr to the skeleton.
+    passed = pattern_skeleton.match(input_object);
+
+    if (node) {
+        node->set_outcome(input->object, passed);
+    }
+
+    return passed;
+}
+
 inline PGMOverlay::MatchResult PGMOverlay::__match(r_exec::View *input, uint16_t pattern_index)
 {
     //Atom::Trace(pgm_code,getObject()->get_reference(0)->code_size());
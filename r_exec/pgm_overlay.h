@@ -35,7 +35,9 @@
 #include <r_code/atom.h>       // for Atom
 #include <r_code/list.h>       // for list
 #include <r_exec/overlay.h>    // for Overlay
+#include <stddef.h>            // for size_t
 #include <stdint.h>            // for uint16_t, int16_t, uint64_t
+#include <mutex>               // for mutex
 #include <vector>              // for vector
 
 #include <replicode_common.h>  // for P
@@ -81,6 +83,29 @@ public:
     bool inject_productions(); // return true upon successful evaluation; no existence check in simulation mode.
 };
 
+// Code buffers of the overlays of a program, kept clean (pgm code with the tpl args patched, see patch_tpl_args()) for
+// reuse: an offspring takes one and applies the committed patches of its original, instead of copying the whole code
+// (see PGMOverlay(PGMOverlay *, ...)).
+// Shared by the overlays of a program, which may outlive its controller.
+class REPLICODE_EXPORT PGMCodePool:
+    public core::_Object
+{
+private:
+    static const size_t MaxBufferCount = 16;
+
+    std::mutex mutex;
+    std::vector<r_code::Atom *> buffers;
+    r_code::Atom *clean_code;
+    uint16_t code_size;
+public:
+    PGMCodePool(const r_code::Atom *clean_code, uint16_t code_size);
+    ~PGMCodePool();
+
+    r_code::Atom *acquire(); // a clean buffer.
+    void restore(r_code::Atom *code, const std::vector<uint16_t> &patch_indices) const; // cleans the code at these indices.
+    void release(r_code::Atom *code); // code must be clean.
+};
+
 // Overlay with inputs.
 // Several ReductionCores can attempt to reduce the same overlay simultaneously (each with a different input).
 class REPLICODE_EXPORT PGMOverlay:
@@ -95,6 +120,11 @@ protected:
     r_code::list<uint16_t> input_pattern_indices; // stores the input patterns still waiting for a match: will be plucked upon each successful match.
     std::vector<P<r_code::View> > input_views; // copies of the inputs; vector updated at each successful match.
 
+    P<PGMCodePool> code_pool;
+    std::vector<uint16_t> committed_patches; // the code differs from the clean code at these indices (and at patch_indices) only.
+
+    void commit(); // keeps track of the committed patches, also when committed through a context.
+
     typedef enum {
         SUCCESS = 0,
         FAILURE = 1,
@@ -105,6 +135,7 @@ protected:
     bool check_guards(); // return true upon successful evaluation.
 
     MatchResult _match(r_exec::View *input, uint16_t pattern_index); // delegates to __match.
+    bool match_skeleton(r_exec::View *input, uint16_t pattern_index); // shared with the programs that have the same skeleton (see AlphaNode).
     MatchResult __match(r_exec::View *input, uint16_t pattern_index); // return SUCCESS upon a successful match, IMPOSSIBLE if the input is not of the right class, FAILURE otherwise.
 
     Code *dereference_in_ptr(Atom a);
@@ -115,7 +146,7 @@ protected:
     void init();
 
     PGMOverlay(Controller *c);
-    PGMOverlay(PGMOverlay *original, uint16_t last_input_index, uint16_t value_commit_index); // copy from the original and rollback.
+    PGMOverlay(PGMOverlay *original, uint16_t last_input_index, uint16_t value_commit_index); // copy from the original and rollback: O(patches), not O(code size).
 public:
     virtual ~PGMOverlay();
 
@@ -30,16 +30,24 @@
 
 #include "reduction_core.h"
 
-#include <r_exec/init.h>           // for Now
-#include <r_exec/mem.h>            // for _Mem
-#include <r_exec/reduction_job.h>  // for _ReductionJob
+#include <r_code/reclaimer.h>       // for Reclaimer
+#include <r_exec/init.h>            // for Now
+#include <r_exec/job_stats.h>       // for JobStats
+#include <r_exec/mem.h>             // for _Mem
+#include <r_exec/reduction_job.h>   // for _ReductionJob
+#include <r_exec/reduction_pipe.h>  // for ReductionPipe
+#include <typeinfo>                 // for type_info
 
 
 namespace r_exec
 {
 
-void runReductionCore()
+void runReductionCore(uint64_t core)
 {
+    _Mem::Get()->pin_core(true, core);
+    ReductionPipe::Attach(core);
+    JobStats &stats = _Mem::Get()->get_job_stats();
+    stats.attach();
     bool run = true;
 
     while (run) {
@@ -49,9 +57,19 @@ void runReductionCore()
             break;
         }
 
-        run = job->update(Now());
-        delete job;
+        uint64_t now = Now();
+        const std::type_info &type = typeid(*job);
+        stats.record(type, JobStats::WAIT, now > job->ijt ? now - job->ijt : 0);
+        r_code::Reclaimer::Enter();
+        run = job->update(now);
+        stats.record(type, JobStats::RUN, Now() - now);
+        job->decRef();
+        r_code::Reclaimer::Leave();
     }
+
+    stats.detach();
+    ReductionPipe::Attach(-1);
+    _Mem::Get()->release_reduction_core(core);
 }
 
 } // namespace r_exec
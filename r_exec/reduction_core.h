@@ -31,6 +31,8 @@
 #ifndef reduction_core_h
 #define reduction_core_h
 
+#include <stdint.h>  // for uint64_t
+
 namespace r_exec
 {
 // Pop a job and reduce - may create overlays from exisitng ones.
@@ -41,7 +43,7 @@ namespace r_exec
 // - inject new rdx jobs if salient prods.
 // - inject new update jobs if prod=grp.
 // - inject new signaling jobs if prod=|pgm or prod=pgm with no inputs.
-void  runReductionCore();
+void  runReductionCore(uint64_t core); // core: index of the core's deque in the reduction pipe.
 }
 
 
@@ -30,8 +30,12 @@
 
 #include "reduction_job.h"
 
-#include <r_exec/mem.h>            // for _Mem
-#include <r_exec/reduction_job.h>  // for BatchReductionJob, ReductionJob, etc
+#include <r_code/replicode_defs.h>  // for FACT_BEFORE
+#include <r_code/utils.h>           // for Utils
+#include <r_exec/group.h>           // for Group
+#include <r_exec/mem.h>             // for _Mem
+#include <r_exec/opcodes.h>         // for Opcodes
+#include <r_exec/reduction_job.h>   // for BatchReductionJob, ReductionJob, etc
 
 
 namespace r_exec
@@ -41,6 +45,32 @@ _ReductionJob::_ReductionJob(): _Object()
 {
 }
 
+double _ReductionJob::Urgency(Code *object, double sln, uint64_t now, uint64_t horizon)
+{
+    double urgency = sln < 0 ? 0 : (sln > 1 ? 1 : sln);
+    uint16_t opcode = object->code(0).asOpcode();
+
+    if (horizon > 0 && (opcode == Opcodes::Fact || opcode == Opcodes::AntiFact)) {
+        uint64_t before = Utils::GetTimestamp<Code>(object, FACT_BEFORE);
+
+        if (before > now && before - now < horizon) { // the closer the deadline, the more urgent; missed deadlines are not.
+            double closeness = 1 - (double)(before - now) / horizon;
+
+            if (closeness > urgency) {
+                urgency = closeness;
+            }
+        }
+    }
+
+    return urgency;
+}
+
+int64_t _ReductionJob::Node(View *view)
+{
+    Group *host = view ? view->get_host() : nullptr;
+    return host ? host->get_node() : -1;
+}
+
 ////////////////////////////////////////////////////////////
 
 bool ShutdownReductionCore::update(uint64_t now)
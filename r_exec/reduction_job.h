@@ -46,10 +46,33 @@ class REPLICODE_EXPORT _ReductionJob:
 {
 protected:
     _ReductionJob();
+    // max of the sln and of the closeness of the fact's deadline (before), if the object is a fact, within horizon.
+    static double Urgency(r_code::Code *object, double sln, uint64_t now, uint64_t horizon);
+    static int64_t Node(View *view); // home node of the view's host.
 public:
     uint64_t ijt; // time of injection of the job in the pipe.
     virtual bool update(uint64_t now) = 0; // return false to shutdown the reduction core.
     virtual void debug() {}
+    virtual const void *get_affinity() const // jobs with the same affinity may be routed to the same core; nullptr: any core.
+    {
+        return nullptr;
+    }
+    virtual bool is_droppable() const // true for the jobs the pipe may shed under load: reductions, which later inputs redo.
+    {
+        return false;
+    }
+    virtual const void *get_input() const // jobs with the same affinity and input are duplicates; nullptr: none.
+    {
+        return nullptr;
+    }
+    virtual double get_urgency(uint64_t now, uint64_t horizon) // in [0,1]; used by priority scheduling; sln when horizon==0.
+    {
+        return 0;
+    }
+    virtual int64_t get_node() const // NUMA node of the group the job works for (see Group::get_node()); -1: any.
+    {
+        return -1;
+    }
 };
 
 template<class _P> class ReductionJob:
@@ -60,6 +83,26 @@ public:
     P<_P> processor;
     ReductionJob(View *input, _P *processor): _ReductionJob(), input(input), processor(processor) {}
     bool update(uint64_t now);
+    const void *get_affinity() const
+    {
+        return processor;
+    }
+    bool is_droppable() const
+    {
+        return true;
+    }
+    const void *get_input() const
+    {
+        return input->object;
+    }
+    double get_urgency(uint64_t now, uint64_t horizon)
+    {
+        return Urgency(input->object, input->get_sln(), now, horizon);
+    }
+    int64_t get_node() const
+    {
+        return Node(input);
+    }
     void debug()
     {
         processor->debug(input);
@@ -75,6 +118,27 @@ public:
     P<C> controller; // the controller that produced the job.
     BatchReductionJob(_P *processor, T *trigger, C *controller): _ReductionJob(), processor(processor), trigger(trigger), controller(controller) {}
     bool update(uint64_t now);
+    const void *get_affinity() const
+    {
+        return processor;
+    }
+    bool is_droppable() const
+    {
+        return true;
+    }
+    const void *get_input() const
+    {
+        return trigger;
+    }
+    double get_urgency(uint64_t now, uint64_t horizon) // the trigger has no view of its own: the sln of the processing model.
+    {
+        View *view = processor->getView();
+        return Urgency(trigger, view ? view->get_sln() : 0, now, horizon);
+    }
+    int64_t get_node() const
+    {
+        return Node(processor->getView());
+    }
 };
 
 class REPLICODE_EXPORT ShutdownReductionCore:
@@ -82,6 +146,10 @@ class REPLICODE_EXPORT ShutdownReductionCore:
 {
 public:
     bool update(uint64_t now);
+    double get_urgency(uint64_t now, uint64_t horizon) // don't hold the shutdown behind pending work.
+    {
+        return 1;
+    }
 };
 
 class REPLICODE_EXPORT AsyncInjectionJob:
@@ -91,6 +159,14 @@ public:
     P<View> input;
     AsyncInjectionJob(View *input): _ReductionJob(), input(input) {}
     bool update(uint64_t now);
+    double get_urgency(uint64_t now, uint64_t horizon)
+    {
+        return Urgency(input->object, input->get_sln(), now, horizon);
+    }
+    int64_t get_node() const
+    {
+        return Node(input);
+    }
 };
 }
 
@@ -0,0 +1,709 @@
+//	reduction_pipe.cpp
+//
+//	Work-stealing pipe of reduction jobs, shared by the reduction cores.
+
+#include "reduction_pipe.h"
+
+#include <r_exec/cpu_affinity.h>  // for CPUAffinity
+#include <r_exec/reduction_job.h>  // for _ReductionJob
+#include <algorithm>               // for push_heap, pop_heap, make_heap
+#include <set>                     // for set
+#include <unordered_set>           // for unordered_set
+#include <utility>                 // for pair, make_pair
+
+
+namespace r_exec
+{
+
+static thread_local int64_t CoreIndex = -1; // index of the calling reduction core's deque; -1 for other threads.
+static thread_local void *ClaimedShard = nullptr; // shard of the last job popped by the calling core, if any.
+static thread_local ReductionPipe *ActivePipe = nullptr; // the pipe counts the calling core as active.
+
+void ReductionPipe::Shard::unclaim()
+{
+    claimed.store(false, std::memory_order_seq_cst);
+
+    if (jobs.size() > 0) { // idle cores skipped the shard while it was claimed.
+        pipe->m_canPop.notify_one();
+    }
+}
+
+void ReductionPipe::Attach(int64_t core)
+{
+    if (ClaimedShard) {
+        ((Shard *)ClaimedShard)->unclaim();
+        ClaimedShard = nullptr;
+    }
+
+    if (core < 0 && ActivePipe) {
+        ActivePipe->deactivate();
+        ActivePipe = nullptr;
+    }
+
+    CoreIndex = core;
+}
+
+void ReductionPipe::deactivate()
+{
+    if (active_core_count.fetch_sub(1, std::memory_order_seq_cst) == 1 && on_idle && size() == 0) {
+        on_idle();
+    }
+}
+
+ReductionPipe::Queue::Queue(size_t capacity, OverflowPolicy overflow): jobs(capacity), candidate(nullptr), candidate_pos(0), candidate_urgency(0), inputs(nullptr), input_mask(0)
+{
+    if (overflow == MERGE) {
+        size_t size = jobs.capacity();
+        inputs = new std::atomic<uint64_t>[size];
+
+        for (size_t i = 0; i < size; ++i) {
+            inputs[i].store(0, std::memory_order_relaxed);
+        }
+
+        input_mask = size - 1;
+    }
+}
+
+ReductionPipe::Queue::~Queue()
+{
+    if (candidate) {
+        candidate->decRef();
+    }
+
+    delete[] inputs;
+}
+
+ReductionPipe::ReductionPipe(): shared(new Queue(1024, BLOCK)), affine(false), priority(false), node_count(0), aging_window(0), capacity(1024), overflow(BLOCK), heap_rank(0), heap_size(0), dropped_count(0), blocked_count(0), active_core_count(0)
+{
+}
+
+void ReductionPipe::configure(bool affine, bool priority, uint64_t aging_window, size_t capacity, OverflowPolicy overflow, uint64_t node_count)
+{
+    this->affine = affine && !priority;
+    this->priority = priority;
+    this->node_count = node_count;
+    this->aging_window = aging_window;
+    this->capacity = capacity > 0 ? capacity : 1;
+    this->overflow = overflow;
+}
+
+ReductionPipe::~ReductionPipe()
+{
+    release();
+}
+
+static void Release(std::vector<_ReductionJob *> &jobs, std::atomic<uint64_t> &count)
+{
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        jobs[i]->decRef();
+    }
+
+    count += jobs.size();
+}
+
+// Hash of (controller, input), with a non null fingerprint in the high 32 bits; 0 if the job has no such key.
+static uint64_t InputKey(_ReductionJob *job)
+{
+    const void *affinity = job->get_affinity();
+    const void *input = job->get_input();
+
+    if (!affinity || !input) {
+        return 0;
+    }
+
+    uint64_t h = (uint64_t)affinity ^ ((uint64_t)input * 11400714819323198485ull);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return h | (1ull << 32);
+}
+
+void ReductionPipe::enqueue(Queue &queue, _ReductionJob *job)
+{
+    if (!try_enqueue(queue, job) && (overflow == BLOCK || !shed(queue, job))) {
+        ++blocked_count;
+
+        while (!try_enqueue(queue, job)) {
+            uint32_t key = m_canPush.prepare_wait();
+
+            if (try_enqueue(queue, job)) {
+                m_canPush.cancel_wait();
+                break;
+            }
+
+            m_canPush.wait(key);
+        }
+    }
+
+    m_canPop.notify_one();
+}
+
+bool ReductionPipe::try_enqueue(Queue &queue, _ReductionJob *job)
+{
+    size_t pos;
+
+    if (overflow == MERGE) {
+        uint64_t key = job->is_droppable() ? InputKey(job) : 0;
+
+        if (!queue.jobs.try_push(job, pos)) {
+            return false;
+        }
+
+        if (key) {
+            queue.inputs[key & queue.input_mask].store((key & 0xffffffff00000000ull) | (uint32_t)pos, std::memory_order_relaxed);
+        }
+
+        return true;
+    }
+
+    if (overflow != DROP || !job->is_droppable()) {
+        return queue.jobs.try_push(job);
+    }
+
+    double urgency = job->get_urgency(0, 0); // no horizon: the sln only.
+    std::unique_lock<std::mutex> lock(queue.m_candidateMutex, std::try_to_lock);
+
+    if (!lock.owns_lock() || // another producer is updating the candidate: it is approximate anyway.
+            (queue.candidate && urgency >= queue.candidate_urgency && queue.jobs.is_pending(queue.candidate_pos))) {
+        if (lock.owns_lock()) {
+            lock.unlock();
+        }
+
+        return queue.jobs.try_push(job);
+    }
+
+    job->incRef(); // before the push: a core may pop and release the job right away.
+
+    if (!queue.jobs.try_push(job, pos)) {
+        job->decRef(); // the caller holds another one.
+        return false;
+    }
+
+    _ReductionJob *previous = queue.candidate;
+    queue.candidate = job;
+    queue.candidate_pos = pos;
+    queue.candidate_urgency = urgency;
+    lock.unlock();
+
+    if (previous) { // outside the lock: releasing a job may push new ones.
+        previous->decRef();
+    }
+
+    return true;
+}
+
+bool ReductionPipe::shed(std::vector<_ReductionJob *> &jobs, std::vector<_ReductionJob *> &shed_jobs)
+{
+    if (overflow == DROP) {
+        size_t lowest = jobs.size();
+        double lowest_sln = 2;
+
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            if (!jobs[i]->is_droppable()) {
+                continue;
+            }
+
+            double sln = jobs[i]->get_urgency(0, 0); // no horizon: the sln only.
+
+            if (sln < lowest_sln) {
+                lowest = i;
+                lowest_sln = sln;
+            }
+        }
+
+        if (lowest == jobs.size()) {
+            return false;
+        }
+
+        shed_jobs.push_back(jobs[lowest]);
+        jobs.erase(jobs.begin() + lowest);
+        return true;
+    }
+
+    std::set<std::pair<const void *, const void *> > inputs; // MERGE: keep the oldest job per (controller, input).
+    std::vector<_ReductionJob *> kept;
+
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        const void *affinity = jobs[i]->get_affinity();
+        const void *input = jobs[i]->get_input();
+
+        if (affinity && input && !inputs.insert(std::make_pair(affinity, input)).second) {
+            shed_jobs.push_back(jobs[i]);
+        } else {
+            kept.push_back(jobs[i]);
+        }
+    }
+
+    jobs.swap(kept);
+    return !shed_jobs.empty();
+}
+
+bool ReductionPipe::shed(Queue &queue, _ReductionJob *job)
+{
+    if (overflow == MERGE) {
+        uint64_t key = job->is_droppable() ? InputKey(job) : 0;
+
+        if (!key) {
+            return false;
+        }
+
+        uint64_t entry = queue.inputs[key & queue.input_mask].load(std::memory_order_relaxed);
+
+        if ((entry >> 32) != (key >> 32) || !queue.jobs.is_pending((uint32_t)entry)) {
+            return false;
+        }
+
+        job->decRef(); // a pending job will process the same input for the same controller.
+        ++dropped_count;
+        return true;
+    }
+
+    _ReductionJob *candidate = nullptr; // set when the candidate leaves: drop its tracking reference.
+    bool replaced = false;
+    {
+        std::lock_guard<std::mutex> guard(queue.m_candidateMutex);
+
+        if (queue.candidate) {
+            bool pending = queue.jobs.is_pending(queue.candidate_pos);
+
+            if (pending && (!job->is_droppable() || job->get_urgency(0, 0) > queue.candidate_urgency)) {
+                replaced = queue.jobs.try_replace(queue.candidate_pos, queue.candidate, job);
+                pending = false; // replaced or popped meanwhile.
+            }
+
+            if (!pending) {
+                candidate = queue.candidate;
+                queue.candidate = nullptr;
+            }
+        }
+    }
+
+    if (candidate) {
+        if (replaced) { // the reference the queue stored it with.
+            candidate->decRef();
+            ++dropped_count;
+        }
+
+        candidate->decRef();
+    }
+
+    if (replaced) {
+        return true;
+    }
+
+    if (!job->is_droppable()) {
+        return false;
+    }
+
+    job->decRef(); // nothing less urgent is known to be pending.
+    ++dropped_count;
+    return true;
+}
+
+bool ReductionPipe::shed_heap(Entry &e, std::vector<_ReductionJob *> &shed_jobs)
+{
+    std::vector<_ReductionJob *> jobs;
+
+    for (size_t i = 0; i < heap.size(); ++i) {
+        jobs.push_back(heap[i].job);
+    }
+
+    jobs.push_back(e.job);
+
+    if (!shed(jobs, shed_jobs)) {
+        return false;
+    }
+
+    std::unordered_set<_ReductionJob *> removed(shed_jobs.begin(), shed_jobs.end());
+    std::vector<Entry> kept;
+
+    for (size_t i = 0; i < heap.size(); ++i) {
+        if (removed.find(heap[i].job) == removed.end()) {
+            kept.push_back(heap[i]);
+        }
+    }
+
+    heap.swap(kept);
+    std::make_heap(heap.begin(), heap.end());
+
+    if (removed.find(e.job) == removed.end()) {
+        e.rank = heap_rank++;
+        heap.push_back(e);
+        std::push_heap(heap.begin(), heap.end());
+    }
+
+    return true;
+}
+
+void ReductionPipe::push_heap(_ReductionJob *job)
+{
+    Entry e;
+    e.deadline = job->ijt + (uint64_t)((1 - job->get_urgency(job->ijt, aging_window)) * aging_window);
+    e.job = job;
+    std::vector<_ReductionJob *> shed_jobs;
+    std::unique_lock<std::mutex> lock(m_heapMutex);
+
+    if (heap.size() < capacity || overflow == BLOCK || !shed_heap(e, shed_jobs)) {
+        if (heap.size() >= capacity) {
+            ++blocked_count;
+        }
+
+        while (heap.size() >= capacity) {
+            uint32_t key = m_canPush.prepare_wait();
+            lock.unlock();
+
+            if (heap_size.load(std::memory_order_seq_cst) < capacity) {
+                m_canPush.cancel_wait();
+            } else {
+                m_canPush.wait(key);
+            }
+
+            lock.lock();
+        }
+
+        e.rank = heap_rank++;
+        heap.push_back(e);
+        std::push_heap(heap.begin(), heap.end());
+    }
+
+    heap_size.store(heap.size(), std::memory_order_seq_cst);
+    lock.unlock();
+    Release(shed_jobs, dropped_count); // outside the lock: releasing a job may push new ones.
+    m_canPop.notify_one();
+}
+
+bool ReductionPipe::pop_heap(_ReductionJob *&job)
+{
+    if (heap_size.load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(m_heapMutex);
+
+    if (heap.empty()) {
+        return false;
+    }
+
+    std::pop_heap(heap.begin(), heap.end());
+    job = heap.back().job;
+    heap.pop_back();
+    size_t size = heap.size();
+    heap_size.store(size, std::memory_order_seq_cst);
+    lock.unlock();
+
+    if (size > 0) { // wake up another core if there is more to do.
+        m_canPop.notify_one();
+    }
+
+    m_canPush.notify_one();
+    return true;
+}
+
+void ReductionPipe::push(_ReductionJob *job)
+{
+    job->incRef();
+
+    if (priority) {
+        push_heap(job);
+        return;
+    }
+
+    if (!shards.empty()) {
+        const void *affinity = job->get_affinity();
+
+        if (affinity) {
+            uint64_t h = ((uint64_t)affinity >> 4) * 11400714819323198485ull; // Fibonacci hashing: objects are aligned.
+
+            // don't block on a full shard: the caller may hold its claim.
+            if (shards[(h >> 32) % shards.size()]->jobs.try_push(job)) {
+                m_canPop.notify_one();
+                return;
+            }
+        }
+    }
+
+    int64_t core = CoreIndex;
+    int64_t node = node_queues.empty() ? -1 : job->get_node();
+
+    if (node >= (int64_t)node_queues.size()) {
+        node = -1;
+    }
+
+    if (node >= 0 && node != CPUAffinity::GetCurrentNode()) { // to a core of the group's node.
+        enqueue(*node_queues[node], job);
+        return;
+    }
+
+    if (core >= 0 && core < (int64_t)deques.size() && deques[core]->push(job)) {
+        m_canPop.notify_one(); // an idle core may steal it.
+        return;
+    }
+
+    enqueue(node >= 0 ? *node_queues[node] : *shared, job);
+}
+
+_ReductionJob *ReductionPipe::pop()
+{
+    if (ClaimedShard) { // the caller is done with the previous job.
+        ((Shard *)ClaimedShard)->unclaim();
+        ClaimedShard = nullptr;
+    }
+
+    if (ActivePipe != this) {
+        ActivePipe = this;
+        active_core_count.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    int64_t core = CoreIndex;
+    _ReductionJob *job;
+
+    while (true) {
+        if (pop_heap(job)) {
+            return job;
+        }
+
+        if (pop_shard(core, job)) {
+            return job;
+        }
+
+        if (core >= 0 && core < (int64_t)deques.size() && deques[core]->pop(job)) {
+            return job;
+        }
+
+        int64_t node = CPUAffinity::GetCurrentNode();
+
+        if (node >= 0 && node < (int64_t)node_queues.size() && pop_queue(*node_queues[node], job)) {
+            return job;
+        }
+
+        if (pop_queue(*shared, job)) {
+            return job;
+        }
+
+        bool found = false;
+
+        for (size_t i = 1; i <= node_queues.size() && !found; ++i) { // the other nodes, next one first.
+            found = pop_queue(*node_queues[(node + i) % node_queues.size()], job);
+        }
+
+        if (found || steal(core, job)) {
+            return job;
+        }
+
+        uint32_t key = m_canPop.prepare_wait();
+
+        if (pending()) {
+            m_canPop.cancel_wait();
+            continue;
+        }
+
+        deactivate();
+        m_canPop.wait(key);
+        active_core_count.fetch_add(1, std::memory_order_seq_cst);
+    }
+}
+
+bool ReductionPipe::pop_queue(Queue &queue, _ReductionJob *&job)
+{
+    if (!queue.jobs.try_pop(job)) {
+        return false;
+    }
+
+    if (queue.jobs.size() > 0) { // wake up another core if there is more to do.
+        m_canPop.notify_one();
+    }
+
+    m_canPush.notify_one();
+    return true;
+}
+
+bool ReductionPipe::pop_shard(int64_t core, _ReductionJob *&job)
+{
+    size_t count = shards.size();
+
+    for (size_t i = 0; i < count; ++i) { // own shard first.
+        Shard *shard = shards[(core + (int64_t)count + i) % count];
+
+        if (shard->jobs.size() == 0 || shard->claimed.load(std::memory_order_relaxed)) {
+            continue;
+        }
+
+        if (shard->claimed.exchange(true, std::memory_order_acquire)) {
+            continue;
+        }
+
+        if (shard->jobs.try_pop(job)) {
+            ClaimedShard = shard;
+            m_canPush.notify_one();
+            return true;
+        }
+
+        shard->unclaim();
+    }
+
+    return false;
+}
+
+bool ReductionPipe::steal(int64_t core, _ReductionJob *&job)
+{
+    size_t count = deques.size();
+
+    for (size_t i = 1; i <= count; ++i) { // start with the next core, to spread the thieves.
+        size_t victim = (core + i) % count;
+
+        if ((int64_t)victim == core) {
+            continue;
+        }
+
+        if (deques[victim]->steal(job)) {
+            if (deques[victim]->size() > 0) {
+                m_canPop.notify_one();
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ReductionPipe::pending() const
+{
+    if (heap_size.load(std::memory_order_seq_cst) > 0 || shared->jobs.size() > 0) {
+        return true;
+    }
+
+    for (size_t i = 0; i < deques.size(); ++i) {
+        if (deques[i]->size() > 0) {
+            return true;
+        }
+    }
+
+    for (size_t i = 0; i < node_queues.size(); ++i) {
+        if (node_queues[i]->jobs.size() > 0) {
+            return true;
+        }
+    }
+
+    for (size_t i = 0; i < shards.size(); ++i) { // claimed shards are announced by unclaim().
+        if (shards[i]->jobs.size() > 0 && !shards[i]->claimed.load(std::memory_order_seq_cst)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ReductionPipe::release()
+{
+    _ReductionJob *job;
+
+    if (shared) {
+        while (shared->jobs.try_pop(job)) {
+            job->decRef();
+        }
+
+        delete shared;
+        shared = nullptr;
+    }
+
+    for (size_t i = 0; i < deques.size(); ++i) {
+        while (deques[i]->steal(job)) {
+            job->decRef();
+        }
+
+        delete deques[i];
+    }
+
+    deques.clear();
+
+    for (size_t i = 0; i < node_queues.size(); ++i) {
+        while (node_queues[i]->jobs.try_pop(job)) {
+            job->decRef();
+        }
+
+        delete node_queues[i];
+    }
+
+    node_queues.clear();
+
+    for (size_t i = 0; i < shards.size(); ++i) {
+        while (shards[i]->jobs.try_pop(job)) {
+            job->decRef();
+        }
+
+        delete shards[i];
+    }
+
+    shards.clear();
+
+    for (size_t i = 0; i < heap.size(); ++i) {
+        heap[i].job->decRef();
+    }
+
+    heap.clear();
+    heap_size = 0;
+}
+
+void ReductionPipe::reset(uint64_t core_count)
+{
+    release();
+    shared = new Queue(capacity, overflow);
+
+    for (uint64_t i = 0; i < node_count; ++i) {
+        node_queues.push_back(new Queue(capacity, overflow));
+    }
+
+    for (uint64_t i = 0; i < core_count; ++i) {
+        deques.push_back(new WorkStealingDeque<_ReductionJob *>(DequeCapacity));
+
+        if (affine) {
+            shards.push_back(new Shard(this, capacity));
+        }
+    }
+}
+
+size_t ReductionPipe::size() const
+{
+    size_t s = shared->jobs.size() + heap_size.load(std::memory_order_relaxed);
+
+    for (size_t i = 0; i < deques.size(); ++i) {
+        s += deques[i]->size();
+    }
+
+    for (size_t i = 0; i < node_queues.size(); ++i) {
+        s += node_queues[i]->jobs.size();
+    }
+
+    for (size_t i = 0; i < shards.size(); ++i) {
+        s += shards[i]->jobs.size();
+    }
+
+    return s;
+}
+
+bool ReductionPipe::idle() const
+{
+    return active_core_count.load(std::memory_order_seq_cst) == 0 && size() == 0;
+}
+
+void ReductionPipe::set_idle_callback(std::function<void()> on_idle)
+{
+    this->on_idle = on_idle;
+}
+
+void ReductionPipe::get_overflow_stats(uint64_t &dropped, uint64_t &blocked)
+{
+    dropped = dropped_count.exchange(0);
+    blocked = blocked_count.exchange(0);
+}
+
+void ReductionPipe::get_shard_depths(std::vector<size_t> &depths) const
+{
+    depths.clear();
+
+    for (size_t i = 0; i < shards.size(); ++i) {
+        depths.push_back(shards[i]->jobs.size());
+    }
+}
+}
@@ -0,0 +1,167 @@
+//	reduction_pipe.h
+//
+//	Work-stealing pipe of reduction jobs, shared by the reduction cores.
+
+#ifndef reduction_pipe_h
+#define reduction_pipe_h
+
+#include <r_exec/job_queue.h>  // for MPMCQueue, WorkStealingDeque, Parker
+#include <stddef.h>            // for size_t
+#include <stdint.h>            // for uint64_t, int64_t
+#include <atomic>              // for atomic
+#include <functional>          // for function
+#include <mutex>               // for mutex
+#include <vector>              // for vector
+
+#include <replicode_common.h>  // for REPLICODE_EXPORT
+
+namespace r_exec {
+class _ReductionJob;
+}  // namespace r_exec
+
+namespace r_exec
+{
+
+// Each reduction core owns a deque: jobs pushed by a core (e.g. BatchReductionJob from MDLController::reduce_cache)
+// go to its own deque and are popped back LIFO, while their inputs are still in cache.
+// Jobs pushed by other threads (time cores, I/O), and jobs that overflow a full deque, go to a shared bounded queue.
+// A core pops from its deque first, then from the shared queue, then steals the oldest job of another core;
+// only then does it park.
+// Optionally (affine routing), jobs with an affinity (see _ReductionJob::get_affinity()) are hashed onto shards
+// instead: a shard is claimed by one core at a time, from the pop() of one of its jobs to the next pop() by that core,
+// so jobs for one controller run in order and never compete for the controller's reduction mutex. Core i looks at
+// shard i first, then at the other unclaimed shards, before the regular sources. Jobs that find their shard full
+// take the regular path.
+// Alternatively (priority scheduling), all jobs go to a single heap ordered by virtual deadline: the time of injection
+// plus (1-urgency)*aging_window, where the urgency in [0,1] is given by the job (see _ReductionJob::get_urgency()).
+// Urgent jobs overtake the others, but a job is never overtaken by jobs injected more than aging_window after it:
+// nothing starves. Priority scheduling bypasses the deques and the shards.
+// The shared queue, the shards and the heap hold up to capacity jobs each. When one is full, the overflow policy
+// applies: block the producer, drop a reduction of lowest sln (possibly the new one), or merge the pending jobs that
+// have the same input for the same controller (and block if there is none). The queues shed without scanning: see
+// Queue.
+// With NUMA placement (see CPUAffinity), the shared queue is split per node: a job for a group (see
+// _ReductionJob::get_node()) goes to the queue of the group's node, unless it is pushed by a core of that node, which
+// keeps it in its deque. Cores look at the queue of their own node before the shared queue and the other nodes' ones.
+// The pipe holds a reference to each job it stores; pop() transfers that reference to the caller.
+// The pipe also knows when it is idle, i.e. no job is pending and all the cores are parked (see VirtualTime).
+class REPLICODE_EXPORT ReductionPipe
+{
+public:
+    typedef enum {
+        BLOCK = 0,
+        DROP = 1,
+        MERGE = 2
+    } OverflowPolicy;
+private:
+    static const size_t DequeCapacity = 256;
+
+    class Entry
+    {
+    public:
+        uint64_t deadline;
+        uint64_t rank; // order of arrival, for ties.
+        _ReductionJob *job;
+        bool operator <(const Entry &e) const // std heaps put the greatest element first: earliest deadline.
+        {
+            return deadline > e.deadline || (deadline == e.deadline && rank > e.rank);
+        }
+    };
+
+    // A bounded queue, plus what the overflow policy needs to make room in it in constant time.
+    // DROP: the queue tracks the least urgent droppable job pushed since the previous one left; when full, the new job
+    // takes its place if more urgent, or is dropped. Urgencies are taken at push time.
+    // MERGE: the queue remembers, per hash of (controller, input), where the last such job was pushed; when full, the
+    // new job is dropped if that one is still pending. The table is lossy: a miss blocks the producer.
+    class Queue
+    {
+    public:
+        MPMCQueue<_ReductionJob *> jobs;
+        std::mutex m_candidateMutex;
+        _ReductionJob *candidate; // DROP; the queue holds a reference to it, besides the one it stores.
+        size_t candidate_pos;
+        double candidate_urgency;
+        std::atomic<uint64_t> *inputs; // MERGE: key fingerprint (high 32 bits) and push position (low 32 bits).
+        size_t input_mask;
+        Queue(size_t capacity, OverflowPolicy overflow);
+        ~Queue();
+    };
+
+    class Shard
+    {
+    public:
+        MPMCQueue<_ReductionJob *> jobs;
+        std::atomic<bool> claimed;
+        ReductionPipe *pipe;
+        Shard(ReductionPipe *pipe, size_t capacity): jobs(capacity), claimed(false), pipe(pipe) {}
+        void unclaim();
+    };
+
+    Queue *shared;
+    std::vector<Queue *> node_queues; // empty unless NUMA placement is on.
+    std::vector<WorkStealingDeque<_ReductionJob *> *> deques; // one per core.
+    std::vector<Shard *> shards; // empty unless affine routing is on.
+
+    bool affine;
+    bool priority;
+    uint64_t node_count; // 0: NUMA placement off.
+    uint64_t aging_window; // in us.
+    size_t capacity;
+    OverflowPolicy overflow;
+    std::vector<Entry> heap; // used with priority scheduling.
+    uint64_t heap_rank;
+    std::atomic<size_t> heap_size;
+    std::mutex m_heapMutex;
+
+    std::atomic<uint64_t> dropped_count;
+    std::atomic<uint64_t> blocked_count;
+
+    Parker m_canPush;
+    Parker m_canPop;
+
+    std::atomic<uint64_t> active_core_count; // cores not parked.
+    std::function<void()> on_idle;
+
+    void deactivate();
+
+    void enqueue(Queue &queue, _ReductionJob *job); // applies the overflow policy when full.
+    bool try_enqueue(Queue &queue, _ReductionJob *job); // updates what the overflow policy tracks.
+    bool shed(std::vector<_ReductionJob *> &jobs, std::vector<_ReductionJob *> &shed_jobs); // false if none was shed.
+    bool shed(Queue &queue, _ReductionJob *job); // true if the job was queued or dropped.
+    bool shed_heap(Entry &e, std::vector<_ReductionJob *> &shed_jobs); // true if e was queued or shed; m_heapMutex is locked.
+    void push_heap(_ReductionJob *job);
+    bool pop_heap(_ReductionJob *&job);
+    bool pop_shard(int64_t core, _ReductionJob *&job);
+    bool pop_queue(Queue &queue, _ReductionJob *&job);
+    bool steal(int64_t core, _ReductionJob *&job);
+    bool pending() const;
+    void release();
+public:
+    ReductionPipe();
+    ~ReductionPipe();
+
+    // Binds the calling thread to a core's deque; core<0 unbinds it (and gives up its shard).
+    static void Attach(int64_t core);
+
+    // Thread safe; takes a reference to the job.
+    void push(_ReductionJob *job);
+    // Blocks until a job is available.
+    _ReductionJob *pop();
+    // Selects the routing, scheduling and overflow policies; node_count>0 turns NUMA placement on; to be called
+    // before reset().
+    void configure(bool affine, bool priority, uint64_t aging_window, size_t capacity, OverflowPolicy overflow, uint64_t node_count);
+    // Releases all pending jobs and allocates the shared queue and one deque per core (and one shard per core when
+    // affine routing is on, and one queue per node with NUMA placement); not thread safe WRT push()/pop().
+    void reset(uint64_t core_count);
+
+    size_t size() const;
+    bool idle() const;
+    // Called by the last core to park while no job is pending; not thread safe WRT push()/pop().
+    void set_idle_callback(std::function<void()> on_idle);
+    void get_shard_depths(std::vector<size_t> &depths) const; // empty when affine routing is off.
+    void get_overflow_stats(uint64_t &dropped, uint64_t &blocked); // since the last call.
+};
+}
+
+
+#endif
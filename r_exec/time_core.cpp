@@ -30,99 +30,64 @@
 
 #include "time_core.h"
 
+#include <r_code/reclaimer.h> // for Reclaimer
 #include <r_exec/init.h>      // for Now
+#include <r_exec/job_stats.h> // for JobStats
 #include <r_exec/mem.h>       // for _Mem, _Mem::::RUNNING
 #include <r_exec/time_job.h>  // for TimeJob
-#include <stdint.h>           // for int64_t
-#include <chrono>             // for duration, steady_clock, microseconds, etc
-#include <thread>             // for thread, sleep_until
-#include <atomic>
+#include <stdint.h>           // for int64_t, uint64_t
+#include <typeinfo>           // for type_info
 
 namespace r_exec
 {
 
-using namespace std::chrono;
-
-void delegatedCoreWait(TimeJob *job)
-{
-    _Mem::Get()->start_core();
-    bool run = true;
-
-    static std::atomic<int64_t> last_lag;
-
-    static const float smoothing_factor = 0.1;
-
-    do {
-        std::this_thread::sleep_until(steady_clock::time_point(microseconds(job->target_time - last_lag)));
-
-        if (R_UNLIKELY(!job->is_alive())) {
-            break;
-        }
-
-        if (R_UNLIKELY(_Mem::Get()->check_state() != _Mem::RUNNING)) {
-            break;
-        }
-
-        int64_t lag = Now() - job->target_time;
-        run = job->update();
-
-        job->report(lag);
-
-        last_lag = smoothing_factor * lag + (1.0 - smoothing_factor) * last_lag;
-    } while(job->shouldRunAgain() && run);
-
-    delete job;
-    _Mem::Get()->shutdown_core();
-}
-
-void runTimeCore()
+void runTimeCore(uint64_t core)
 {
+    _Mem::Get()->pin_core(false, core);
+    JobStats &stats = _Mem::Get()->get_job_stats();
+    stats.attach();
     bool run = true;
 
     while (run) {
-        TimeJob *job = _Mem::Get()->popTimeJob();
+        TimeJob *job = _Mem::Get()->popTimeJob(); // blocks until the job is due.
 
         if (job == nullptr) {
             break;
         }
 
-        do {
-            if (!job->is_alive()) {
-                break;
-            }
-
-            if (_Mem::Get()->check_state() != _Mem::RUNNING) {
-                break;
-            }
+        r_code::Reclaimer::Enter();
 
-            if (job->target_time == 0) {// means ASAP. Control jobs (shutdown) are caught here.
-                run = job->update();
-                if (run) {
-                    continue;
-                } else {
-                    break;
-                }
-            }
+        if (job->is_cancelled() || !job->is_alive() || _Mem::Get()->check_state() != _Mem::RUNNING) {
+            job->decRef();
+            r_code::Reclaimer::Leave();
+            continue;
+        }
 
-            int64_t waitTime = job->target_time - Now();
+        if (job->target_time == 0) { // means ASAP. Control jobs (shutdown) are caught here.
+            run = job->update();
+        } else {
+            uint64_t now = Now();
+            int64_t lag = now - job->target_time; // the wheel never fires early.
+            run = job->update();
+            const std::type_info &type = typeid(*job);
+            stats.record(type, JobStats::RUN, Now() - now);
 
-            if (waitTime > 0) { // early: spawn a delegate to wait for the due time; delegate will die when done.
-                std::thread *delegatedCoreThread = new std::thread(delegatedCoreWait, job);
-                delegatedCoreThread->detach();
-                _Mem::Get()->register_time_job_latency(waitTime);
-                job = nullptr;
-                break; // get a new job
+            if (lag > 0) {
+                job->report(lag);
             }
 
-            run = job->update();
+            stats.record(type, JobStats::LATENESS, lag > 0 ? lag : 0);
+        }
 
-            if (waitTime < 0) {
-                job->report(-waitTime);
-            }
-        } while(job->shouldRunAgain() && run);
+        if (run && job->shouldRunAgain()) { // the job has moved its target_time: wait for it in the wheel again.
+            _Mem::Get()->pushTimeJob(job);
+        }
 
-        delete job;
+        job->decRef();
+        r_code::Reclaimer::Leave();
     }
+
+    stats.detach();
 }
 
 }
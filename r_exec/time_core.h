@@ -31,9 +31,11 @@
 #ifndef time_core_h
 #define time_core_h
 
+#include <stdint.h>  // for uint64_t
+
 namespace r_exec
 {
-void runTimeCore();
+void runTimeCore(uint64_t core);
 }
 
 
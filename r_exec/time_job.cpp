@@ -37,16 +37,51 @@
 #include <r_exec/pgm_controller.h>  // for AntiPGMController, etc
 #include <r_exec/time_job.h>        // for TimeJob, SaliencyPropagationJob, etc
 #include <r_exec/view.h>            // for View
+#include <typeinfo>                 // for typeid
+#include <unordered_map>            // for unordered_map
+
 #include <common_logger.h>          // for logger
 
 
 namespace r_exec
 {
 
-TimeJob::TimeJob(uint64_t target_time): _Object(), target_time(target_time)
+TimeJobHandle::TimeJobHandle(TimeJob *job): _Object(), job(job)
+{
+}
+
+void TimeJobHandle::cancel()
+{
+    std::lock_guard<std::mutex> guard(m_mutex); // the job cannot be deleted meanwhile.
+
+    if (job) {
+        _Mem::Get()->cancelTimeJob(job);
+    }
+}
+
+////////////////////////////////////////////////////////////
+
+TimeJob::TimeJob(uint64_t target_time): _Object(), next_timer(nullptr), prev_timer(nullptr), timer_slot(nullptr), cancelled(false), target_time(target_time)
 {
 }
 
+TimeJob::~TimeJob()
+{
+    if (handle != nullptr) {
+        std::lock_guard<std::mutex> guard(handle->m_mutex);
+        handle->job = nullptr;
+    }
+}
+
+TimeJobHandle *TimeJob::get_handle()
+{
+    if (!handle) {
+        handle = new TimeJobHandle(this);
+    }
+
+    return handle;
+}
+
 void TimeJob::report(int64_t lag) const
 {
     LOG_DEBUG << "time job late generic: " << lag << "us behind.";
@@ -54,14 +89,122 @@ void TimeJob::report(int64_t lag) const
 
 ////////////////////////////////////////////////////////////
 
-UpdateJob::UpdateJob(Group *g, uint64_t ijt): TimeJob(ijt)
+GroupUpdateBatch::GroupUpdateBatch(): _Object(), wave(0), pending(0), start_time(0)
+{
+}
+
+void GroupUpdateBatch::add(Group *g, uint64_t planned_time)
+{
+    Entry e;
+    e.group = g;
+    e.planned_time = planned_time;
+    entries.push_back(e);
+}
+
+void GroupUpdateBatch::start()
+{
+    start_time = Now();
+    std::unordered_map<Group *, size_t> indices;
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        indices[entries[i].group] = i;
+    }
+
+    std::vector<std::vector<size_t> > viewers(entries.size()); // due groups that view entries[i].
+    std::vector<size_t> viewed_count(entries.size(), 0); // due groups viewed by entries[i] and not updated yet.
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        Group *g = entries[i].group;
+        std::lock_guard<std::mutex> guard(g->mutex);
+        for (size_t v = 0; v < g->view_index.size(ViewIndex::GROUP); ++v) {
+            std::unordered_map<Group *, size_t>::const_iterator j = indices.find((Group *)g->view_index.at(ViewIndex::GROUP, v)->object);
+
+            if (j != indices.end() && j->second != i) {
+                viewers[j->second].push_back(i);
+                ++viewed_count[i];
+            }
+        }
+    }
+
+    std::vector<size_t> current;
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (viewed_count[i] == 0) {
+            current.push_back(i);
+        }
+    }
+
+    size_t sorted = 0;
+
+    while (!current.empty()) {
+        std::vector<size_t> next;
+
+        for (size_t i : current) {
+            for (size_t j : viewers[i]) {
+                if (--viewed_count[j] == 0) {
+                    next.push_back(j);
+                }
+            }
+        }
+
+        sorted += current.size();
+        waves.push_back(current);
+        current.swap(next);
+    }
+
+    if (sorted < entries.size()) { // groups that view each other: no order among them.
+        std::vector<size_t> rest;
+
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if (viewed_count[i] > 0) {
+                rest.push_back(i);
+            }
+        }
+
+        waves.push_back(rest);
+    }
+
+    push_wave();
+}
+
+void GroupUpdateBatch::push_wave()
+{
+    std::vector<size_t> &w = waves[wave];
+    pending = w.size();
+
+    for (size_t i : w) {
+        _Mem::Get()->pushTimeJob(new UpdateJob(entries[i].group, entries[i].planned_time, this));
+    }
+}
+
+void GroupUpdateBatch::done()
+{
+    if (pending.fetch_sub(1) != 1) {
+        return;
+    }
+
+    if (++wave < waves.size()) {
+        push_wave();
+    } else { // the cost of the tick.
+        _Mem::Get()->get_job_stats().record(typeid(*this), JobStats::RUN, Now() - start_time);
+    }
+}
+
+////////////////////////////////////////////////////////////
+
+UpdateJob::UpdateJob(Group *g, uint64_t planned_time, GroupUpdateBatch *batch): TimeJob(0), planned_time(planned_time)
 {
     group = g;
+    this->batch = batch;
 }
 
 bool UpdateJob::update()
 {
-    group->update(target_time);
+    if (!group->is_invalidated()) {
+        group->update(planned_time);
+    }
+
+    batch->done();
     return true;
 }
 
@@ -72,6 +215,19 @@ void UpdateJob::report(int64_t lag) const
 
 ////////////////////////////////////////////////////////////
 
+UpdateTickJob::UpdateTickJob(uint64_t start, uint64_t period): TimeJob(start), period(period)
+{
+}
+
+bool UpdateTickJob::update()
+{
+    _Mem::Get()->update_groups(target_time);
+    target_time += period;
+    return true;
+}
+
+////////////////////////////////////////////////////////////
+
 SignalingJob::SignalingJob(View *v, uint64_t ijt): TimeJob(ijt)
 {
     view = v;
@@ -193,6 +349,19 @@ bool ShutdownTimeCore::update()
 
 ////////////////////////////////////////////////////////////
 
+CoreScalingJob::CoreScalingJob(uint64_t start, uint64_t period): TimeJob(start), period(period)
+{
+}
+
+bool CoreScalingJob::update()
+{
+    _Mem::Get()->scale_reduction_cores();
+    target_time += period;
+    return true;
+}
+
+////////////////////////////////////////////////////////////
+
 PerfSamplingJob::PerfSamplingJob(uint64_t start, uint64_t period): TimeJob(start), period(period)
 {
 }
@@ -32,6 +32,9 @@
 #define time_job_h
 
 #include <stdint.h>             // for uint64_t, int64_t
+#include <atomic>               // for atomic
+#include <mutex>                // for mutex
+#include <vector>               // for vector
 
 #include <replicode_common.h>   // for P, _Object, REPLICODE_EXPORT
 #include <common_logger.h>      // for logging
@@ -47,18 +50,50 @@ class View;
 namespace r_exec
 {
 
+class TimeJob;
+
+// Lets the owner of a time job cancel it (see _Mem::pushTimeJob()) without keeping the job alive.
+// A cancelled job leaves the timer wheel right away and is released by the next time core, instead of holding its
+// data until its deadline.
+class REPLICODE_EXPORT TimeJobHandle:
+    public core::_Object
+{
+    friend class TimeJob;
+private:
+    std::mutex m_mutex;
+    TimeJob *job; // nullptr once the job is deleted.
+public:
+    TimeJobHandle(TimeJob *job);
+    void cancel(); // no effect if the job has run already; if it is running, it is not pushed again.
+};
+
 class REPLICODE_EXPORT TimeJob:
     public core::_Object
 {
+    friend class TimerWheel;
+    friend class TimeJobHandle;
+private:
+    TimeJob *next_timer; // links in the timer wheel's slots.
+    TimeJob *prev_timer;
+    void *timer_slot; // slot of the timer wheel the job is linked in; nullptr if none.
+    std::atomic<bool> cancelled;
+    core::P<TimeJobHandle> handle; // created on demand.
 protected:
     TimeJob(uint64_t target_time);
 public:
+    virtual ~TimeJob();
+
     uint64_t target_time; // absolute deadline; 0 means ASAP.
     virtual bool update() = 0; // next_target: absolute deadline; 0 means no more waiting; return false to shutdown the time core.
     virtual bool is_alive() const
     {
         return true;
     }
+    bool is_cancelled() const
+    {
+        return cancelled.load(std::memory_order_acquire);
+    }
+    TimeJobHandle *get_handle(); // not thread safe: to be called before the job is pushed.
     virtual bool shouldRunAgain() const
     {
         return false;
@@ -66,16 +101,63 @@ public:
     virtual void report(int64_t lag) const;
 };
 
+// Groups due for an update at one tick (see UpdateTickJob).
+// They are updated in waves: a group comes after the groups it views (see the GROUP views of Group::view_index) that are due as well,
+// so that it sees their new state. The groups of a wave are updated in parallel by the time cores (see UpdateJob);
+// the last one to finish starts the next wave.
+class REPLICODE_EXPORT GroupUpdateBatch:
+    public core::_Object
+{
+private:
+    class Entry
+    {
+    public:
+        core::P<Group> group;
+        uint64_t planned_time;
+    };
+
+    std::vector<Entry> entries;
+    std::vector<std::vector<size_t> > waves; // indices in entries.
+    size_t wave;
+    std::atomic<size_t> pending; // updates of the current wave not done yet.
+    uint64_t start_time;
+
+    void push_wave();
+public:
+    GroupUpdateBatch();
+    void add(Group *g, uint64_t planned_time);
+    void start(); // sorts the groups into waves and pushes the first one.
+    void done(); // called by each update job of the current wave.
+};
+
+// Updates one group of a batch, ASAP.
 class REPLICODE_EXPORT UpdateJob:
     public TimeJob
 {
 public:
     core::P<Group> group;
-    UpdateJob(Group *g, uint64_t ijt);
+    uint64_t planned_time;
+    core::P<GroupUpdateBatch> batch;
+    UpdateJob(Group *g, uint64_t planned_time, GroupUpdateBatch *batch);
     bool update();
     void report(int64_t lag) const;
 };
 
+// Every base period, updates the groups that are due (see _Mem::update_groups()): one wake-up per period, whatever
+// the number of groups.
+class REPLICODE_EXPORT UpdateTickJob:
+    public TimeJob
+{
+public:
+    uint64_t period;
+    UpdateTickJob(uint64_t start, uint64_t period);
+    bool update();
+    bool shouldRunAgain() const
+    {
+        return true;
+    }
+};
+
 class REPLICODE_EXPORT SignalingJob:
     public TimeJob
 {
@@ -169,6 +251,19 @@ public:
     }
 };
 
+class REPLICODE_EXPORT CoreScalingJob:
+    public TimeJob
+{
+public:
+    uint64_t period;
+    CoreScalingJob(uint64_t start, uint64_t period);
+    bool update();
+    bool shouldRunAgain() const
+    {
+        return true;
+    }
+};
+
 class REPLICODE_EXPORT PerfSamplingJob:
     public TimeJob
 {
@@ -0,0 +1,417 @@
+//	timer_wheel.cpp
+//
+//	Deadline-ordered store for time jobs, shared by the time cores.
+
+#include "timer_wheel.h"
+
+#include <r_exec/init.h>      // for Now, VirtualTime
+#include <r_exec/time_job.h>  // for TimeJob
+
+#include <replicode_common.h>  // for LowestBit
+
+
+namespace r_exec
+{
+
+static thread_local bool HoldsJob = false; // the calling time core has popped a job and is not done with it.
+
+static inline uint16_t lowest_slot(uint64_t occupancy)
+{
+    return core::LowestBit(occupancy);
+}
+
+////////////////////////////////////////////////////////////////
+
+void TimerWheel::Slot::push_back(TimeJob *job)
+{
+    job->timer_slot = this;
+    job->next_timer = nullptr;
+    job->prev_timer = tail;
+
+    if (tail) {
+        tail->next_timer = job;
+    } else {
+        head = job;
+    }
+
+    tail = job;
+}
+
+void TimerWheel::Slot::unlink(TimeJob *job)
+{
+    if (job->prev_timer) {
+        job->prev_timer->next_timer = job->next_timer;
+    } else {
+        head = job->next_timer;
+    }
+
+    if (job->next_timer) {
+        job->next_timer->prev_timer = job->prev_timer;
+    } else {
+        tail = job->prev_timer;
+    }
+
+    job->next_timer = job->prev_timer = nullptr;
+    job->timer_slot = nullptr;
+}
+
+TimeJob *TimerWheel::Slot::pop_front()
+{
+    TimeJob *job = head;
+
+    if (job) {
+        unlink(job);
+    }
+
+    return job;
+}
+
+////////////////////////////////////////////////////////////////
+
+TimerWheel::TimerWheel(uint64_t resolution): resolution(resolution), cursor(0), job_count(0), inbox(4096), wakeup_time(NoEvent), running(0)
+{
+    for (uint16_t l = 0; l < LevelCount; ++l) {
+        occupancy[l] = 0;
+    }
+}
+
+TimerWheel::~TimerWheel()
+{
+    reset(0);
+}
+
+void TimerWheel::schedule(TimeJob *job, uint64_t now)
+{
+    if (job->target_time == 0 || job->target_time <= now || job->is_cancelled()) {
+        ready.push_back(job);
+    } else {
+        insert(job);
+    }
+}
+
+void TimerWheel::drain_inbox(uint64_t now)
+{
+    TimeJob *job;
+
+    while (inbox.try_pop(job)) {
+        ++job_count;
+        schedule(job, now);
+    }
+}
+
+void TimerWheel::insert(TimeJob *job)
+{
+    uint64_t t = tick(job->target_time);
+
+    if (t < cursor) {
+        t = cursor;
+    }
+
+    for (uint16_t l = 0; l < LevelCount; ++l) { // lowest level whose block holds both t and the cursor.
+        uint16_t shift = (l + 1) * SlotBits;
+
+        if ((t >> shift) == (cursor >> shift)) {
+            uint16_t index = (t >> (l * SlotBits)) & SlotMask;
+            levels[l][index].push_back(job);
+            occupancy[l] |= (uint64_t)1 << index;
+            return;
+        }
+    }
+
+    overflow.push_back(job);
+}
+
+void TimerWheel::expire(uint64_t now)
+{
+    uint16_t index = cursor & SlotMask;
+
+    if (!(occupancy[0] & ((uint64_t)1 << index))) {
+        return;
+    }
+
+    Slot &slot = levels[0][index];
+    TimeJob *job = slot.head;
+
+    while (job) {
+        TimeJob *next = job->next_timer;
+
+        if (job->target_time <= now) {
+            slot.unlink(job);
+            ready.push_back(job);
+        }
+
+        job = next;
+    }
+
+    if (slot.empty()) {
+        occupancy[0] &= ~((uint64_t)1 << index);
+    }
+}
+
+void TimerWheel::cascade()
+{
+    if (!overflow.empty() && (cursor & (((uint64_t)1 << (LevelCount * SlotBits)) - 1)) == 0) {
+        Slot jobs = overflow;
+        overflow = Slot();
+
+        while (TimeJob *job = jobs.pop_front()) {
+            insert(job);
+        }
+    }
+
+    for (uint16_t l = LevelCount - 1; l > 0; --l) {
+        uint16_t shift = l * SlotBits;
+
+        if ((cursor & (((uint64_t)1 << shift) - 1)) != 0) {
+            continue;
+        }
+
+        uint16_t index = (cursor >> shift) & SlotMask;
+
+        if (!(occupancy[l] & ((uint64_t)1 << index))) {
+            continue;
+        }
+
+        Slot jobs = levels[l][index];
+        levels[l][index] = Slot();
+        occupancy[l] &= ~((uint64_t)1 << index);
+
+        while (TimeJob *job = jobs.pop_front()) {
+            insert(job);
+        }
+    }
+}
+
+void TimerWheel::advance(uint64_t now)
+{
+    uint64_t target = tick(now);
+    expire(now);
+
+    while (cursor < target) {
+        uint64_t e = next_event();
+
+        if (e > target) { // nothing stored between the cursor and now.
+            cursor = target;
+        } else {
+            cursor = e;
+        }
+
+        cascade();
+        expire(now);
+    }
+}
+
+uint64_t TimerWheel::next_event() const
+{
+    uint64_t e = NoEvent;
+
+    if (occupancy[0]) {
+        e = (cursor & ~SlotMask) | lowest_slot(occupancy[0]);
+    }
+
+    for (uint16_t l = 1; l < LevelCount; ++l) {
+        if (occupancy[l]) {
+            uint16_t shift = l * SlotBits;
+            uint64_t block = (cursor >> (shift + SlotBits)) << (shift + SlotBits);
+            uint64_t t = block | ((uint64_t)lowest_slot(occupancy[l]) << shift);
+
+            if (t < e) {
+                e = t;
+            }
+        }
+    }
+
+    if (!overflow.empty()) {
+        uint16_t shift = LevelCount * SlotBits;
+        uint64_t t = ((cursor >> shift) + 1) << shift;
+
+        if (t < e) {
+            e = t;
+        }
+    }
+
+    return e;
+}
+
+uint64_t TimerWheel::next_deadline() const
+{
+    if (!ready.empty()) {
+        return 0;
+    }
+
+    uint64_t e = next_event();
+
+    if (e == NoEvent) {
+        return NoEvent;
+    }
+
+    if (occupancy[0] && e == ((cursor & ~SlotMask) | lowest_slot(occupancy[0]))) { // expiration: wake up at the earliest exact deadline.
+        uint64_t deadline = NoEvent;
+
+        for (TimeJob *job = levels[0][e & SlotMask].head; job; job = job->next_timer) {
+            if (job->target_time < deadline) {
+                deadline = job->target_time;
+            }
+        }
+
+        return deadline;
+    }
+
+    return e * resolution; // cascade.
+}
+
+void TimerWheel::push(TimeJob *job)
+{
+    uint64_t deadline = job->target_time; // the job may be fired and released as soon as it is posted.
+    job->incRef();
+
+    if (!inbox.try_push(job)) { // inbox full: insert directly.
+        std::lock_guard<std::mutex> guard(m_mutex);
+        ++job_count;
+        schedule(job, Now());
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (deadline < wakeup_time.load(std::memory_order_relaxed)) { // the idle cores would sleep past the new deadline.
+        m_canPop.notify_one();
+    }
+}
+
+void TimerWheel::cancel(TimeJob *job)
+{
+    job->cancelled.store(true, std::memory_order_release); // if the job is in the inbox, schedule() sees it.
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        Slot *slot = (Slot *)job->timer_slot;
+
+        if (slot == nullptr || slot == &ready) { // in the inbox, running or about to run.
+            return;
+        }
+
+        slot->unlink(job);
+        Slot *first = &levels[0][0];
+
+        if (slot >= first && slot < first + LevelCount * SlotCount && slot->empty()) { // not the overflow list.
+            size_t index = slot - first;
+            occupancy[index / SlotCount] &= ~((uint64_t)1 << (index % SlotCount));
+        }
+
+        ready.push_back(job);
+    }
+    m_canPop.notify_one();
+}
+
+TimeJob *TimerWheel::pop()
+{
+    if (HoldsJob) {
+        HoldsJob = false;
+
+        if (running.fetch_sub(1, std::memory_order_seq_cst) == 1 && reduction_idle) {
+            m_canPop.notify_one();
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true) {
+        uint64_t now = Now();
+        drain_inbox(now);
+        advance(now);
+
+        if (!ready.empty()) {
+            TimeJob *job = ready.pop_front();
+            --job_count;
+            running.fetch_add(1, std::memory_order_seq_cst);
+            HoldsJob = true;
+
+            if (!ready.empty()) {
+                m_canPop.notify_one();
+            }
+
+            return job;
+        }
+
+        uint64_t deadline = next_deadline();
+        wakeup_time.store(deadline, std::memory_order_seq_cst);
+        uint32_t key = m_canPop.prepare_wait();
+
+        if (inbox.size() > 0) {
+            m_canPop.cancel_wait();
+            continue;
+        }
+
+        if (reduction_idle) { // virtual time.
+            if (deadline != NoEvent && running.load(std::memory_order_seq_cst) == 0 && reduction_idle() && VirtualTime::Set(deadline)) { // nothing left to do now.
+                m_canPop.cancel_wait();
+                continue;
+            }
+
+            deadline = NoEvent; // wait for the other cores, or for the end of the run.
+        }
+
+        lock.unlock();
+
+        if (deadline == NoEvent) {
+            m_canPop.wait(key);
+        } else {
+            now = Now();
+            m_canPop.wait_for(key, deadline > now ? deadline - now : 0);
+        }
+
+        lock.lock();
+    }
+}
+
+void TimerWheel::reset(uint64_t now)
+{
+    Slot released;
+    TimeJob *job;
+
+    while (inbox.try_pop(job)) {
+        released.push_back(job);
+    }
+
+    for (uint16_t l = 0; l < LevelCount; ++l) {
+        for (uint16_t i = 0; i < SlotCount; ++i) {
+            while ((job = levels[l][i].pop_front())) {
+                released.push_back(job);
+            }
+        }
+
+        occupancy[l] = 0;
+    }
+
+    while ((job = overflow.pop_front())) {
+        released.push_back(job);
+    }
+
+    while ((job = ready.pop_front())) {
+        released.push_back(job);
+    }
+
+    job_count = 0;
+    running = 0;
+    cursor = tick(now);
+
+    while ((job = released.pop_front())) {
+        job->decRef();
+    }
+}
+
+void TimerWheel::set_virtual_time(std::function<bool()> reduction_idle)
+{
+    this->reduction_idle = reduction_idle;
+}
+
+void TimerWheel::wake()
+{
+    m_canPop.notify_one();
+}
+
+size_t TimerWheel::size()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return job_count + inbox.size();
+}
+}
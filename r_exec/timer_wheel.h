@@ -0,0 +1,113 @@
+//	timer_wheel.h
+//
+//	Deadline-ordered store for time jobs, shared by the time cores.
+
+#ifndef timer_wheel_h
+#define timer_wheel_h
+
+#include <r_exec/job_queue.h>  // for MPMCQueue, Parker
+#include <stddef.h>            // for size_t
+#include <stdint.h>            // for uint64_t, uint16_t
+#include <atomic>              // for atomic
+#include <functional>          // for function
+#include <mutex>               // for mutex, unique_lock
+
+#include <replicode_common.h>  // for REPLICODE_EXPORT
+
+namespace r_exec {
+class TimeJob;
+}  // namespace r_exec
+
+namespace r_exec
+{
+
+// Hierarchical timer wheel (4 levels of 64 slots, plus an overflow list for deadlines beyond 64^4 ticks).
+// Jobs are linked in place (see TimeJob::next_timer/prev_timer): inserting or removing a job does not allocate.
+// A job sits at the lowest level whose block also contains the wheel's cursor; higher levels are cascaded down when
+// the cursor enters their slots. Level 0 slots are scanned for exact deadlines, so jobs fire at their target time,
+// not at the next tick.
+// Producers do not take the wheel's lock: they post jobs in a lock-free inbox and wake a time core only if the new
+// deadline is earlier than the one the cores sleep until. The time cores drain the inbox into the wheel.
+// The wheel holds a reference to each job it stores; pop() transfers that reference to the caller.
+// A cancelled job is moved from its slot to the ready list: the time core that pops it releases it (see TimeJobHandle).
+// In virtual time (see VirtualTime), idle time cores do not sleep until the next deadline: once no time job is running
+// and the reduction pipe is idle, they move the clock to the next deadline. A time core is done with the job it popped
+// when it calls pop() again.
+class REPLICODE_EXPORT TimerWheel
+{
+private:
+    static const uint16_t LevelCount = 4;
+    static const uint16_t SlotBits = 6;
+    static const uint16_t SlotCount = 1 << SlotBits;
+    static const uint64_t SlotMask = SlotCount - 1;
+    static const uint64_t NoEvent = UINT64_MAX;
+
+    class Slot
+    {
+    public:
+        TimeJob *head;
+        TimeJob *tail;
+        Slot(): head(nullptr), tail(nullptr) {}
+        bool empty() const
+        {
+            return head == nullptr;
+        }
+        void push_back(TimeJob *job);
+        void unlink(TimeJob *job);
+        TimeJob *pop_front();
+    };
+
+    const uint64_t resolution; // duration of a tick in us.
+    uint64_t cursor; // current tick; every stored job is due at or after it.
+
+    Slot levels[LevelCount][SlotCount];
+    uint64_t occupancy[LevelCount]; // bit i set: levels[l][i] is not empty.
+    Slot overflow;
+    Slot ready; // jobs due now, in order of expiration.
+    size_t job_count;
+
+    MPMCQueue<TimeJob *> inbox;
+    std::atomic<uint64_t> wakeup_time; // deadline the idle time cores sleep until.
+
+    std::mutex m_mutex; // serializes the time cores.
+    Parker m_canPop;
+
+    std::function<bool()> reduction_idle; // set in virtual time only.
+    std::atomic<uint64_t> running; // jobs popped and not done yet.
+
+    uint64_t tick(uint64_t time) const
+    {
+        return time / resolution;
+    }
+
+    void schedule(TimeJob *job, uint64_t now); // in ready if due, in the wheel otherwise.
+    void drain_inbox(uint64_t now);
+    void insert(TimeJob *job);
+    void expire(uint64_t now); // moves the jobs of the cursor's slot that are due into ready.
+    void cascade(); // called when the cursor enters new slots at higher levels.
+    void advance(uint64_t now);
+    uint64_t next_event() const; // tick of the next expiration or cascade.
+    uint64_t next_deadline() const; // absolute time to wake up at; NoEvent if the wheel is empty.
+public:
+    TimerWheel(uint64_t resolution);
+    ~TimerWheel();
+
+    // Thread safe; takes a reference to the job. ASAP jobs (target_time==0) are ready immediately.
+    void push(TimeJob *job);
+    // Thread safe; the job must not be deleted meanwhile.
+    void cancel(TimeJob *job);
+    // Blocks until a job is due.
+    TimeJob *pop();
+    // Releases all pending jobs and moves the cursor to now; not thread safe WRT push()/pop().
+    void reset(uint64_t now);
+    // Switches to virtual time; reduction_idle tells if no reduction job is pending or running. Not thread safe.
+    void set_virtual_time(std::function<bool()> reduction_idle);
+    // Lets an idle time core check again whether it can move the virtual clock.
+    void wake();
+
+    size_t size();
+};
+}
+
+
+#endif
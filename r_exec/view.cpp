@@ -36,28 +36,30 @@
 #include <r_exec/opcodes.h>  // for Opcodes, Opcodes::PgmView, etc
 #include <r_exec/overlay.h>  // for Controller
 #include <r_exec/view.h>     // for View, NotificationView
+#include <r_exec/view_ctrl_values.h>  // for ViewCtrlValues
 #include <string.h>          // for memcpy
 #include <limits>            // for numeric_limits
 #include <unordered_set>     // for unordered_set
 
 namespace r_exec
 {
-View::View(): r_code::View(), controller(nullptr)
+View::View(): r_code::View(), ctrl(nullptr), ctrl_slot(0), controller(nullptr)
 {
     _code[VIEW_OID].atom = GetOID();
     reset_ctrl_values();
 }
 
-View::View(r_code::SysView *source, r_code::Code *object): r_code::View(source, object), controller(nullptr)
+View::View(r_code::SysView *source, r_code::Code *object): r_code::View(source, object), ctrl(nullptr), ctrl_slot(0), controller(nullptr)
 {
     _code[VIEW_OID].atom = GetOID();
     reset();
 }
 
-View::View(const View *view, bool new_OID): r_code::View(), controller(nullptr)
+View::View(const View *view, bool new_OID): r_code::View(), ctrl(nullptr), ctrl_slot(0), controller(nullptr)
 {
     object = view->object;
     memcpy(_code, view->_code, VIEW_CODE_MAX_SIZE * sizeof(Atom));
+    view->copy_ctrl_values(_code);
     references[0] = view->references[0];
     references[1] = view->references[1];
 
@@ -75,7 +77,7 @@ View::View(SyncMode sync,
            int64_t res,
            Code *destination,
            Code *origin,
-           Code *object): r_code::View(), controller(nullptr)
+           Code *object): r_code::View(), ctrl(nullptr), ctrl_slot(0), controller(nullptr)
 {
     code(VIEW_OPCODE) = Atom::SSet(Opcodes::View, VIEW_ARITY);
     init(sync, ijt, sln, res, destination, origin, object);
@@ -88,7 +90,7 @@ View::View(SyncMode sync,
            Code *destination,
            Code *origin,
            Code *object,
-           double act): r_code::View(), controller(nullptr)
+           double act): r_code::View(), ctrl(nullptr), ctrl_slot(0), controller(nullptr)
 {
     code(VIEW_OPCODE) = Atom::SSet(Opcodes::PgmView, PGM_VIEW_ARITY);
     init(sync, ijt, sln, res, destination, origin, object);
@@ -152,18 +154,59 @@ View::SyncMode View::get_sync()
     return (SyncMode)(uint64_t)code(VIEW_SYNC).asFloat();
 }
 
+void View::set_sync(SyncMode sync)
+{
+    code(VIEW_SYNC) = Atom::Float(sync);
+
+    if (ViewCtrlValues *c = ctrl.load(std::memory_order_acquire)) {
+        size_t i;
+        ViewCtrlValues::Block *block = c->get_block(ctrl_slot, i);
+
+        if (sync == SYNC_HOLD || sync == SYNC_AXIOM) {
+            block->flags[i] |= ViewCtrlValues::SYNC_ON_STATE;
+        } else {
+            block->flags[i] &= ~ViewCtrlValues::SYNC_ON_STATE;
+        }
+    }
+}
+
+void View::set_ijt(uint64_t ijt)
+{
+    r_code::View::set_ijt(ijt);
+
+    if (ViewCtrlValues *c = ctrl.load(std::memory_order_acquire)) {
+        size_t i;
+        c->get_block(ctrl_slot, i)->ijt[i] = ijt;
+    }
+}
+
 float View::get_res()
 {
+    if (ViewCtrlValues *c = ctrl.load(std::memory_order_acquire)) {
+        size_t i;
+        return c->get_block(ctrl_slot, i)->res[i];
+    }
+
     return code(VIEW_RES).asFloat();
 }
 
 float View::get_sln()
 {
+    if (ViewCtrlValues *c = ctrl.load(std::memory_order_acquire)) {
+        size_t i;
+        return c->get_block(ctrl_slot, i)->sln[i];
+    }
+
     return code(VIEW_SLN).asFloat();
 }
 
 float View::get_act()
 {
+    if (ViewCtrlValues *c = ctrl.load(std::memory_order_acquire)) {
+        size_t i;
+        return c->get_block(ctrl_slot, i)->act[i];
+    }
+
     return code(VIEW_ACT).asFloat();
 }
 
@@ -183,46 +226,90 @@ bool View::get_cov()
 
 void View::mod_res(double value)
 {
-    if (code(VIEW_RES) == Atom::PlusInfinity()) {
+    if (get_res() == std::numeric_limits<float>::infinity()) {
         return;
     }
 
-    acc_res += value;
-    ++res_changes;
+    if (ViewCtrlValues *c = ctrl.load(std::memory_order_acquire)) {
+        size_t i;
+        ViewCtrlValues::Block *block = c->get_block(ctrl_slot, i);
+        block->res_acc[i] += value;
+        ++block->res_changes[i];
+    } else {
+        acc_res += value;
+        ++res_changes;
+    }
 }
 
 void View::set_res(double value)
 {
-    if (code(VIEW_RES) == Atom::PlusInfinity()) {
+    float res = get_res();
+
+    if (res == std::numeric_limits<float>::infinity()) {
         return;
     }
 
-    acc_res += value - get_res();
-    ++res_changes;
+    if (ViewCtrlValues *c = ctrl.load(std::memory_order_acquire)) {
+        size_t i;
+        ViewCtrlValues::Block *block = c->get_block(ctrl_slot, i);
+        block->res_acc[i] += value - res;
+        ++block->res_changes[i];
+    } else {
+        acc_res += value - res;
+        ++res_changes;
+    }
 }
 
 void View::mod_sln(double value)
 {
-    acc_sln += value;
-    ++sln_changes;
+    if (ViewCtrlValues *c = ctrl.load(std::memory_order_acquire)) {
+        size_t i;
+        ViewCtrlValues::Block *block = c->get_block(ctrl_slot, i);
+        block->sln_acc[i] += value;
+        ++block->sln_changes[i];
+    } else {
+        acc_sln += value;
+        ++sln_changes;
+    }
 }
 
 void View::set_sln(double value)
 {
-    acc_sln += value - get_sln();
-    ++sln_changes;
+    if (ViewCtrlValues *c = ctrl.load(std::memory_order_acquire)) {
+        size_t i;
+        ViewCtrlValues::Block *block = c->get_block(ctrl_slot, i);
+        block->sln_acc[i] += value - block->sln[i];
+        ++block->sln_changes[i];
+    } else {
+        acc_sln += value - get_sln();
+        ++sln_changes;
+    }
 }
 
 void View::mod_act(double value)
 {
-    acc_act += value;
-    ++act_changes;
+    if (ViewCtrlValues *c = ctrl.load(std::memory_order_acquire)) {
+        size_t i;
+        ViewCtrlValues::Block *block = c->get_block(ctrl_slot, i);
+        block->act_acc[i] += value;
+        ++block->act_changes[i];
+    } else {
+        acc_act += value;
+        ++act_changes;
+    }
 }
 
 void View::set_act(double value)
 {
-    acc_act += value - get_act();
-    ++act_changes;
+    if (ViewCtrlValues *c = ctrl.load(std::memory_order_acquire)) {
+        size_t i;
+        ViewCtrlValues::Block *block = c->get_block(ctrl_slot, i);
+        block->act_acc[i] += value - block->act[i];
+        ++block->act_changes[i];
+    } else {
+        acc_act += value - get_act();
+        ++act_changes;
+    }
 }
 
 void View::mod_vis(double value)
@@ -254,7 +341,32 @@ float View::update_act_delta()
 
 void View::force_res(double value)
 {
-    code(VIEW_RES) = Atom::Float(value);
+    if (ViewCtrlValues *c = ctrl.load(std::memory_order_acquire)) {
+        size_t i;
+        c->get_block(ctrl_slot, i)->res[i] = Atom::Float(value).asFloat(); // as stored in an atom.
+    } else {
+        code(VIEW_RES) = Atom::Float(value);
+    }
+}
+
+void View::store_ctrl_values()
+{
+    copy_ctrl_values(_code);
+}
+
+void View::copy_ctrl_values(Atom *code) const
+{
+    if (ViewCtrlValues *c = ctrl.load(std::memory_order_acquire)) {
+        c->store(ctrl_slot, code);
+    }
+}
+
+void View::object_invalidated()
+{
+    if (ViewCtrlValues *c = ctrl.load(std::memory_order_acquire)) {
+        size_t i;
+        c->get_block(ctrl_slot, i)->invalidated[i].store(1, std::memory_order_relaxed);
+    }
 }
 
 void View::mod(uint16_t member_index, double value)
@@ -354,16 +466,17 @@ double View::MorphChange(double change, double source_thr, double destination_th
     return destination_thr + change;
 }
 
-View::View(View *view, Group *group): r_code::View(), controller(nullptr)
+View::View(View *view, Group *group): r_code::View(), ctrl(nullptr), ctrl_slot(0), controller(nullptr)
 {
     Group *source = view->get_host();
     object = view->object;
     memcpy(_code, view->_code, VIEW_CODE_MAX_SIZE * sizeof(Atom));
+    view->copy_ctrl_values(_code);
     _code[VIEW_OID].atom = GetOID();
     references[0] = group; // host.
     references[1] = source; // origin.
     // morph ctrl values; NB: res is not morphed as it is expressed as a multiple of the upr.
-    code(VIEW_SLN) = Atom::Float(MorphValue(view->code(VIEW_SLN).asFloat(), source->get_sln_thr(), group->get_sln_thr()));
+    code(VIEW_SLN) = Atom::Float(MorphValue(code(VIEW_SLN).asFloat(), source->get_sln_thr(), group->get_sln_thr()));
 
     switch (object->code(0).getDescriptor()) {
     case Atom::GROUP:
@@ -377,7 +490,7 @@ View::View(View *view, Group *group): r_code::View(), controller(nullptr)
     case Atom::INSTANTIATED_ANTI_PROGRAM:
     case Atom::COMPOSITE_STATE:
     case Atom::MODEL:
-        code(VIEW_ACT) = Atom::Float(MorphValue(view->code(VIEW_ACT).asFloat(), source->get_act_thr(), group->get_act_thr()));
+        code(VIEW_ACT) = Atom::Float(MorphValue(code(VIEW_ACT).asFloat(), source->get_act_thr(), group->get_act_thr()));
         break;
     }
 
@@ -400,10 +513,6 @@ void View::reset_ctrl_values()
     acc_vis = 0;
     res_changes = 0;
     acc_res = 0;
-    periods_at_low_sln = 0;
-    periods_at_high_sln = 0;
-    periods_at_low_act = 0;
-    periods_at_high_act = 0;
 }
 
 void View::reset_init_sln()
@@ -420,94 +529,6 @@ void View::reset_init_act()
     }
 }
 
-double View::update_res()
-{
-    double new_res = get_res();
-
-    if (new_res == std::numeric_limits<double>::infinity()) {
-        return new_res;
-    }
-
-    if (res_changes > 0 && acc_res != 0) {
-        new_res = get_res() + (double)acc_res / (double)res_changes;
-    }
-
-    if (--new_res < 0) { // decremented by one on behalf of the group (at upr).
-        new_res = 0;
-    }
-
-    code(VIEW_RES) = r_code::Atom::Float(new_res);
-    acc_res = 0;
-    res_changes = 0;
-    return get_res();
-}
-
-double View::update_sln(double low, double high)
-{
-    if (sln_changes > 0 && acc_sln != 0) {
-        double new_sln = get_sln() + acc_sln / sln_changes;
-
-        if (new_sln < 0) {
-            new_sln = 0;
-        } else if (new_sln > 1) {
-            new_sln = 1;
-        }
-
-        code(VIEW_SLN) = r_code::Atom::Float(new_sln);
-    }
-
-    acc_sln = 0;
-    sln_changes = 0;
-    double sln = get_sln();
-
-    if (sln < low) {
-        ++periods_at_low_sln;
-    } else {
-        periods_at_low_sln = 0;
-
-        if (sln > high) {
-            ++periods_at_high_sln;
-        } else {
-            periods_at_high_sln = 0;
-        }
-    }
-
-    return sln;
-}
-
-double View::update_act(double low, double high)
-{
-    if (act_changes > 0 && acc_act != 0) {
-        double new_act = get_act() + acc_act / act_changes;
-
-        if (new_act < 0) {
-            new_act = 0;
-        } else if (new_act > 1) {
-            new_act = 1;
-        }
-
-        code(VIEW_ACT) = r_code::Atom::Float(new_act);
-    }
-
-    acc_act = 0;
-    act_changes = 0;
-    double act = get_act();
-
-    if (act < low) {
-        ++periods_at_low_act;
-    } else {
-        periods_at_low_act = 0;
-
-        if (act > high) {
-            ++periods_at_high_act;
-        } else {
-            periods_at_high_act = 0;
-        }
-    }
-
-    return act;
-}
-
 double View::update_vis()
 {
     if (vis_changes > 0 && acc_vis != 0) {
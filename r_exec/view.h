@@ -35,6 +35,7 @@
 #include <r_code/object.h>          // for View::SyncMode, View
 #include <r_code/replicode_defs.h>  // for VIEW_CTRL_0, VIEW_CTRL_1
 #include <stdint.h>                 // for uint64_t, int64_t, uint16_t, etc
+#include <atomic>                   // for atomic
 #include <mutex>                    // for mutex
 
 #include <replicode_common.h>       // for P
@@ -49,13 +50,16 @@ namespace r_exec
 {
 
 class Group;
+class ViewCtrlValues;
 
 // OID is hidden at _code[VIEW_OID].
 // Shared resources:
 // none: all mod/set operations are pushed on the group and executed at update time.
+// Once in a group, res, sln and act are held by the group (see ViewCtrlValues), not by the code.
 class REPLICODE_EXPORT View:
     public r_code::View
 {
+    friend class ViewCtrlValues; // takes the accumulated changes on attach, gives them back on detach.
 private:
     static uint64_t LastOID;
     static uint64_t GetOID();
@@ -71,6 +75,11 @@ private:
     float acc_res;
     void reset_ctrl_values();
 
+    // Where res, sln and act are while the view is in a group; nullptr otherwise.
+    std::atomic<ViewCtrlValues *> ctrl;
+    uint32_t ctrl_slot;
+    void copy_ctrl_values(r_code::Atom *code) const; // from the group, if any, to a copy's code.
+
     // Monitoring
     double initial_sln;
     double initial_act;
@@ -93,11 +102,6 @@ public:
     static double MorphValue(double value, double source_thr, double destination_thr);
     static double MorphChange(double change, double source_thr, double destination_thr);
 
-    uint64_t periods_at_low_sln;
-    uint64_t periods_at_high_sln;
-    uint64_t periods_at_low_act;
-    uint64_t periods_at_high_act;
-
     View();
     View(r_code::SysView *source, r_code::Code *object);
     View(View *view, Group *group); // copy the view and assigns it to the group (used for cov); morph ctrl values.
@@ -129,6 +133,8 @@ public:
     Group *get_host();
 
     SyncMode get_sync();
+    void set_sync(SyncMode sync);
+    void set_ijt(uint64_t ijt); // hides r_code::View::set_ijt(): the group keeps a copy.
     float get_res();
     float get_sln();
     float get_act();
@@ -152,16 +158,16 @@ public:
     void mod_vis(double value);
     void set_vis(double value);
 
-    double update_res();
-    double update_sln(double low, double high);
-    double update_act(double low, double high);
-    double update_vis();
+    double update_vis(); // res, sln and act are updated by the group, in batches.
 
     float update_sln_delta();
     float update_act_delta();
 
     void force_res(double value); // unmediated.
 
+    void store_ctrl_values() override; // from the group to the code, for the readers of the code.
+    void object_invalidated() override; // the group deletes the view at its next update.
+
     // Target res, sln, act, vis.
     void mod(uint16_t member_index, double value);
     void set(uint16_t member_index, double value);
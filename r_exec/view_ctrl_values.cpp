@@ -0,0 +1,191 @@
+//	view_ctrl_values.cpp
+//
+//	Ctrl values of the views of a group, in parallel arrays.
+
+#include "view_ctrl_values.h"
+
+#include <r_code/atom.h>            // for Atom, Atom::GROUP, Atom::MARKER, etc
+#include <r_code/replicode_defs.h>  // for VIEW_RES, VIEW_SLN, VIEW_ACT
+#include <r_exec/object.h>          // for LObject
+#include <r_exec/view.h>            // for View
+#include <algorithm>                // for copy
+#include <limits>                   // for numeric_limits
+
+
+using r_code::Atom;
+using r_code::Code;
+
+namespace r_exec
+{
+
+ViewCtrlValues::ViewCtrlValues(): directory(nullptr), directory_size(0), block_count(0), slot_count(0)
+{
+}
+
+ViewCtrlValues::~ViewCtrlValues()
+{
+    Block **blocks = directory.load();
+
+    for (size_t i = 0; i < block_count; ++i) {
+        delete blocks[i];
+    }
+
+    delete[] blocks;
+
+    for (Block **old_directory : old_directories) {
+        delete[] old_directory;
+    }
+}
+
+uint64_t ViewCtrlValues::Footprint(View *view)
+{
+    uint64_t footprint = sizeof(View);
+
+    if (view->object->code(0).getDescriptor() != Atom::GROUP) {
+        footprint += sizeof(LObject) + view->object->code_size() * sizeof(Atom) + view->object->references_size() * sizeof(P<Code>);
+    }
+
+    return footprint;
+}
+
+// Under memory pressure, only plain objects, markers and notifications are let go early: groups and programs are
+// structural, and views held forever are meant to stay.
+static uint32_t GetFlags(View *view, bool has_act)
+{
+    uint32_t flags = has_act ? ViewCtrlValues::HAS_ACT : 0;
+    Atom head = view->object->code(0);
+
+    if (view->isNotification()) {
+        flags |= ViewCtrlValues::NOTIFICATION | ViewCtrlValues::EVICTABLE;
+    } else if (head.getDescriptor() == Atom::OBJECT || head.getDescriptor() == Atom::MARKER) {
+        flags |= ViewCtrlValues::EVICTABLE;
+    }
+
+    if (view->get_res() == std::numeric_limits<float>::infinity()) {
+        flags &= ~ViewCtrlValues::EVICTABLE;
+    }
+
+    switch (view->get_sync()) {
+    case View::SYNC_HOLD:
+    case View::SYNC_AXIOM:
+        flags |= ViewCtrlValues::SYNC_ON_STATE;
+        break;
+
+    default:
+        break;
+    }
+
+    if (head.getDescriptor() == Atom::GROUP) {
+        flags |= ViewCtrlValues::GROUP_VIEW;
+    }
+
+    return flags;
+}
+
+uint32_t ViewCtrlValues::allocate()
+{
+    if (!free_slots.empty()) {
+        uint32_t slot = free_slots.back();
+        free_slots.pop_back();
+        return slot;
+    }
+
+    if (slot_count == block_count * BlockSize) {
+        Block **blocks = directory.load(std::memory_order_relaxed);
+
+        if (block_count == directory_size) { // readers may hold the old directory: keep it.
+            size_t size = directory_size ? directory_size * 2 : 4;
+            Block **grown = new Block *[size];
+            std::copy(blocks, blocks + block_count, grown);
+
+            if (blocks) {
+                old_directories.push_back(blocks);
+            }
+
+            directory_size = size;
+            blocks = grown;
+        }
+
+        blocks[block_count++] = new Block(); // zeroed.
+        directory.store(blocks, std::memory_order_release);
+    }
+
+    return (uint32_t)slot_count++;
+}
+
+void ViewCtrlValues::attach(View *view, bool has_act)
+{
+    uint32_t slot = allocate();
+    size_t i;
+    Block *block = get_block(slot, i);
+    block->views[i] = view;
+    block->ijt[i] = view->get_ijt();
+    block->res[i] = view->code(VIEW_RES).asFloat();
+    block->res_acc[i] = view->acc_res;
+    block->res_changes[i] = view->res_changes;
+    block->sln[i] = view->code(VIEW_SLN).asFloat();
+    block->former_sln[i] = block->sln[i];
+    block->sln_acc[i] = view->acc_sln;
+    block->sln_changes[i] = view->sln_changes;
+    block->act[i] = has_act ? view->code(VIEW_ACT).asFloat() : 0;
+    block->former_act[i] = block->act[i];
+    block->act_acc[i] = view->acc_act;
+    block->act_changes[i] = view->act_changes;
+    block->periods_at_low_sln[i] = 0;
+    block->periods_at_high_sln[i] = 0;
+    block->periods_at_low_act[i] = 0;
+    block->periods_at_high_act[i] = 0;
+    block->footprint[i] = (uint32_t)Footprint(view);
+    block->flags[i] = GetFlags(view, has_act);
+    block->crossings[i] = 0;
+    block->invalidated[i].store(0, std::memory_order_relaxed);
+    view->acc_res = 0;
+    view->res_changes = 0;
+    view->acc_sln = 0;
+    view->sln_changes = 0;
+    view->acc_act = 0;
+    view->act_changes = 0;
+    view->ctrl_slot = slot;
+    view->ctrl.store(this, std::memory_order_release);
+
+    if (view->object->is_invalidated()) { // before the view could be told (see View::object_invalidated()).
+        block->invalidated[i].store(1, std::memory_order_relaxed);
+    }
+}
+
+void ViewCtrlValues::detach(View *view)
+{
+    uint32_t slot = view->ctrl_slot;
+    size_t i;
+    Block *block = get_block(slot, i);
+    store(slot, &view->code(0));
+    view->acc_res = block->res_acc[i];
+    view->res_changes = block->res_changes[i];
+    view->acc_sln = block->sln_acc[i];
+    view->sln_changes = block->sln_changes[i];
+    view->acc_act = block->act_acc[i];
+    view->act_changes = block->act_changes[i];
+    view->ctrl.store(nullptr, std::memory_order_release);
+    block->views[i] = nullptr;
+    released_slots.push_back(slot);
+}
+
+void ViewCtrlValues::store(uint32_t slot, Atom *code) const
+{
+    size_t i;
+    Block *block = get_block(slot, i);
+    float res = block->res[i];
+    code[VIEW_RES] = res == std::numeric_limits<float>::infinity() ? Atom::PlusInfinity() : Atom::Float(res);
+    code[VIEW_SLN] = Atom::Float(block->sln[i]);
+
+    if (block->flags[i] & HAS_ACT) {
+        code[VIEW_ACT] = Atom::Float(block->act[i]);
+    }
+}
+
+void ViewCtrlValues::recycle()
+{
+    free_slots.insert(free_slots.end(), released_slots.begin(), released_slots.end());
+    released_slots.clear();
+}
+}
@@ -0,0 +1,124 @@
+//	view_ctrl_values.h
+//
+//	Ctrl values of the views of a group, in parallel arrays.
+
+#ifndef view_ctrl_values_h
+#define view_ctrl_values_h
+
+#include <stddef.h>            // for size_t
+#include <stdint.h>            // for uint32_t, uint64_t, uint8_t
+#include <atomic>              // for atomic
+#include <vector>              // for vector
+
+#include <replicode_common.h>  // for REPLICODE_EXPORT
+
+namespace r_code {
+class Atom;
+}  // namespace r_code
+namespace r_exec {
+class View;
+}  // namespace r_exec
+
+namespace r_exec
+{
+
+// The res, sln and act of the views of a group, with their accumulated changes and notification counters, in
+// parallel arrays: the group updates them in passes over the arrays (see Group::update()), and a view of the group
+// reads and modifies its own values there (see View::get_sln() etc.). The code of a view holds them only when the
+// view leaves the group, or when it is copied or serialized (see View::store_ctrl_values()).
+// The arrays are split in blocks that never move, so that other threads can read a view while the group injects
+// others. A released slot is reused after the next update (see recycle()), so that a late reader does not get the
+// values of another view.
+// Not thread safe, except for the readers and modifiers of a view: owned by the group's ViewIndex, under the group's
+// mutex.
+class REPLICODE_EXPORT ViewCtrlValues
+{
+public:
+    static const size_t BlockSize = 128;
+
+    typedef enum { // what the update of a view depends on, as of its injection.
+        HAS_ACT = 1, // pgm views.
+        EVICTABLE = 2, // objects, markers and notifications, unless their res is infinite (see Group::evict()).
+        NOTIFICATION = 4,
+        SYNC_ON_STATE = 8, // SYNC_HOLD and SYNC_AXIOM.
+        GROUP_VIEW = 16
+    } Flag;
+
+    typedef enum { // threshold crossings of a view, as of its new ctrl values.
+        UPDATED = 1, // the view is in the update: not injected after the planned update time.
+        LOW_RES = 2,
+        LOW_SLN = 4,
+        HIGH_SLN = 8,
+        WAS_SALIENT = 16,
+        IS_SALIENT = 32,
+        LOW_ACT = 64,
+        HIGH_ACT = 128,
+        WAS_ACTIVE = 256,
+        IS_ACTIVE = 512
+    } Crossing;
+
+    class Block
+    {
+    public:
+        View *views[BlockSize]; // nullptr: free slot.
+        uint64_t ijt[BlockSize]; // as of the injection.
+        float res[BlockSize];
+        float res_acc[BlockSize];
+        float res_changes[BlockSize];
+        float sln[BlockSize];
+        float former_sln[BlockSize]; // before the last update.
+        float sln_acc[BlockSize];
+        float sln_changes[BlockSize];
+        float act[BlockSize];
+        float former_act[BlockSize];
+        float act_acc[BlockSize];
+        float act_changes[BlockSize];
+        uint32_t periods_at_low_sln[BlockSize];
+        uint32_t periods_at_high_sln[BlockSize];
+        uint32_t periods_at_low_act[BlockSize];
+        uint32_t periods_at_high_act[BlockSize];
+        uint32_t footprint[BlockSize]; // approximate bytes held by the view and its object.
+        uint32_t flags[BlockSize];
+        uint32_t crossings[BlockSize]; // as of the last update.
+        std::atomic<uint8_t> invalidated[BlockSize]; // the object was invalidated (see View::object_invalidated()).
+    };
+private:
+    std::atomic<Block **> directory;
+    size_t directory_size;
+    size_t block_count;
+    size_t slot_count; // slots in [0, slot_count) have been allocated at least once.
+    std::vector<Block **> old_directories; // readers may still hold them: freed with the table.
+    std::vector<uint32_t> free_slots;
+    std::vector<uint32_t> released_slots; // free after the next update.
+
+    uint32_t allocate();
+public:
+    ViewCtrlValues();
+    ~ViewCtrlValues();
+
+    // Approximate bytes held by a view and its object; a group object accounts for its own views.
+    static uint64_t Footprint(View *view);
+
+    void attach(View *view, bool has_act); // takes the values from the view's code and accumulators.
+    void detach(View *view); // gives them back.
+    void store(uint32_t slot, r_code::Atom *code) const; // writes res, sln and act (for pgm views) in a view's code.
+    void recycle(); // makes the slots released since the last call reusable.
+
+    size_t get_block_count() const
+    {
+        return block_count;
+    }
+    Block *get_block(size_t index) const
+    {
+        return directory.load(std::memory_order_acquire)[index];
+    }
+    Block *get_block(uint32_t slot, size_t &offset) const
+    {
+        offset = slot % BlockSize;
+        return get_block(slot / BlockSize);
+    }
+};
+}
+
+
+#endif
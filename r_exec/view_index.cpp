@@ -0,0 +1,286 @@
+//	view_index.cpp
+//
+//	Views of a group, indexed by oid and stored by kind.
+
+#include "view_index.h"
+
+#include <r_code/atom.h>       // for Atom, Atom::I_PTR, Atom::R_PTR
+#include <r_code/object.h>     // for Code
+#include <r_exec/opcodes.h>    // for Opcodes, Opcodes::AntiFact, etc
+#include <r_exec/view.h>       // for View
+#include <algorithm>           // for binary_search, find, sort, unique
+
+
+namespace r_exec
+{
+
+static const size_t InitialSlotCount = 16;
+
+ViewIndex::ViewIndex(): count(0)
+{
+    Slot empty;
+    empty.oid = 0;
+    empty.position = 0;
+    empty.kind = Empty;
+    empty.consumer = NO_INPUT;
+    slots.assign(InitialSlotCount, empty);
+}
+
+ViewIndex::~ViewIndex()
+{
+    clear(); // the views may outlive the index: give them their ctrl values back.
+}
+
+ViewIndex::Slot *ViewIndex::find_slot(uint64_t oid)
+{
+    size_t mask = slots.size() - 1;
+
+    for (size_t i = home(oid);; i = (i + 1) & mask) {
+        Slot &slot = slots[i];
+
+        if (slot.kind == Empty || slot.oid == oid) {
+            return &slot;
+        }
+    }
+}
+
+void ViewIndex::grow()
+{
+    std::vector<Slot> old_slots(slots.size() * 2);
+    old_slots.swap(slots);
+
+    for (Slot &slot : slots) {
+        slot.kind = Empty;
+    }
+
+    for (const Slot &old_slot : old_slots) {
+        if (old_slot.kind != Empty) {
+            *find_slot(old_slot.oid) = old_slot;
+        }
+    }
+}
+
+void ViewIndex::erase_slot(size_t index)
+{
+    size_t mask = slots.size() - 1;
+    size_t hole = index;
+
+    for (size_t i = (index + 1) & mask; slots[i].kind != Empty; i = (i + 1) & mask) {
+        // the entry at i can fill the hole if its home is not in (hole, i] (cyclically).
+        size_t h = home(slots[i].oid);
+
+        if (((i - h) & mask) >= ((i - hole) & mask)) {
+            slots[hole] = slots[i];
+            hole = i;
+        }
+    }
+
+    slots[hole].kind = Empty;
+}
+
+void ViewIndex::GetInputHead(r_code::Code *input, Controller::InputHead &head)
+{
+    head.first = input->code(0).asOpcode();
+    head.second = Controller::AnyOpcode;
+
+    if (head.first != Opcodes::Fact && head.first != Opcodes::AntiFact) {
+        return;
+    }
+
+    Atom object = input->code(1);
+
+    switch (object.getDescriptor()) {
+    case Atom::R_PTR:
+        if (object.asIndex() < input->references_size()) {
+            head.second = input->get_reference(object.asIndex())->code(0).asOpcode();
+        }
+
+        break;
+
+    case Atom::I_PTR:
+        head.second = input->code(object.asIndex()).asOpcode();
+        break;
+
+    default:
+        break;
+    }
+}
+
+bool ViewIndex::GetInputHeads(View *view, std::vector<Controller::InputHead> &heads)
+{
+    if (!view->controller) {
+        return false;
+    }
+
+    if (!view->controller->get_input_heads(heads)) {
+        return false;
+    }
+
+    std::sort(heads.begin(), heads.end());
+    heads.erase(std::unique(heads.begin(), heads.end()), heads.end());
+    return true;
+}
+
+void ViewIndex::EraseConsumer(std::vector<View *> &consumers, View *view)
+{
+    std::vector<View *>::iterator v = std::find(consumers.begin(), consumers.end(), view);
+
+    if (v != consumers.end()) {
+        *v = consumers.back();
+        consumers.pop_back();
+    }
+}
+
+uint8_t ViewIndex::add_consumer(View *view)
+{
+    std::vector<Controller::InputHead> heads;
+
+    if (!GetInputHeads(view, heads)) {
+        any_input_consumers.push_back(view);
+        return ANY_INPUT;
+    }
+
+    for (const Controller::InputHead &head : heads) {
+        Consumers &c = consumers[head.first];
+
+        if (head.second == Controller::AnyOpcode) {
+            c.any_object.push_back(view);
+        } else if (!std::binary_search(heads.begin(), heads.end(), Controller::InputHead(head.first, Controller::AnyOpcode))) { // not covered by any_object.
+            c.by_object[head.second].push_back(view);
+        }
+    }
+
+    return INPUT_HEADS;
+}
+
+void ViewIndex::remove_consumer(View *view, uint8_t consumer)
+{
+    switch (consumer) {
+    case ANY_INPUT:
+        EraseConsumer(any_input_consumers, view);
+        return;
+
+    case INPUT_HEADS:
+        break;
+
+    default:
+        return;
+    }
+
+    std::vector<Controller::InputHead> heads;
+    GetInputHeads(view, heads);
+
+    for (const Controller::InputHead &head : heads) {
+        std::unordered_map<uint16_t, Consumers>::iterator c = consumers.find(head.first);
+
+        if (c == consumers.end()) {
+            continue;
+        }
+
+        if (head.second == Controller::AnyOpcode) {
+            EraseConsumer(c->second.any_object, view);
+        } else {
+            std::unordered_map<uint16_t, std::vector<View *> >::iterator o = c->second.by_object.find(head.second);
+
+            if (o != c->second.by_object.end()) {
+                EraseConsumer(o->second, view);
+
+                if (o->second.empty()) {
+                    c->second.by_object.erase(o);
+                }
+            }
+        }
+
+        if (c->second.any_object.empty() && c->second.by_object.empty()) {
+            consumers.erase(c);
+        }
+    }
+}
+
+void ViewIndex::insert(Kind kind, View *view)
+{
+    uint64_t oid = view->get_oid();
+    Slot *slot = find_slot(oid);
+    bool has_inputs = (kind == IPGM || kind == ANTI_IPGM);
+
+    if (slot->kind == kind) {
+        View *replaced = views[kind][slot->position];
+        remove_consumer(replaced, slot->consumer);
+
+        if (replaced != view) {
+            ctrl_values.detach(replaced);
+            ctrl_values.attach(view, kind < GROUP);
+        }
+
+        views[kind][slot->position] = view;
+        slot->consumer = has_inputs ? add_consumer(view) : NO_INPUT;
+        return;
+    }
+
+    if (slot->kind != Empty) { // same oid, other kind.
+        erase(oid);
+    }
+
+    if ((count + 1) * 2 > slots.size()) {
+        grow();
+    }
+
+    slot = find_slot(oid);
+    slot->oid = oid;
+    slot->kind = kind;
+    slot->position = views[kind].size();
+    slot->consumer = has_inputs ? add_consumer(view) : NO_INPUT;
+    ctrl_values.attach(view, kind < GROUP);
+    views[kind].push_back(view);
+    ++count;
+}
+
+View *ViewIndex::find(uint64_t oid) const
+{
+    Slot *slot = const_cast<ViewIndex *>(this)->find_slot(oid);
+    return slot->kind == Empty ? nullptr : (View *)views[slot->kind][slot->position];
+}
+
+bool ViewIndex::erase(uint64_t oid)
+{
+    Slot *slot = find_slot(oid);
+
+    if (slot->kind == Empty) {
+        return false;
+    }
+
+    std::vector<core::P<View> > &kind_views = views[slot->kind];
+    uint32_t position = slot->position;
+    remove_consumer(kind_views[position], slot->consumer);
+    ctrl_values.detach(kind_views[position]);
+
+    if (position + 1 < kind_views.size()) { // move the last view in place of the erased one.
+        kind_views[position] = kind_views.back();
+        find_slot(kind_views[position]->get_oid())->position = position;
+    }
+
+    erase_slot(slot - slots.data());
+    kind_views.pop_back();
+    --count;
+    return true;
+}
+
+void ViewIndex::clear()
+{
+    for (uint8_t kind = 0; kind < KindCount; ++kind) {
+        for (View *v : views[kind]) {
+            ctrl_values.detach(v);
+        }
+
+        views[kind].clear();
+    }
+
+    for (Slot &slot : slots) {
+        slot.kind = Empty;
+    }
+
+    any_input_consumers.clear();
+    consumers.clear();
+    count = 0;
+}
+}
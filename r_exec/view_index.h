@@ -0,0 +1,162 @@
+//	view_index.h
+//
+//	Views of a group, indexed by oid and stored by kind.
+
+#ifndef view_index_h
+#define view_index_h
+
+#include <r_exec/overlay.h>     // for Controller, Controller::InputHead
+#include <r_exec/view_ctrl_values.h>  // for ViewCtrlValues
+#include <stddef.h>            // for size_t
+#include <stdint.h>            // for uint64_t, uint32_t, uint16_t, uint8_t
+#include <unordered_map>       // for unordered_map
+#include <vector>              // for vector
+
+#include <replicode_common.h>  // for P, REPLICODE_EXPORT
+
+namespace r_code {
+class Code;
+}  // namespace r_code
+namespace r_exec {
+class View;
+}  // namespace r_exec
+
+namespace r_exec
+{
+
+// One dense array of views per kind, for iteration, and one open-addressing table (linear probing) from oids to
+// positions in these arrays, for lookups.
+// An oid is held once: inserting a view replaces the view that has the same oid, whatever its kind.
+// Erasing moves the last view of the kind in place of the erased one: to erase while iterating, iterate backwards
+// (see Group's FOR_ALL_VIEWS macros). Views inserted while iterating are appended, hence not visited.
+// The views with inputs are also indexed by the heads of the inputs their controllers may take (see
+// Controller::get_input_heads()), so that an input is offered to these views only (see for_each_consumer()); a view
+// must be inserted once its controller is set.
+// The index also holds the ctrl values of its views (see ViewCtrlValues): a view is attached on insertion, detached
+// on erasure.
+class REPLICODE_EXPORT ViewIndex
+{
+public:
+    typedef enum { // the views with inputs come first, the notifications last (see Group's FOR_ALL_VIEWS macros).
+        IPGM = 0, // ipgm, icpp_pgm, cst, mdl and null pgm: their overlays take inputs.
+        ANTI_IPGM = 1,
+        INPUT_LESS_IPGM = 2,
+        GROUP = 3,
+        OTHER = 4,
+        NOTIFICATION = 5
+    } Kind;
+    static const uint8_t KindCount = 6;
+private:
+    static const uint8_t Empty = 0xFF;
+
+    typedef enum {
+        NO_INPUT = 0,
+        ANY_INPUT = 1,
+        INPUT_HEADS = 2
+    } Consumer;
+
+    class Slot
+    {
+    public:
+        uint64_t oid;
+        uint32_t position; // in views[kind].
+        uint8_t kind; // Empty: free slot.
+        uint8_t consumer; // how the view is registered as a consumer of inputs.
+    };
+
+    class Consumers // of the inputs with a given opcode.
+    {
+    public:
+        std::vector<View *> any_object; // take any input with that opcode.
+        std::unordered_map<uint16_t, std::vector<View *> > by_object; // facts and |facts, by the opcode of their object.
+    };
+
+    std::vector<core::P<View> > views[KindCount];
+    std::vector<Slot> slots; // size is a power of 2, at most half full.
+    size_t count;
+    ViewCtrlValues ctrl_values;
+
+    // Raw pointers: the views are held by views[].
+    std::vector<View *> any_input_consumers;
+    std::unordered_map<uint16_t, Consumers> consumers; // by the opcode of the inputs.
+
+    static void GetInputHead(r_code::Code *input, Controller::InputHead &head);
+    static bool GetInputHeads(View *view, std::vector<Controller::InputHead> &heads); // false: any input.
+    static void EraseConsumer(std::vector<View *> &consumers, View *view);
+
+    uint8_t add_consumer(View *view);
+    void remove_consumer(View *view, uint8_t consumer);
+
+    size_t home(uint64_t oid) const
+    {
+        return (size_t)((oid * 0x9E3779B97F4A7C15ULL) >> 32) & (slots.size() - 1);
+    }
+    Slot *find_slot(uint64_t oid);
+    void grow();
+    void erase_slot(size_t index); // backward shift: no tombstones.
+public:
+    ViewIndex();
+    ~ViewIndex();
+
+    void insert(Kind kind, View *view); // replaces the view with the same oid, if any.
+    View *find(uint64_t oid) const; // nullptr if none.
+    bool erase(uint64_t oid);
+    void clear();
+
+    size_t size() const
+    {
+        return count;
+    }
+    ViewCtrlValues &get_ctrl_values()
+    {
+        return ctrl_values;
+    }
+    size_t size(uint8_t kind) const
+    {
+        return views[kind].size();
+    }
+    View *at(uint8_t kind, size_t position) const
+    {
+        return views[kind][position];
+    }
+
+    // Calls f(View *) for each view with inputs whose controller may take the input.
+    template<class F> void for_each_consumer(r_code::Code *input, F f) const
+    {
+        for (View *v : any_input_consumers) {
+            f(v);
+        }
+
+        Controller::InputHead head;
+        GetInputHead(input, head);
+        std::unordered_map<uint16_t, Consumers>::const_iterator c = consumers.find(head.first);
+
+        if (c == consumers.end()) {
+            return;
+        }
+
+        for (View *v : c->second.any_object) {
+            f(v);
+        }
+
+        if (head.second == Controller::AnyOpcode) { // not a fact, or unknown object.
+            for (const auto &o : c->second.by_object) {
+                for (View *v : o.second) {
+                    f(v);
+                }
+            }
+        } else {
+            std::unordered_map<uint16_t, std::vector<View *> >::const_iterator o = c->second.by_object.find(head.second);
+
+            if (o != c->second.by_object.end()) {
+                for (View *v : o->second) {
+                    f(v);
+                }
+            }
+        }
+    }
+};
+}
+
+
+#endif
@@ -35,6 +35,10 @@
 #include <iostream>
 #include <stdint.h>
 
+#ifdef _MSC_VER
+#include <intrin.h>      // for _BitScanForward64, _BitScanReverse64
+#endif
+
 #if defined(WIN32) || defined(WIN64)
 #define REPLICODE_EXPORT __declspec(dllexport)
 #else
@@ -47,6 +51,30 @@ namespace core
 #define R_LIKELY(x)      __builtin_expect(!!(x), 1)
 #define R_UNLIKELY(x)    __builtin_expect(!!(x), 0)
 
+// Index of the lowest set bit; value must not be 0.
+inline uint32_t LowestBit(uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return index;
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+// Index of the highest set bit; value must not be 0.
+inline uint32_t HighestBit(uint64_t value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return index;
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
+
 // Root smart-pointable object class.
 class _Object
 {
@@ -69,6 +97,8 @@ public:
 // No circular refs (use std c++ ptrs).
 // No passing in functions (cast P<C> into C*).
 // Cannot be a value returned by a function (return C* instead).
+// Moves hand the reference over without touching the ref count: prefer them for temporaries and when growing
+// containers (std::vector moves its elements upon reallocation since the move operations cannot throw).
 template<class C> class P
 {
 private:
@@ -88,6 +118,10 @@ public:
             object->incRef();
         }
     }
+    inline P(P<C> &&p) noexcept : object(p.object)
+    {
+        p.object = nullptr;
+    }
     inline ~P() {
         if (object) {
             object->decRef();
@@ -119,12 +153,12 @@ public:
         return !object;
     }
 
-    template<class D> bool operator ==(P<D> &p) const
+    template<class D> bool operator ==(const P<D> &p) const
     {
         return object == p.object;
     }
 
-    template<class D> bool operator !=(P<D> &p) const
+    template<class D> bool operator !=(const P<D> &p) const
     {
         return object != p.object;
     }
@@ -157,6 +191,21 @@ public:
     {
         return this->operator =((C *)p.object);
     }
+
+    P<C> &operator =(P<C> &&p) noexcept
+    {
+        if (this != &p) {
+            _Object *previous = object;
+            object = p.object;
+            p.object = nullptr;
+
+            if (previous) { // last: releasing it may release p's owner.
+                previous->decRef();
+            }
+        }
+
+        return *this;
+    }
 };
 
 } // namespace core
@@ -0,0 +1,141 @@
+// Compares the lock-free job pipe (r_exec::JobQueue) with the mutex/condition variable pipe it replaced.
+// usage: jobqueuebench [producers] [consumers] [jobs per producer]
+
+#include <r_exec/job_queue.h>  // for JobQueue
+#include <stdint.h>            // for uint64_t
+#include <stdlib.h>            // for atoi
+#include <atomic>              // for atomic
+#include <chrono>              // for steady_clock, duration_cast
+#include <condition_variable>  // for condition_variable
+#include <iostream>            // for cout
+#include <mutex>               // for mutex, unique_lock
+#include <queue>               // for queue
+#include <thread>              // for thread
+#include <vector>              // for vector
+
+// The former _Mem::JobQueue.
+template <class Type> struct LockingJobQueue {
+    void pushJob(Type *job)
+    {
+        std::unique_lock<std::mutex> lock(m_pushMutex);
+        m_mutex.lock();
+
+        while (m_jobs.size() > 1024) {
+            m_mutex.unlock();
+            m_canPushCondition.wait(lock);
+            m_mutex.lock();
+        }
+
+        m_jobs.push(job);
+
+        if (m_jobs.size() == 1) {
+            m_canPopCondition.notify_all();
+        }
+
+        m_mutex.unlock();
+    }
+
+    Type *popJob()
+    {
+        std::unique_lock<std::mutex> lock(m_popMutex);
+        m_mutex.lock();
+
+        while (m_jobs.size() < 1) {
+            m_mutex.unlock();
+            m_canPopCondition.wait(lock);
+            m_mutex.lock();
+        }
+
+        Type *r = m_jobs.front();
+        m_jobs.pop();
+
+        if (m_jobs.size() < 1024) {
+            m_canPushCondition.notify_all();
+        }
+
+        m_mutex.unlock();
+        return r;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::queue<Type*> m_jobs;
+
+    std::mutex m_pushMutex;
+    std::condition_variable m_canPushCondition;
+    std::mutex m_popMutex;
+    std::condition_variable m_canPopCondition;
+};
+
+struct Job {
+    uint64_t payload;
+};
+
+static Job Stop = { 0 };
+
+template<class Q> double run(int producers, int consumers, int jobs_per_producer)
+{
+    Q queue;
+    std::vector<Job> jobs(producers * jobs_per_producer);
+    std::atomic<uint64_t> checksum(0);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int c = 0; c < consumers; ++c) {
+        threads.push_back(std::thread([&]() {
+            uint64_t sum = 0;
+
+            for (Job *job = queue.popJob(); job != &Stop; job = queue.popJob()) {
+                sum += job->payload;
+            }
+
+            checksum += sum;
+        }));
+    }
+
+    std::vector<std::thread> producer_threads;
+
+    for (int p = 0; p < producers; ++p) {
+        producer_threads.push_back(std::thread([&, p]() {
+            for (int i = 0; i < jobs_per_producer; ++i) {
+                Job *job = &jobs[p * jobs_per_producer + i];
+                job->payload = i;
+                queue.pushJob(job);
+            }
+        }));
+    }
+
+    for (std::thread &t : producer_threads) {
+        t.join();
+    }
+
+    for (int c = 0; c < consumers; ++c) {
+        queue.pushJob(&Stop);
+    }
+
+    for (std::thread &t : threads) {
+        t.join();
+    }
+
+    double seconds = std::chrono::duration_cast<std::chrono::duration<double> >(std::chrono::steady_clock::now() - start).count();
+    uint64_t expected = (uint64_t)producers * jobs_per_producer * (jobs_per_producer - 1) / 2;
+
+    if (checksum != expected) {
+        std::cout << "checksum mismatch: " << checksum << " != " << expected << std::endl;
+    }
+
+    return (producers * jobs_per_producer) / seconds;
+}
+
+int main(int argc, char **argv)
+{
+    int producers = argc > 1 ? atoi(argv[1]) : 4;
+    int consumers = argc > 2 ? atoi(argv[2]) : 6;
+    int jobs_per_producer = argc > 3 ? atoi(argv[3]) : 250000;
+    std::cout << producers << " producers, " << consumers << " consumers, " << jobs_per_producer << " jobs per producer" << std::endl;
+    double locking = run<LockingJobQueue<Job> >(producers, consumers, jobs_per_producer);
+    std::cout << "mutex queue:     " << (uint64_t)locking << " jobs/s" << std::endl;
+    double lock_free = run<r_exec::JobQueue<Job> >(producers, consumers, jobs_per_producer);
+    std::cout << "lock-free queue: " << (uint64_t)lock_free << " jobs/s (x" << lock_free / locking << ")" << std::endl;
+    return 0;
+}
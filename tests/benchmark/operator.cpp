@@ -0,0 +1,167 @@
+// Evaluates guards as found in the examples (comparisons and arithmetic on numbers and timestamps) through the std
+// operators evaluated on the context itself (Operator::evaluate()), and through the Context wrapping they replaced.
+// usage: operatorbench [evaluations per guard]
+
+#include <stdint.h>               // for uint64_t, uint16_t
+#include <stdlib.h>               // for atoi, malloc, free
+#include <algorithm>              // for copy
+#include <atomic>                 // for atomic
+#include <chrono>                 // for steady_clock, duration_cast
+#include <iostream>               // for cout
+#include <new>                    // for bad_alloc
+#include <vector>                 // for vector
+
+#include <r_code/atom.h>          // for Atom
+#include <r_code/utils.h>         // for Utils
+#include <r_exec/context.h>       // for IPGMContext
+#include <r_exec/operator.h>      // for Operator, Context, gtr, add, etc
+#include <r_exec/pgm_overlay.h>   // for InputLessPGMOverlay
+
+using r_code::Atom;
+using r_exec::Context;
+using r_exec::IPGMContext;
+using r_exec::Operator;
+
+static std::atomic<uint64_t> HeapAllocations(0);
+
+void *operator new(size_t size)
+{
+    ++HeapAllocations;
+
+    if (void *block = malloc(size ? size : 1)) {
+        return block;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *block) noexcept
+{
+    free(block);
+}
+
+void operator delete(void *block, size_t) noexcept
+{
+    free(block);
+}
+
+// Opcodes of the std operators in this benchmark (r_exec::Init() gives them others).
+static const uint16_t Gtr = 0;
+static const uint16_t Lsr = 1;
+static const uint16_t Add = 2;
+static const uint16_t Sub = 3;
+static const uint16_t Mul = 4;
+
+// Holds the code of a guard, patched by the evaluation and restored before the next.
+class Guard:
+    public r_exec::InputLessPGMOverlay
+{
+private:
+    std::vector<Atom> original;
+public:
+    Guard(const std::vector<Atom> &code): InputLessPGMOverlay(), original(code)
+    {
+        controller = nullptr;
+        code_size = original.size();
+        this->code = new Atom[code_size];
+        reset();
+    }
+
+    void reset()
+    {
+        std::copy(original.begin(), original.end(), code);
+        patch_indices.clear();
+        value_commit_index = 0;
+        values.as_std()->clear();
+    }
+
+    IPGMContext context()
+    {
+        return IPGMContext(nullptr, nullptr, code, 0, this);
+    }
+};
+
+static void timestamp(std::vector<Atom> &code, uint16_t at, uint64_t t)
+{
+    code[at] = Atom::IPointer(code.size());
+    code.resize(code.size() + 3);
+    r_code::Utils::SetTimestamp(&code[code.size() - 3], t);
+}
+
+// The former IPGMContext::evaluate_no_dereference() for operators.
+static bool evaluate_wrapped(const IPGMContext &c, uint16_t &result_index)
+{
+    if (c[0].getDescriptor() != Atom::OPERATOR) {
+        result_index = 0;
+        return true;
+    }
+
+    for (uint16_t i = 1; i <= c.getChildrenCount(); ++i) {
+        uint16_t unused_result_index;
+
+        if (!evaluate_wrapped(*c.getChild(i), unused_result_index)) {
+            return false;
+        }
+    }
+
+    Operator op = Operator::Get(c[0].asOpcode());
+    Context _c(new IPGMContext(c));
+    return op(_c, result_index);
+}
+
+static void run(const char *name, Guard &guard, uint64_t evaluations)
+{
+    uint16_t result_index;
+    bool wrapped_result = false;
+    bool inline_result = false;
+    uint64_t heap = HeapAllocations;
+    auto start = std::chrono::steady_clock::now();
+
+    for (uint64_t i = 0; i < evaluations; ++i) {
+        guard.reset();
+        wrapped_result = evaluate_wrapped(guard.context(), result_index);
+    }
+
+    double wrapped_ms = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0;
+    uint64_t wrapped_heap = HeapAllocations - heap;
+    heap = HeapAllocations;
+    start = std::chrono::steady_clock::now();
+
+    for (uint64_t i = 0; i < evaluations; ++i) {
+        guard.reset();
+        inline_result = guard.context().evaluate_no_dereference(result_index);
+    }
+
+    double inline_ms = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0;
+    uint64_t inline_heap = HeapAllocations - heap;
+    std::cout << name << ": wrapped " << wrapped_ms * 1000000 / evaluations << " ns, " << (double)wrapped_heap / evaluations << " heap allocations; inline " << inline_ms * 1000000 / evaluations << " ns, " << (double)inline_heap / evaluations << " heap allocations" << (wrapped_result == inline_result ? "" : " (results differ)") << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t evaluations = argc > 1 ? atoi(argv[1]) : 1000000;
+    Operator::Register(Gtr, r_exec::gtr);
+    Operator::Register(Lsr, r_exec::lsr);
+    Operator::Register(Add, r_exec::add);
+    Operator::Register(Sub, r_exec::sub);
+    Operator::Register(Mul, r_exec::mul);
+    // (> py 45).
+    std::vector<Atom> gtr_code = { Atom::Operator(Gtr, 2), Atom::Float(50), Atom::Float(45) };
+    // (+ after sampling_period).
+    std::vector<Atom> add_code = { Atom::Operator(Add, 2), Atom::Nil(), Atom::Nil() };
+    timestamp(add_code, 1, 1000000);
+    timestamp(add_code, 2, 100000);
+    // (< (- p1 p0) 10).
+    std::vector<Atom> nested_code = { Atom::Operator(Lsr, 2), Atom::IPointer(3), Atom::Float(10), Atom::Operator(Sub, 2), Atom::Float(12), Atom::Float(4) };
+    // (> (* sy 0.5) (- py 45)).
+    std::vector<Atom> arithmetic_code = { Atom::Operator(Gtr, 2), Atom::IPointer(3), Atom::IPointer(6), Atom::Operator(Mul, 2), Atom::Float(20), Atom::Float(0.5), Atom::Operator(Sub, 2), Atom::Float(50), Atom::Float(45) };
+    Guard gtr_guard(gtr_code);
+    Guard add_guard(add_code);
+    Guard nested_guard(nested_code);
+    Guard arithmetic_guard(arithmetic_code);
+    run("(> py 45)", gtr_guard, evaluations);
+    run("(+ after sampling_period)", add_guard, evaluations);
+    run("(< (- p1 p0) 10)", nested_guard, evaluations);
+    run("(> (* sy 0.5) (- py 45))", arithmetic_guard, evaluations);
+    return 0;
+}
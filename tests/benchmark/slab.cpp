@@ -0,0 +1,141 @@
+// Counts the heap allocations of the objects and views created at every injection, once the slabs are warm.
+// Each input is an object with its fact, the view of the fact in a group, a mk.new on the fact and the view of the
+// mk.new (as the notification views do); a window of inputs is kept alive, the oldest being released as new ones come.
+// The last phase releases the inputs of one thread on another, as the reduction cores do with the inputs of I/O.
+// usage: slabbench [inputs] [window]
+
+#include <stdint.h>            // for uint64_t
+#include <stdlib.h>            // for atoi, malloc, free
+#include <atomic>              // for atomic
+#include <chrono>              // for steady_clock, duration_cast
+#include <iostream>            // for cout
+#include <new>                 // for bad_alloc
+#include <thread>              // for thread
+#include <vector>              // for vector
+
+#include <r_code/atom.h>       // for Atom
+#include <r_code/slab.h>       // for Slab
+#include <r_exec/factory.h>    // for Fact, MkNew
+#include <r_exec/object.h>     // for LObject
+#include <r_exec/opcodes.h>    // for Opcodes
+#include <r_exec/view.h>       // for View
+#include <replicode_common.h>  // for P
+
+static std::atomic<uint64_t> HeapAllocations(0);
+
+void *operator new(size_t size)
+{
+    ++HeapAllocations;
+
+    if (void *block = malloc(size ? size : 1)) {
+        return block;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *block) noexcept
+{
+    free(block);
+}
+
+void operator delete(void *block, size_t) noexcept
+{
+    free(block);
+}
+
+class Input
+{
+public:
+    P<r_exec::View> fact_view;
+    P<r_exec::View> mk_view;
+};
+
+static P<r_code::Code> Group = new r_exec::LObject(); // stands for the group and the entity the objects refer to.
+
+static void inject(Input &input, uint64_t now)
+{
+    r_exec::LObject *object = new r_exec::LObject();
+    object->code(0) = r_code::Atom::Object(r_exec::Opcodes::MkVal, 4);
+    object->code(1) = r_code::Atom::RPointer(0);
+    object->code(2) = r_code::Atom::RPointer(1);
+    object->code(3) = r_code::Atom::Float(now);
+    object->code(4) = r_code::Atom::Float(1);
+    object->add_reference(Group);
+    object->add_reference(Group);
+    r_exec::Fact *fact = new r_exec::Fact(object, now, now + 1, 1, 1);
+    input.fact_view = new r_exec::View(r_code::View::SYNC_ONCE, now, 1, 1, Group, nullptr, fact);
+    fact->views.insert(input.fact_view);
+    r_exec::MkNew *mk = new r_exec::MkNew(nullptr, fact);
+    fact->markers.push_back(mk);
+    input.mk_view = new r_exec::View(r_code::View::SYNC_ONCE, now, 1, 1, Group, nullptr, mk);
+    mk->views.insert(input.mk_view);
+}
+
+static void release(Input &input)
+{
+    input.mk_view->object->invalidate();
+    input.fact_view->object->invalidate();
+    input.mk_view = nullptr;
+    input.fact_view = nullptr;
+}
+
+static void report(const char *name, uint64_t inputs, uint64_t heap, uint64_t system, double ms)
+{
+    std::cout << name << ": " << (double)heap / inputs << " heap allocations per input, " << system << " from the system (" << ms << " ms, " << ms * 1000000 / inputs << " ns per input)" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t inputs = argc > 1 ? atoi(argv[1]) : 1000000;
+    uint64_t window = argc > 2 ? atoi(argv[2]) : 4096;
+    std::vector<Input> ring(window);
+    uint64_t now = 0;
+
+    for (uint64_t i = 0; i < window; ++i) { // warm up: fill the window.
+        inject(ring[i], ++now);
+    }
+
+    // steady state.
+    uint64_t heap = HeapAllocations;
+    uint64_t system = r_code::Slab::GetSystemAllocationCount();
+    auto start = std::chrono::steady_clock::now();
+
+    for (uint64_t i = 0; i < inputs; ++i) {
+        Input &input = ring[i % window];
+        release(input);
+        inject(input, ++now);
+    }
+
+    double ms = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0;
+    report("steady state", inputs, HeapAllocations - heap, r_code::Slab::GetSystemAllocationCount() - system, ms);
+
+    // an I/O thread injects, this thread releases: the blocks go back to the I/O thread.
+    std::vector<Input> batch(window);
+    uint64_t rounds = inputs / window;
+    heap = HeapAllocations;
+    system = r_code::Slab::GetSystemAllocationCount();
+    start = std::chrono::steady_clock::now();
+
+    for (uint64_t r = 0; r < rounds; ++r) {
+        std::thread io([&batch, &now]() {
+            for (Input &input : batch) {
+                inject(input, ++now);
+            }
+        });
+        io.join();
+
+        for (Input &input : batch) {
+            release(input);
+        }
+    }
+
+    ms = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0;
+    report("cross thread", rounds * window, HeapAllocations - heap, r_code::Slab::GetSystemAllocationCount() - system, ms);
+
+    for (Input &input : ring) {
+        release(input);
+    }
+
+    return 0;
+}
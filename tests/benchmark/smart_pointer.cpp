@@ -0,0 +1,149 @@
+// Measures the ref count traffic of core::P: copies (as before P had move operations) vs moves and raw pointers.
+// usage: smartpointerbench [objects] [rounds]
+
+#include <stdint.h>            // for uint64_t
+#include <stdlib.h>            // for atoi
+#include <atomic>              // for atomic
+#include <chrono>              // for steady_clock, duration_cast
+#include <iostream>            // for cout
+#include <utility>             // for move
+#include <vector>              // for vector
+
+#include <replicode_common.h>  // for P, _Object
+
+static std::atomic<uint64_t> Releases(0); // one per decRef(), i.e. one per incRef() once all is released.
+
+class Counted:
+    public core::_Object
+{
+public:
+    uint64_t payload;
+    Counted(uint64_t payload): payload(payload) {}
+    void decRef()
+    {
+        ++Releases;
+        core::_Object::decRef();
+    }
+};
+
+// P as it was: copy operations only.
+class CopyP
+{
+private:
+    core::P<Counted> p;
+public:
+    CopyP() {}
+    CopyP(Counted *c): p(c) {}
+    CopyP(const CopyP &c): p(c.p) {}
+    CopyP &operator =(const CopyP &c)
+    {
+        p = c.p;
+        return *this;
+    }
+    Counted *get() const
+    {
+        return p;
+    }
+};
+
+static uint64_t use_p(core::P<Counted> p) // a retaining parameter: what "no passing in functions" warns about.
+{
+    return p->payload;
+}
+
+static uint64_t use_raw(Counted *p)
+{
+    return p->payload;
+}
+
+template<class F> static void measure(const char *name, int objects, int rounds, F run)
+{
+    Releases = 0;
+    auto start = std::chrono::steady_clock::now();
+    uint64_t checksum = 0;
+
+    for (int r = 0; r < rounds; ++r) {
+        checksum += run();
+    }
+
+    double ms = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count() / 1000.0;
+    uint64_t extra = Releases - (uint64_t)objects * rounds; // beyond the one release that deletes each object.
+    std::cout << name << ": " << ms << " ms, " << (double)extra / rounds << " extra ref count round trips per round (checksum " << checksum << ")" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    int objects = argc > 1 ? atoi(argv[1]) : 100000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 20;
+
+    // growing a vector: reallocations copy or move the elements.
+    measure("vector growth, copy", objects, rounds, [objects]() {
+        std::vector<CopyP> v;
+
+        for (int i = 0; i < objects; ++i) {
+            v.push_back(CopyP(new Counted(i)));
+        }
+
+        return (uint64_t)v.size();
+    });
+    measure("vector growth, move", objects, rounds, [objects]() {
+        std::vector<core::P<Counted> > v;
+
+        for (int i = 0; i < objects; ++i) {
+            v.push_back(core::P<Counted>(new Counted(i)));
+        }
+
+        return (uint64_t)v.size();
+    });
+
+    // handing a temporary over to a container.
+    measure("hand over, copy", objects, rounds, [objects]() {
+        std::vector<core::P<Counted> > v;
+        v.reserve(objects);
+
+        for (int i = 0; i < objects; ++i) {
+            core::P<Counted> p = new Counted(i);
+            v.push_back(p);
+        }
+
+        return (uint64_t)v.size();
+    });
+    measure("hand over, move", objects, rounds, [objects]() {
+        std::vector<core::P<Counted> > v;
+        v.reserve(objects);
+
+        for (int i = 0; i < objects; ++i) {
+            core::P<Counted> p = new Counted(i);
+            v.push_back(std::move(p));
+        }
+
+        return (uint64_t)v.size();
+    });
+
+    // passing down a call chain: P by value vs C* (the objects are held by the vector).
+    std::vector<core::P<Counted> > held;
+
+    for (int i = 0; i < objects; ++i) {
+        held.push_back(core::P<Counted>(new Counted(i)));
+    }
+
+    measure("call, P", 0, rounds, [&held]() {
+        uint64_t sum = 0;
+
+        for (const core::P<Counted> &p : held) {
+            sum += use_p(p);
+        }
+
+        return sum;
+    });
+    measure("call, C*", 0, rounds, [&held]() {
+        uint64_t sum = 0;
+
+        for (const core::P<Counted> &p : held) {
+            sum += use_raw(p);
+        }
+
+        return sum;
+    });
+    return 0;
+}